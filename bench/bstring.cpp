@@ -23,6 +23,7 @@
 #include "../hash_table8.hpp"
 #include "../hash_table7.hpp"
 #include "../hash_table5.hpp"
+#include "../hash_aes.hpp"
 
 #include "emilib/emilib2ss.hpp"
 #include "emilib/emilib2o.hpp"
@@ -52,13 +53,14 @@ static unsigned N = 2'000'000;
 static int K = 10;
 
 static std::vector<std::string> indices1, indices2;
+static std::string s_pad; //longer keys make the hasher dominate growth
 
 static std::string make_index( unsigned x )
 {
     char buffer[ 64 ];
     std::snprintf( buffer, sizeof(buffer), "pfx_%u_sfx", x );
 
-    return buffer;
+    return s_pad + buffer;
 }
 
 static std::string make_random_index( unsigned x )
@@ -66,7 +68,7 @@ static std::string make_random_index( unsigned x )
     char buffer[ 64 ];
     std::snprintf( buffer, sizeof(buffer), "pfx_%0*d_%u_sfx", x % 8 + 1, 0, x );
 
-    return buffer;
+    return s_pad + buffer;
 }
 
 static void init_indices()
@@ -340,6 +342,137 @@ template<class K, class V> using tsl_robin_pg_map =
 
 #endif
 
+// std::string keys looked up by string_view, a transparent hasher and std::equal_to<> skip the temporary key
+
+template<class K> struct view_hash : BstrHasher
+{
+    using is_transparent = void;
+};
+
+template<class K, class V> using emhash_view8 = emhash8::HashMap<K, V, view_hash<std::string_view>, std::equal_to<>>;
+template<class K, class V> using emhash_view7 = emhash7::HashMap<K, V, view_hash<std::string_view>, std::equal_to<>>;
+template<class K, class V> using emhash_view5 = emhash5::HashMap<K, V, view_hash<std::string_view>, std::equal_to<>>;
+
+template<template<class...> class Map, bool transparent> BOOST_NOINLINE void test_view( char const* label )
+{
+    Map<std::string, std::uint32_t> map;
+    for( unsigned i = 1; i <= N; ++i )
+    {
+        map.emplace( indices1[ i ], i );
+    }
+
+    std::vector<std::string_view> views( indices1.begin(), indices1.end() );
+    auto t1 = std::chrono::steady_clock::now();
+    std::uint32_t s = 0;
+
+    for( int j = 0; j < K; ++j )
+    {
+        for( unsigned i = 1; i <= N * 2; ++i )
+        {
+            if constexpr( transparent )
+                s += map.count( views[ i ] );
+            else
+                s += map.count( std::string( views[ i ] ) );
+        }
+    }
+
+    print_time( t1, "string_view lookup", s, map.size() );
+    std::cout << " " << label << "\n";
+}
+
+// aes_hash against wyhash and the default hasher over key lengths, then maps hashing with aes_hasher
+
+template<class K, class V> using emhash_aes8 = emhash8::HashMap<K, V, emhash::aes_hasher, std::equal_to<K>>;
+template<class K, class V> using emhash_aes7 = emhash7::HashMap<K, V, emhash::aes_hasher, std::equal_to<K>>;
+template<class K, class V> using emhash_aes5 = emhash5::HashMap<K, V, emhash::aes_hasher, std::equal_to<K>>;
+
+template<class Hash> BOOST_NOINLINE double hash_ns( std::vector<std::string_view> const& keys, std::size_t& sum )
+{
+    Hash hash;
+    auto t1 = std::chrono::steady_clock::now();
+    for( int j = 0; j < 16; ++j )
+    {
+        for( auto key: keys )
+            sum += hash( key );
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>( t2 - t1 ).count() / ( keys.size() * 16 );
+}
+
+struct aes_fallback_hash
+{
+    std::size_t operator()( std::string_view key ) const { return emhash::aes_detail::wyhash( key.data(), key.size(), 0 ); }
+};
+
+static void test_hash_len()
+{
+    static const char* isa_name[] = { "wyhash fallback", "AES-NI", "VAES" };
+    std::cout << "aes_hash uses " << isa_name[ (int)emhash::aes_cpu() ] << ", ns per hash:\n";
+    std::cout << "\t   len    aes_hash     wyhash  unordered_dense\n";
+
+    std::size_t sum = 0;
+    for( std::size_t len: { 4, 8, 16, 24, 32, 48, 64, 100, 200, 300, 500, 1000 } )
+    {
+        //a few thousand keys at distinct offsets stay in cache and defeat constant folding
+        std::string text( 4096 + len, 'x' );
+        for( std::size_t i = 0; i < text.size(); ++i ) text[ i ] = char( 'a' + i * 7 % 26 );
+
+        std::vector<std::string_view> keys;
+        for( std::size_t i = 0; i < 4096; ++i ) keys.emplace_back( text.data() + i, len );
+
+        std::cout << "\t" << std::setw( 6 ) << len << std::fixed << std::setprecision( 2 )
+            << std::setw( 12 ) << hash_ns<emhash::aes_hasher>( keys, sum )
+            << std::setw( 11 ) << hash_ns<aes_fallback_hash>( keys, sum )
+            << std::setw( 17 ) << hash_ns<ankerl::unordered_dense::hash<std::string_view>>( keys, sum ) << "\n";
+    }
+    std::cout << std::defaultfloat << "\t(" << sum % 10 << ")\n\n";
+}
+
+// emhash7 find miss on long keys sharing a prefix, build with -DEMH_FINGERPRINT=8 or 16 to
+// compare the fingerprint filter with plain key compares
+
+static void test_miss_len()
+{
+#if EMH_FINGERPRINT
+    std::cout << "emhash7 with EMH_FINGERPRINT " << EMH_FINGERPRINT << ", ns per find:\n";
+#else
+    std::cout << "emhash7 without EMH_FINGERPRINT, ns per find:\n";
+#endif
+    std::cout << "\t   len       hit      miss\n";
+
+    const unsigned n = N / 8;
+    std::size_t sum = 0;
+    for( std::size_t len: { 32, 64, 128, 256 } )
+    {
+        //only the last 10 digits differ, so a compare of equal-length keys reads all of them
+        auto make_key = [len]( unsigned x ) {
+            auto digits = std::to_string( 1000000000ull + x * 2654435761ull % 1000000000ull );
+            return std::string( len - digits.size(), '/' ) + digits;
+        };
+
+        std::vector<std::string> keys, misses;
+        for( unsigned i = 0; i < n; ++i ) keys.push_back( make_key( 2 * i ) ), misses.push_back( make_key( 2 * i + 1 ) );
+
+        emhash7::HashMap<std::string, unsigned> map;
+        for( unsigned i = 0; i < n; ++i ) map.emplace( keys[ i ], i );
+
+        double hit = 1e9, miss = 1e9;
+        for( int j = 0; j < K; ++j )
+        {
+            auto t1 = std::chrono::steady_clock::now();
+            for( auto const& key: keys ) sum += map.find( key )->second;
+            auto t2 = std::chrono::steady_clock::now();
+            for( auto const& key: misses ) sum += map.count( key );
+            auto t3 = std::chrono::steady_clock::now();
+            hit  = std::min( hit, std::chrono::duration<double, std::nano>( t2 - t1 ).count() / n );
+            miss = std::min( miss, std::chrono::duration<double, std::nano>( t3 - t2 ).count() / n );
+        }
+        std::cout << "\t" << std::setw( 6 ) << len << std::fixed << std::setprecision( 2 )
+            << std::setw( 10 ) << hit << std::setw( 10 ) << miss << "\n";
+    }
+    std::cout << std::defaultfloat << "\t(" << sum % 10 << ")\n\n";
+}
+
 // fnv1a_hash
 
 template<int Bits> struct fnv1a_hash_impl;
@@ -431,10 +564,14 @@ int main(int argc, const char* argv[])
         N = atoi(argv[1]);
     if (argc > 2 && isdigit(argv[2][0]))
         K = atoi(argv[2]);
+    if (argc > 3 && isdigit(argv[3][0]))
+        s_pad.assign(atoi(argv[3]), '_');
 
+    test_hash_len();
+    test_miss_len();
     init_indices();
 
-    printf("N = %d, Loops = %d\n", N, K);
+    printf("N = %d, Loops = %d, key pad = %d\n", N, K, (int)s_pad.size());
 
     test<emilib1_map> ("emilib1_map" );
     test<emilib3_map> ("emilib3_map" );
@@ -444,6 +581,9 @@ int main(int argc, const char* argv[])
     test<emhash_map5>( "emhash5::hash_map" );
     test<emhash_map7>( "emhash7::hash_map" );
     test<emhash_map8>( "emhash8::hash_map" );
+    test<emhash_aes5>( "emhash5::hash_map, aes_hash" );
+    test<emhash_aes7>( "emhash7::hash_map, aes_hash" );
+    test<emhash_aes8>( "emhash8::hash_map, aes_hash" );
     test<martin_dense>("martin::dense_hash_map" );
     test<martin_flat>("martin::flat_hash_map" );
 
@@ -492,6 +632,13 @@ int main(int argc, const char* argv[])
 
     test<std_unordered_map>( "std::unordered_map" );
 
+    test_view<emhash_map5, false>( "emhash5::hash_map<std::string>, temporary key" );
+    test_view<emhash_view5, true>( "emhash5::hash_map<std::string>, transparent" );
+    test_view<emhash_map7, false>( "emhash7::hash_map<std::string>, temporary key" );
+    test_view<emhash_view7, true>( "emhash7::hash_map<std::string>, transparent" );
+    test_view<emhash_map8, false>( "emhash8::hash_map<std::string>, temporary key" );
+    test_view<emhash_view8, true>( "emhash8::hash_map<std::string>, transparent" );
+
     std::cout << "---\n\n";
 
     for( auto const& x: times )
@@ -6,6 +6,7 @@
 #include "util.h"
 
 #include "tsl/robin_map.h"
+#include "tsl/ordered_map.h"
 #include "martin/robin_hood.h"
 #include "martin/unordered_dense.h"
 #include "phmap/phmap.h"
@@ -13,6 +14,9 @@
 #include "hash_table6.hpp"
 #include "hash_table5.hpp"
 #include "hash_table8.hpp"
+#include "hash_composite.hpp"
+#include "hash_group8.hpp"
+#include "hash_ordered8.hpp"
 #include "emilib/emilib2s.hpp"
 #include "emilib/emilib2o.hpp"
 #include "emilib/emilib2ss.hpp"
@@ -333,6 +337,175 @@ template<class K, class V> using tsl_robin_map= tsl::robin_map<K, V, BintHasher>
 template<class K, class V> using absl_flat_hash_map = absl::flat_hash_map<K, V, BintHasher>;
 #endif
 
+// composite-key joins: build on N rows, probe 2 * N random rows of which half miss
+
+using JoinKey2 = std::pair<uint32_t, uint32_t>;
+using JoinKey3 = std::tuple<uint64_t, uint16_t, uint16_t>;
+
+//row i of a fact table keyed by dense ids, (order, line) and (account, region, day)
+static JoinKey2 join_key2( uint64_t i ) { return { uint32_t( i >> 3 ), uint32_t( i & 7 ) }; }
+static JoinKey3 join_key3( uint64_t i ) { return { i >> 6, uint16_t( ( i >> 3 ) & 7 ), uint16_t( i & 7 ) }; }
+
+//boost::hash_combine over std::hash of each field
+struct combine_hash
+{
+    static void combine( std::size_t& seed, std::size_t h ) { seed ^= h + 0x9e3779b9 + ( seed << 6 ) + ( seed >> 2 ); }
+
+    std::size_t operator()( const JoinKey2& k ) const
+    {
+        std::size_t seed = 0;
+        combine( seed, std::hash<uint32_t>()( k.first ) ); combine( seed, std::hash<uint32_t>()( k.second ) );
+        return seed;
+    }
+    std::size_t operator()( const JoinKey3& k ) const
+    {
+        std::size_t seed = 0;
+        combine( seed, std::hash<uint64_t>()( std::get<0>( k ) ) ); combine( seed, std::hash<uint16_t>()( std::get<1>( k ) ) );
+        combine( seed, std::hash<uint16_t>()( std::get<2>( k ) ) );
+        return seed;
+    }
+};
+
+//a mixer per field, results folded by multiply
+struct fieldmix_hash
+{
+    std::size_t operator()( const JoinKey2& k ) const { return hashfib( k.first ) * 31 + hashfib( k.second ); }
+    std::size_t operator()( const JoinKey3& k ) const
+    {
+        return ( hashfib( std::get<0>( k ) ) * 31 + hashfib( std::get<1>( k ) ) ) * 31 + hashfib( std::get<2>( k ) );
+    }
+};
+
+template<class Map, class Key> void test_join( char const* label, Key (*make_key)( uint64_t ) )
+{
+    std::vector<Key> build, probe;
+    WyRand rng;
+    for( unsigned i = 0; i < N; ++i ) build.push_back( make_key( i ) );
+    for( unsigned i = 0; i < N; ++i ) probe.push_back( make_key( rng() % N ) ), probe.push_back( make_key( N + rng() % N ) );
+
+    auto t1 = std::chrono::steady_clock::now();
+    Map map;
+    for( unsigned i = 0; i < N; ++i ) map.emplace( build[ i ], i );
+    print_time( t1, "build", 0, map.size() );
+
+    uint64_t s = 0;
+    for( int j = 0; j < K; ++j )
+    {
+        for( auto const& key: probe )
+        {
+            auto it = map.find( key );
+            if( it != map.end() ) s += it->second;
+        }
+    }
+    print_time( t1, "probe", s, map.size() );
+    std::cout << " " << label << "\n";
+}
+
+template<class Key> void test_joins( char const* key_name, Key (*make_key)( uint64_t ) )
+{
+    std::cout << key_name << ":\n";
+    test_join<emhash8::HashMap<Key, uint32_t, emhash::hash<Key>>>( "emhash8, emhash::hash", make_key );
+    test_join<emhash8::HashMap<Key, uint32_t, combine_hash>>( "emhash8, hash_combine", make_key );
+    test_join<emhash8::HashMap<Key, uint32_t, fieldmix_hash>>( "emhash8, per-field hashfib", make_key );
+    test_join<emhash7::HashMap<Key, uint32_t, emhash::hash<Key>>>( "emhash7, emhash::hash", make_key );
+    test_join<emhash7::HashMap<Key, uint32_t, combine_hash>>( "emhash7, hash_combine", make_key );
+    test_join<emhash7::HashMap<Key, uint32_t, fieldmix_hash>>( "emhash7, per-field hashfib", make_key );
+    std::cout << "\n";
+}
+
+// find hit and miss at high load factors: each map is filled to lf of its own bucket count,
+// the best of K rounds is reported in ns per find as the timings of one round vary a lot
+
+template<class Map> void test_load( char const* label, unsigned buckets, float lf )
+{
+    Map map( unsigned( buckets * 0.9 ), 0.98f );
+    const unsigned n = unsigned( map.bucket_count() * lf );
+    std::vector<uint64_t> keys( 2 * n );
+    WyRand rng;
+    for( auto& key: keys ) key = rng();
+    for( unsigned i = 0; i < n; ++i ) map.emplace( keys[ i ], i );
+
+    double hit = 1e9, miss = 1e9;
+    uint64_t s = 0;
+    for( int j = 0; j < K; ++j )
+    {
+        auto t1 = std::chrono::steady_clock::now();
+        for( unsigned i = 0; i < n; ++i ) s += map.find( keys[ i ] )->second;
+        auto t2 = std::chrono::steady_clock::now();
+        for( unsigned i = n; i < 2 * n; ++i ) s += map.find( keys[ i ] ) != map.end();
+        auto t3 = std::chrono::steady_clock::now();
+        hit  = std::min( hit, std::chrono::duration<double, std::nano>( t2 - t1 ).count() / n );
+        miss = std::min( miss, std::chrono::duration<double, std::nano>( t3 - t2 ).count() / n );
+    }
+    std::cout << "\tfind hit: " << std::setprecision( 3 ) << hit << " ns\tfind miss: " << miss << " ns (s=" << s % 2 << ") "
+        << label << ", load factor " << map.load_factor() << "\n";
+}
+
+static void test_loads()
+{
+    unsigned buckets = 1;
+    while( buckets < N ) buckets *= 2;
+    std::cout << "find at high load factor, about " << buckets << " buckets:\n";
+    for( float lf: { 0.5f, 0.8f, 0.9f, 0.95f } )
+    {
+        test_load<emhash8::HashMap<uint64_t, uint32_t>>( "emhash8::HashMap", buckets, lf );
+        test_load<emhash8::GroupMap<uint64_t, uint32_t>>( "emhash8::GroupMap", buckets, lf );
+    }
+    std::cout << "\n";
+}
+
+// insertion-ordered maps: insert n keys, erase a random half keeping the order, iterate, then slide
+// a FIFO window over n more keys (insert the newest, erase the oldest). tsl::ordered_map erases by
+// shifting every later value, so it runs on fewer keys and all steps are reported in ns per key
+
+template<class Map> void test_ordered( char const* label, unsigned n )
+{
+    std::vector<uint64_t> keys( 2 * n );
+    std::vector<unsigned> victims( n );
+    WyRand rng;
+    for( auto& key: keys ) key = rng();
+    for( unsigned i = 0; i < n; ++i ) victims[ i ] = i;
+    for( unsigned i = n; i > 1; --i ) std::swap( victims[ i - 1 ], victims[ rng() % i ] );
+
+    auto ns = []( std::chrono::steady_clock::time_point& t1, unsigned ops ) {
+        auto t2 = std::chrono::steady_clock::now();
+        auto r = std::chrono::duration<double, std::nano>( t2 - t1 ).count() / ops;
+        t1 = t2;
+        return r;
+    };
+
+    auto t1 = std::chrono::steady_clock::now();
+    Map map;
+    for( unsigned i = 0; i < n; ++i ) map.emplace( keys[ i ], i );
+    const auto insert = ns( t1, n );
+
+    for( unsigned i = 0; i < n / 2; ++i ) map.erase( keys[ victims[ i ] ] );
+    const auto erase = ns( t1, n / 2 );
+
+    uint64_t s = 0;
+    for( int j = 0; j < K; ++j )
+        for( auto const& kv: map ) s += kv.second;
+    const auto iterate = ns( t1, K * unsigned( map.size() ) );
+
+    for( unsigned i = n; i < 2 * n; ++i )
+    {
+        map.emplace( keys[ i ], i );
+        map.erase( map.begin() );
+    }
+    const auto window = ns( t1, n );
+
+    std::cout << "\tinsert: " << std::setprecision( 3 ) << insert << " ns\terase: " << erase << " ns\titerate: " << iterate
+        << " ns\twindow: " << window << " ns (s=" << s % 2 << ") " << label << ", " << n << " keys\n";
+}
+
+static void test_ordereds()
+{
+    std::cout << "insertion-ordered maps:\n";
+    test_ordered<emhash8::OrderedMap<uint64_t, uint32_t>>( "emhash8::OrderedMap", N );
+    test_ordered<emhash8::OrderedMap<uint64_t, uint32_t>>( "emhash8::OrderedMap", N / 50 );
+    test_ordered<tsl::ordered_map<uint64_t, uint32_t>>( "tsl::ordered_map", N / 50 );
+    std::cout << "\n";
+}
 
 int main(int argc, const char* argv[])
 {
@@ -345,6 +518,11 @@ int main(int argc, const char* argv[])
 
     printf("N = %d, Loops = %d\n", N, K);
 
+    test_joins<JoinKey2>( "join on pair<uint32, uint32>", join_key2 );
+    test_joins<JoinKey3>( "join on tuple<uint64, uint16, uint16>", join_key3 );
+    test_loads();
+    test_ordereds();
+
     test<emhash_map5> ("emhash_map5" );
     test<emhash_map6>("emhash_map6");
     test<boost_unordered_flat_map>( "boost::unordered_flat_map" );
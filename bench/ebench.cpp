@@ -121,6 +121,7 @@ std::map<std::string, std::string> maps =
 #include "../hash_table6.hpp"
 #include "../hash_table7.hpp"
 #include "../hash_table8.hpp"
+#include "../hash_table9.hpp"
 
 //#include "../hash_table8v.hpp"
 //#include "../thirdparty/emhash/hash_table8v.hpp"
@@ -332,6 +333,7 @@ static int loop_vector_time = 0, loop_rand = 0;
 static int func_index = 0, func_size = 10;
 static int func_first = 0, func_last = 0;
 static float hlf = 0.0;
+static float high_loadf = 0.99f; //max load factor of insert_high_load, set by h(90-99.9)
 
 static std::map<std::string, int64_t> func_result;
 //func:hash -> time
@@ -516,7 +518,7 @@ static void iter_all(const hash_type& ht_hash, const std::string& hash_name)
     for (const auto& _ : ht_hash)
         sum += sum;
 
-    for (auto& _ : ht_hash)
+    for (auto&& _ : ht_hash)
         sum += 2;
 
     for (auto it = ht_hash.begin(); it != ht_hash.end(); ++it)
@@ -841,7 +843,7 @@ static void insert_high_load(const std::string& hash_name, const std::vector<key
     size_t pow2 = 2u << ilog(vList.size(), 2);
     hash_type tmp;
 
-    const auto max_loadf = 0.99f;
+    const auto max_loadf = high_loadf;
 #ifndef SMAP
     tmp.max_load_factor(max_loadf);
     tmp.reserve(pow2 / 2);
@@ -888,6 +890,25 @@ static void insert_high_load(const std::string& hash_name, const std::vector<key
     check_func_result(hash_name, __FUNCTION__, sum, ts1);
 }
 
+//a scratch map reserved for the whole data set, filled with a few keys and cleared per query
+template<class hash_type>
+static void clear_reuse(const std::string& hash_name, const std::vector<keyType>& vList)
+{
+    size_t sum = 0;
+    hash_type tmp;
+    tmp.reserve(vList.size());
+
+    const size_t query_size = 1000, query_end = std::min(vList.size(), 500 * query_size);
+    auto ts1 = getus();
+    for (size_t i = 0; i + query_size <= query_end; i += query_size) {
+        for (size_t j = i; j < i + query_size; j++)
+            tmp.emplace(vList[j], TO_VAL(0));
+        sum += tmp.size();
+        tmp.clear();
+    }
+    check_func_result(hash_name, __FUNCTION__, sum, ts1);
+}
+
 template<class hash_type>
 static void insert_erase_high(const std::string& hash_name, size_t vSize)
 {
@@ -1237,6 +1258,7 @@ static void benOneHash(const std::string& hash_name, const std::vector<keyType>&
     if (test_extra) {
         insert_high_load  <hash_type>(hash_name, oList);
         insert_erase_high <hash_type>(hash_name, oList.size());
+        clear_reuse       <hash_type>(hash_name, oList);
     }
     copy_clear        <hash_type>(hash, hash_name);
 
@@ -1462,6 +1484,9 @@ static int benchHashMap(int n)
 
         {  benOneHash<emhash8::HashMap <keyType, valueType, ehash_func>>("emhash8", vList); }
         {  benOneHash<emhash7::HashMap <keyType, valueType, ehash_func>>("emhash7", vList); }
+#if KEY_INT
+        {  benOneHash<emhash9::DenseMap<keyType, valueType, ehash_func>>("emhash9", vList); }
+#endif
         {  benOneHash<emhash6::HashMap <keyType, valueType, ehash_func>>("emhash6", vList); }
 
 #if CXX17
@@ -1483,11 +1508,12 @@ static int benchHashMap(int n)
     constexpr uint64_t kv = sizeof(std::pair<keyType, valueType>);// sizeof(keyType) + sizeof(valueType) + (eq ? 0 : 4);
     auto memory1 = 8 * pow2 + kv * n; //emhash8 table
     auto memory2 = (1 + kv) * pow2;   //flat hash map
+    auto memory3 = (sizeof(keyType) + sizeof(valueType)) * pow2; //emhash9 no link/metadata
     auto memoryr = (8 * 4 + 8 + kv + 8) * n; //std::map
     auto memoryu = 8 * pow2 + (8 + 8 + 8 + kv) * n; //std::unordered_map
 
-    printf("\n %d ======== n = %d, load_factor = %.3lf(emh8/flat = %.2lf/%.2lf, smap/umap = %.2lf/%.2lf MB), data_type = %d ========\n",
-            test_case + 1, n, 1.0 * n / pow2, 1.0 * memory1 / (1 << 20) , 1.0 * memory2 / (1 << 20),
+    printf("\n %d ======== n = %d, load_factor = %.3lf(emh8/flat/emh9 = %.2lf/%.2lf/%.2lf, smap/umap = %.2lf/%.2lf MB), data_type = %d ========\n",
+            test_case + 1, n, 1.0 * n / pow2, 1.0 * memory1 / (1 << 20) , 1.0 * memory2 / (1 << 20), 1.0 * memory3 / (1 << 20),
             1.0 * memoryr / (1 << 20), 1.0 * memoryu / (1 << 20), flag);
 
     printResult();
@@ -1644,7 +1670,7 @@ int main(int argc, char* argv[])
         maxn = (1 << 30) / type_size;
 
     float load_factor = 0.0945f;
-    printf("./ebench maxn = %d c(0-1000) f(0-100) d[2-9 mpatseblku] a(0-3) b t(n %dkB - %dMB)\n",
+    printf("./ebench maxn = %d c(0-1000) f(0-100) d[2-9 mpatseblku] a(0-3) b t h(90-99.9) (n %dkB - %dMB)\n",
             (int)maxn, minn*type_size >> 10, maxn*type_size >> 20);
 
     for (int i = 1; i < argc; i++) {
@@ -1657,6 +1683,8 @@ int main(int argc, char* argv[])
             load_factor = float(atof(&argv[i][0] + 1) / 100.0);
         else if (cmd == 'c' && value > 0)
             maxc = value;
+        else if (cmd == 'h' && value > 0)
+            high_loadf = float(atof(&argv[i][0] + 1) / 100.0);
         else if (cmd == 'a')
             run_type = value;
         else if (cmd == 'r' && value > 0)
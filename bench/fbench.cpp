@@ -32,6 +32,7 @@
 #include "hash_table7.hpp"
 #include "hash_table6.hpp"
 #include "hash_table5.hpp"
+#include "hash_batch.hpp"
 
 static std::random_device rd;
 static std::mt19937_64 rnd(rd());
@@ -456,6 +457,56 @@ int run_udb2(const char* str)
     return 0;
 }
 
+//best of a few rounds, a single pass over the keys is dominated by page faults and timer noise
+template<typename F>
+static double batch_ns(size_t n, F func)
+{
+    int64_t best = INT64_MAX;
+    for (int round = 0; round < 8; round++) {
+        auto t = now2ns();
+        func();
+        t = now2ns() - t;
+        if (t < best)
+            best = t;
+    }
+    return (double)best / n;
+}
+
+template<typename H, uint64_t (*scalar)(uint64_t)>
+static void bench_batch(const std::vector<uint64_t>& keys, const char* name)
+{
+    const auto n = keys.size();
+    std::vector<uint64_t> out(n), ref(n);
+
+    auto ns = batch_ns(n, [&]() { for (size_t i = 0; i < n; i++) ref[i] = scalar(keys[i]); });
+    printf("    %-10s scalar %.2lf", name, ns);
+
+    const emhash::batch_isa isas[] = {emhash::batch_isa::scalar, emhash::batch_isa::avx2, emhash::batch_isa::avx512};
+    const char* isa_names[] = {"batch", "avx2", "avx512"};
+    for (int j = 0; j < 3; j++) {
+        if (isas[j] > emhash::batch_cpu())
+            break;
+        ns = batch_ns(n, [&]() { emhash::hash_batch<H>(keys.data(), out.data(), n, isas[j]); });
+        printf(" %s %.2lf%s", isa_names[j], ns, out == ref ? "" : "(mismatch)");
+    }
+    printf(" ns/key\n");
+}
+
+//hb: hash n integer keys one by one with the util.h mixers and with emhash::hash_batch
+static void bench_hash_batch(int n)
+{
+    std::vector<uint64_t> keys(n);
+    for (auto& key : keys)
+        key = rnd();
+
+    printf("hash_batch %d keys\n", n);
+    bench_batch<emhash::fold_hash<false>, hashfib>(keys, "hashfib");
+    bench_batch<emhash::mix_hash<true>, hashmix>(keys, "hashmix");
+    bench_batch<emhash::mur3_hash, hash_mur3>(keys, "mur3");
+    bench_batch<emhash::splitmix_hash, udb_splitmix64>(keys, "splitmix64");
+    printf("\n");
+}
+
 int main(int argc, char* argv[])
 {
     srand(time(0));
@@ -519,6 +570,8 @@ int main(int argc, char* argv[])
             TEST_LEN = atoi(argv[i + 1]);
         else if (cmd == "i")
             INIT_SIZE = atoi(argv[i + 1]);
+        else if (cmd == "hb")
+            bench_hash_batch(atoi(argv[i + 1]));
     }
 #endif
 
@@ -0,0 +1,212 @@
+#include "util.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//a virtual clock so that expiry can be replayed without sleeping
+static std::atomic<uint32_t> lru_now(1000);
+static uint32_t lru_clock() { return lru_now.load(std::memory_order_relaxed); }
+#define EMHASH_LRU_CLOCK lru_clock
+
+#include "lru_size.h"
+#include "lru_time.h"
+#include "lru_sync.h"
+#include "lru_sample.h"
+
+//n entries with timeouts spread over 100 seconds, 1% of them expire per second
+static void bench_expire(uint32_t n, uint32_t seconds, bool wheel, uint32_t budget)
+{
+    lru_now = 1000;
+    emlru_time::lru_cache<uint64_t, uint32_t> cache(n, n);
+    if (wheel)
+        cache.set_expire_wheel(4096);
+
+    Sfc4 srng(n);
+    auto ts = getus();
+    for (uint32_t i = 0; i < n; i++)
+        cache.insert(srng(), i, (int)(1 + i % 100));
+    const auto insert_us = getus() - ts;
+
+    int64_t max_pause = 0, total = 0;
+    size_t erased = 0;
+    for (uint32_t s = 0; s < seconds; s++) {
+        lru_now ++;
+        const auto before = cache.size();
+        size_t erase_once = 0;
+        do {
+            ts = getus();
+            if (wheel)
+                erase_once = cache.expire_some(budget);
+            else
+                cache.clear_timeout();
+            const auto pause = getus() - ts;
+            total += pause;
+            max_pause = std::max(max_pause, pause);
+        } while (erase_once > 0);
+        erased += before - cache.size();
+    }
+
+    printf("%s n = %u, budget = %10u, insert = %5d ms, expired = %9zd, expire time = %6d ms, max pause = %6d us\n",
+            wheel ? "wheel" : "scan ", n, budget, (int)(insert_us / 1000), erased, (int)(total / 1000), (int)max_pause);
+}
+
+//the value stands for an object of that many bytes
+struct byte_weight
+{
+    size_t operator()(const uint64_t&, const uint32_t& value) const { return sizeof(uint64_t) + value; }
+};
+
+//insert keys drawn from 4x the capacity so that eviction keeps running
+template<class Cache>
+static void bench_weight(const char* name, Cache& cache, uint32_t n)
+{
+    Sfc4 srng(n);
+    size_t sum_weight = 0;
+    auto ts = getus();
+    for (uint32_t i = 0; i < 4 * n; i++) {
+        const auto value = uint32_t(40 + srng() % 40000);
+        cache.insert(srng() % (4 * n), value);
+    }
+    const auto insert_us = getus() - ts;
+
+    ts = getus();
+    size_t hits = 0;
+    for (uint32_t i = 0; i < 4 * n; i++)
+        hits += cache.try_get(srng() % (4 * n)) != nullptr;
+    const auto find_us = getus() - ts;
+
+    for (const auto& v : cache)
+        sum_weight += byte_weight()(v.first, v.second);
+
+    printf("%-22s n = %u, insert = %5d ms, find = %5d ms, hits = %9zd, size = %9zd, weight = %6zd MB(%zd MB)\n",
+            name, n, (int)(insert_us / 1000), (int)(find_us / 1000), hits, cache.size(), sum_weight >> 20, (size_t)(cache.total_weight() >> 20));
+}
+
+//read-through traffic over 10 * n keys, key = u^3 * range is skewed towards small keys so that
+//the recency policy decides the hit ratio. returns the size averaged over the run.
+template<class Cache>
+static size_t bench_hit_ratio(const char* name, Cache& cache, uint32_t n)
+{
+    Sfc4 srng(n);
+    const uint64_t range = 10ull * n;
+    size_t hits = 0, sum_size = 0;
+    const uint32_t ops = 8 * n;
+
+    auto ts = getus();
+    for (uint32_t i = 0; i < ops; i++) {
+        const double u = (double)(srng() >> 11) / (double)(1ull << 53);
+        const uint64_t key = (uint64_t)(u * u * u * range);
+        if (cache.try_get(key) != nullptr)
+            hits ++;
+        else
+            cache.insert(key, (uint32_t)i);
+        if (i % 1024 == 0)
+            sum_size += cache.size();
+    }
+    const auto use_us = getus() - ts;
+
+    printf("%-22s n = %u, ops = %u, time = %5d ms, %5.1f Mops/s, hit ratio = %.4f, avg size = %9zd\n",
+            name, n, ops, (int)(use_us / 1000), ops / (double)use_us, hits / (double)ops, sum_size / (ops / 1024 + 1));
+    return sum_size / (ops / 1024 + 1);
+}
+
+//64 threads hit 100 hot keys which all expire at the same tick, a load costs 1 ms
+static void bench_stampede(const char* name, int mode, uint32_t ticks)
+{
+    constexpr int threads = 64, hot_keys = 100;
+    lru_now = 1000;
+    emlru_time::sync_cache<uint64_t, uint64_t> cache(hot_keys * 2, 1 << 10, 1, mode == 2 ? 2 : 0);
+    std::atomic<uint64_t> loads(0), gets(0);
+    std::atomic<bool> stop(false);
+
+    auto loader = [&loads](const uint64_t& key) {
+        loads ++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return key * 2;
+    };
+
+    auto ts = getus();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            Sfc4 srng(t + 1);
+            uint64_t local_gets = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const uint64_t key = srng() % hot_keys;
+                uint64_t value;
+                if (mode == 0) {
+                    if (!cache.try_get(key, value)) {
+                        value = loader(key);
+                        cache.insert_or_assign(key, value);
+                    }
+                } else {
+                    value = cache.get_or_load(key, loader);
+                }
+                assert(value == key * 2);
+                local_gets ++;
+            }
+            gets += local_gets;
+        });
+    }
+
+    for (uint32_t i = 0; i < ticks; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        lru_now ++;
+    }
+    stop = true;
+    for (auto& worker : workers)
+        worker.join();
+
+    printf("%-22s threads = %d, hot keys = %d, ticks = %u, loads = %6zd, gets = %9zd, time = %d ms\n",
+            name, threads, hot_keys, ticks, (size_t)loads, (size_t)gets, (int)((getus() - ts) / 1000));
+}
+
+int main(int argc, char* argv[])
+{
+    const uint32_t n = argc > 1 ? (uint32_t)atoi(argv[1]) : 50'000'000;
+    const uint32_t seconds = argc > 2 ? (uint32_t)atoi(argv[2]) : 10;
+
+    bench_expire(n, seconds, false, ~0u);
+    bench_expire(n, seconds, true, ~0u);
+    bench_expire(n, seconds, true, n / 1000);
+
+    const uint32_t wn = n / 10;
+    const uint64_t budget = (uint64_t)wn * (20000 + 8);
+    {
+        emlru_size::lru_cache<uint64_t, uint32_t> cache(wn, wn / 2);
+        bench_weight("lru_size", cache, wn);
+    }
+    {
+        emlru_size::lru_cache<uint64_t, uint32_t, std::hash<uint64_t>, std::equal_to<uint64_t>, byte_weight> cache(wn, wn);
+        cache.max_weight(budget);
+        bench_weight("lru_size weighted", cache, wn);
+    }
+    {
+        emlru_time::lru_cache<uint64_t, uint32_t> cache(wn, wn);
+        bench_weight("lru_time", cache, wn);
+    }
+    {
+        emlru_time::lru_cache<uint64_t, uint32_t, std::hash<uint64_t>, std::equal_to<uint64_t>, byte_weight> cache(wn, 2 * wn);
+        cache.max_weight(budget);
+        bench_weight("lru_time weighted", cache, wn);
+    }
+
+    //lru_size evicts half of a full table at once, the sampled caches get its average size
+    size_t avg_size = 0;
+    {
+        emlru_size::lru_cache<uint64_t, uint32_t> cache(wn, wn / 2);
+        avg_size = bench_hit_ratio("lru_size", cache, wn);
+    }
+    for (uint32_t samples : {3, 5, 10}) {
+        char name[32];
+        snprintf(name, sizeof(name), "lru_sample %u", samples);
+        emlru_sample::lru_cache<uint64_t, uint32_t> cache(avg_size, samples);
+        bench_hit_ratio(name, cache, wn);
+    }
+
+    bench_stampede("stampede try_get", 0, 50);
+    bench_stampede("stampede get_or_load", 1, 50);
+    bench_stampede("stampede get_or_load swr", 2, 50);
+
+    return 0;
+}
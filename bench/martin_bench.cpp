@@ -26,6 +26,10 @@
 #include "../hash_table7.hpp"
 #include "../hash_table6.hpp"
 #include "../hash_table8.hpp"
+#if CXX17
+#include "../hash_string8.hpp"
+#include "../hash_small_key.hpp"
+#endif
 
 //#include "../thirdparty/emhash/hash_table8v.hpp"
 //#include "../thirdparty/emhash/hash_table8v2.hpp"
@@ -116,6 +120,8 @@ static const char* find_hash(const std::string& map_name)
         return show_name.count("emilib2") ? show_name["emilib2"].data() : nullptr;
     if (map_name.find("emilib3") < 10)
         return show_name.count("emilib3") ? show_name["emilib3"].data() : nullptr;
+    if (map_name.find("StringMap") < 20)
+        return show_name.count("emhash8") ? "emhash8 arena" : nullptr;
     if (map_name.find("HashMapCell") < 30)
         return show_name.count("HashMapCell") ? show_name["HashMapCell"].data() : nullptr;
     if (map_name.find("HashMapTable") < 30)
@@ -1166,6 +1172,52 @@ static void bench_randomFindString(MAP&)
     printf("total time = %.2f + %.2f = %.2f s\n", now1 - nows, now2 - now1, now2 - nows);
 }
 
+//insert 1M distinct keys of each length, then find every one of them 5 times in random order
+template<class MAP>
+static void bench_smallKey(const char* label)
+{
+    if (!find_hash(typeid(MAP).name()))
+        return;
+    printf("    %-28s", label);
+
+    using KeyT = typename MAP::key_type;
+    constexpr size_t n = 1000000, rounds = 5;
+    auto nows = now2sec();
+    for (size_t len : {4, 8, 12, 16, 20, 24, 32, 48, 64}) {
+        sfc64 rng(RND + len);
+        std::vector<KeyT> keys; keys.reserve(n);
+        std::string str(len, 'k');
+        for (size_t i = 0; i < n; i++) {
+            //distinct head bytes, the tail is shared so long compares run to the end
+            auto v = i;
+            for (size_t j = 0; j < len && j < 4; j++, v >>= 8)
+                str[j] = char(v & 0xFF);
+            keys.emplace_back(str);
+        }
+        std::vector<uint32_t> order(n);
+        for (size_t i = 0; i < n; i++) order[i] = (uint32_t)i;
+        std::shuffle(order.begin(), order.end(), rng);
+
+        auto ts = now2sec();
+        MAP map;
+        for (size_t i = 0; i < n; i++)
+            map.emplace(keys[i], i);
+        const auto insert_ms = (now2sec() - ts) * 1000;
+
+        ts = now2sec();
+        size_t sum = 0;
+        for (size_t r = 0; r < rounds; r++) {
+            for (auto i : order)
+                sum += map.find(keys[i])->second;
+        }
+        const auto find_ms = (now2sec() - ts) * 1000;
+        printf(" %2d:%4d/%4d", (int)len, (int)insert_ms, (int)find_ms);
+        if (sum != rounds * n * (n - 1) / 2)
+            printf("error");
+    }
+    printf(" total %.2f s\n", now2sec() - nows);
+}
+
 template<class MAP>
 static void bench_randomEraseString(MAP&)
 {
@@ -1400,6 +1452,9 @@ static void runTest(int sflags, int eflags)
 #endif
 
         { emhash8::HashMap<std::string, size_t, hash_func> bench; bench_randomFindString(bench); }
+#if CXX17 && !defined(HOOD_HASH) && !defined(ABSL_HASH) && !defined(A_HASH) && !defined(ANKERL_HASH) && !defined(STD_HASH)
+        { emhash8::StringMap<size_t, hash_func> bench; bench_randomFindString(bench); }
+#endif
         { emhash6::HashMap<std::string, size_t, hash_func> bench; bench_randomFindString(bench); }
         { emhash5::HashMap<std::string, size_t, hash_func> bench; bench_randomFindString(bench); }
 #if QC_HASH > 1
@@ -2224,6 +2279,20 @@ static void runTest(int sflags, int eflags)
         {  bench_udb3<emhash5::HashMap<uint32_t, uint32_t, hash_func>>(); }
     }
 
+#if CXX17
+    if (sflags <= 16 && eflags >= 16)
+    {
+        typedef WysHasher hash_func;
+        puts("\nbench_smallKey: key length:insert/find ms");
+        bench_smallKey<emhash8::HashMap<std::string, size_t, hash_func>>("emhash8 std::string");
+        bench_smallKey<emhash8::HashMap<emhash::small_key<16>, size_t>>("emhash8 small_key<16>");
+        bench_smallKey<emhash8::HashMap<emhash::small_key<24>, size_t>>("emhash8 small_key<24>");
+        bench_smallKey<emhash7::HashMap<std::string, size_t, hash_func>>("emhash7 std::string");
+        bench_smallKey<emhash7::HashMap<emhash::small_key<16>, size_t>>("emhash7 small_key<16>");
+        bench_smallKey<emhash7::HashMap<emhash::small_key<24>, size_t>>("emhash7 small_key<24>");
+    }
+#endif
+
     printf("\ntotal time = %.2f s", now2sec() - start);
 }
 
@@ -2251,6 +2320,7 @@ static const char* const cases[] = {
     "bench_InsertEraseBegin",
     "bench_CreateInsert",
     "bench_udb3",
+    "bench_smallKey",
 };
 
 int main(int argc, char* argv[])
@@ -262,6 +262,7 @@ static int loop_vector_time = 0, loop_rand = 0;
 static int func_index = 0, func_size = 10;
 static int func_first = 0, func_last = 0;
 static float hlf = 0.0;
+static float high_loadf = 0.99f; //max load factor of insert_high_load, set by h(90-99.9)
 
 static std::map<std::string, int64_t> func_result;
 //func:hash -> time
@@ -635,6 +636,25 @@ static void insert_cache_size(const std::string& hash_name, const std::vector<ke
     check_func_result(hash_name, level, sum, ts1);
 }
 
+//a scratch map reserved for the whole data set, filled with a few keys and cleared per query
+template<class hash_type>
+static void clear_reuse(const std::string& hash_name, const std::vector<keyType>& vList)
+{
+    size_t sum = 0;
+    hash_type tmp;
+    tmp.reserve(vList.size());
+
+    const size_t query_size = 1000, query_end = std::min(vList.size(), 500 * query_size);
+    auto ts1 = getus();
+    for (size_t i = 0; i + query_size <= query_end; i += query_size) {
+        for (size_t j = i; j < i + query_size; j++)
+            tmp.insert(vList[j]);
+        sum += tmp.size();
+        tmp.clear();
+    }
+    check_func_result(hash_name, __FUNCTION__, sum, ts1);
+}
+
 template<class hash_type>
 static void insert_high_load(const std::string& hash_name, const std::vector<keyType>& vList)
 {
@@ -642,7 +662,7 @@ static void insert_high_load(const std::string& hash_name, const std::vector<key
     size_t pow2 = 2u << ilog(vList.size(), 2);
     hash_type tmp;
 
-    const auto max_loadf = 0.99f;
+    const auto max_loadf = high_loadf;
 #ifndef SMAP
     tmp.max_load_factor(max_loadf);
     tmp.reserve(pow2 / 2);
@@ -952,6 +972,7 @@ static void benOneHash(const std::string& hash_name, const std::vector<keyType>&
         insert_erase     <hash_type>(hash_name, oList);
 #endif
         insert_high_load <hash_type>(hash_name, oList);
+        clear_reuse      <hash_type>(hash_name, oList);
 
         insert_cache_size <hash_type>(hash_name, oList, "insert_l1_cache", l1_size, l1_size + 1000);
 //        insert_cache_size <hash_type>(hash_name, oList, "insert_l2_cache", l2_size, l2_size + 1000);
@@ -1256,7 +1277,7 @@ int main(int argc, char* argv[])
         maxn = (1 << 30) / type_size;
 
     float load_factor = 0.0945f;
-    printf("./sbench maxn = %d c(0-1000) f(0-100) d[2-9 mpatsebu] a(0-3) b t(n %dkB - %dMB)\n",
+    printf("./sbench maxn = %d c(0-1000) f(0-100) d[2-9 mpatsebu] a(0-3) b t h(90-99.9) (n %dkB - %dMB)\n",
             (int)maxn, minn*type_size >> 10, maxn*type_size >> 20);
 
     for (int i = 1; i < argc; i++) {
@@ -1269,6 +1290,8 @@ int main(int argc, char* argv[])
             load_factor = float(atof(&argv[i][0] + 1) / 100.0);
         else if (cmd == 'c' && value > 0)
             maxc = value;
+        else if (cmd == 'h' && value > 0)
+            high_loadf = float(atof(&argv[i][0] + 1) / 100.0);
         else if (cmd == 'a')
             run_type = value;
         else if (cmd == 'r' && value > 0)
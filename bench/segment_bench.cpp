@@ -0,0 +1,83 @@
+//peak RSS while growing emhash8::HashMap and emhash8::SegmentMap from 0 entries
+//usage: sgbench [map(8/seg)] [entries] [segment size] [value bytes(4/56)]
+//run one map per process, getrusage reports the peak of the whole process
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <chrono>
+#include <string>
+#if _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include "hash_segment8.hpp"
+
+static size_t peak_rss_mb()
+{
+#if _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    return pmc.PeakWorkingSetSize >> 20;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if __APPLE__
+    return (size_t)usage.ru_maxrss >> 20;
+#else
+    return (size_t)usage.ru_maxrss >> 10;
+#endif
+#endif
+}
+
+template<size_t N> struct Value { uint8_t bytes[N]; };
+
+//the peak is printed every time the entry count doubles and once at the end
+template<class Map, class ValueT>
+static void grow(Map& map, const char* name, uint64_t n)
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t x = n, report = 1 << 20;
+    for (uint64_t i = 0; i < n; i++) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17; //xorshift64, no repeats
+        map.emplace(x, ValueT());
+        if (i + 1 == report) {
+            printf("  %-32s %12llu entries, peak RSS %7zu MB\n", name, (unsigned long long)report, peak_rss_mb());
+            report *= 2;
+        }
+    }
+
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    printf("%-34s %12llu entries, peak RSS %7zu MB, %.1f s\n", name, (unsigned long long)map.size(), peak_rss_mb(), ms / 1000.0);
+}
+
+template<class ValueT>
+static void run(const std::string& kind, uint64_t n, size_t segment_size)
+{
+    if (kind == "seg") {
+        emhash8::SegmentMap<uint64_t, ValueT> map(segment_size);
+        char name[64];
+        snprintf(name, sizeof(name), "SegmentMap, segment %zu", segment_size);
+        grow<decltype(map), ValueT>(map, name, n);
+    } else {
+        emhash8::HashMap<uint64_t, ValueT> map;
+        grow<decltype(map), ValueT>(map, "emhash8::HashMap", n);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string kind = argc > 1 ? argv[1] : "seg";
+    const uint64_t n = argc > 2 ? strtoull(argv[2], nullptr, 10) : 10000000;
+    const size_t segment_size = argc > 3 ? strtoull(argv[3], nullptr, 10) : 1 << 20;
+    const int value_bytes = argc > 4 ? atoi(argv[4]) : 56;
+
+    if (value_bytes <= 4)
+        run<uint32_t>(kind, n, segment_size);
+    else
+        run<Value<56>>(kind, n, segment_size);
+    return 0;
+}
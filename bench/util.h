@@ -566,6 +566,12 @@ struct WysHasher
     {
         return wyhash(str.data(), str.size(), 0);
     }
+#if __cplusplus > 201402L
+    std::size_t operator()(std::string_view str) const
+    {
+        return wyhash(str.data(), str.size(), 0);
+    }
+#endif
 };
 
 struct WyIntHasher
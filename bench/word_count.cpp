@@ -16,6 +16,7 @@
 #include "martin/robin_hood.h"
 #include "martin/unordered_dense.h"
 #include "hash_table8.hpp"
+#include "hash_string8.hpp"
 #include "hash_table7.hpp"
 #include "hash_table6.hpp"
 #include "hash_table5.hpp"
@@ -287,6 +288,17 @@ template<class K, class V> using boost_unordered_flat_map =
     boost::unordered_flat_map<K, V, BstrHasher>;
 
 template<class K, class V> using emhash_map8 = emhash8::HashMap<K, V, BstrHasher>;
+template<class K, class V> using emhash_str8 = emhash8::StringMap<V, BstrHasher>;
+
+//owning std::string keys, one heap allocation per key longer than the SSO buffer
+template<class K, class V> struct emhash_string8 : emhash8::HashMap<std::string, V, BstrHasher, std::equal_to<>>
+{
+    V& operator[](K key)
+    {
+        auto it = this->find(key);
+        return it != this->end() ? it->second : emhash8::HashMap<std::string, V, BstrHasher, std::equal_to<>>::operator[](std::string(key));
+    }
+};
 template<class K, class V> using emhash_map7 = emhash7::HashMap<K, V, BstrHasher>;
 template<class K, class V> using emhash_map6 = emhash6::HashMap<K, V, BstrHasher>;
 template<class K, class V> using emhash_map5 = emhash5::HashMap<K, V, BstrHasher>;
@@ -387,6 +399,8 @@ int main(int argc, const char* argv[])
     test<boost_unordered_flat_map_fnv1a>( "boost::unordered_flat_map, FNV-1a" );
     test<emhash_map6>( "emhash6::hash_map" );
     test<emhash_map8>( "emhash8::hash_map" );
+    test<emhash_string8>( "emhash8::hash_map<std::string>" );
+    test<emhash_str8>( "emhash8::StringMap" );
 
     std::cout << "---\n\n";
     for( auto const& x: times )
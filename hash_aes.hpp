@@ -0,0 +1,272 @@
+// emhash::aes_hash, AES-NI/VAES string hashing for emhash
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_aes.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+
+// aes_hash(data, len, seed) hashes a byte string longer than EMH_AES_MIN_LEN with AES rounds,
+// 16-byte blocks with AES-NI and 32-byte blocks with VAES, picked at runtime. Four block states
+// absorb 64 bytes per step by using the data as round keys, then fold into one 64-bit value
+// with three more rounds.
+// The VAES loop keeps the same four states in two ymm registers, so both give the same hash.
+// Shorter keys, and all keys without AES-NI (or GCC/clang on x86-64, or with EMH_AES_SCALAR),
+// take wyhash, the wyhashstr of emhash8. The result only has to be stable within one process.
+//
+// Use aes_hasher as the HashT of any emhash map or set with string keys, or build emhash5-8
+// with EMH_AES_HASH to replace their built-in string hash.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+    #pragma intrinsic(_umul128)
+#endif
+
+#if !defined(EMH_AES_SCALAR) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    #define EMH_AES_SIMD 1
+    #include <immintrin.h>
+#endif
+
+//keys up to this length take the inlined wyhash, the call and the latency of the AES rounds
+//only pay off from about 64 bytes on
+#ifndef EMH_AES_MIN_LEN
+    #define EMH_AES_MIN_LEN 48
+#endif
+
+namespace emhash {
+
+/// Instruction sets of aes_hash, aes_cpu() returns the best one this cpu runs.
+enum class aes_isa : uint8_t { none, aesni, vaes };
+
+inline aes_isa aes_cpu()
+{
+#if EMH_AES_SIMD
+    static const aes_isa isa = []() {
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("aes"))
+            return aes_isa::none;
+        if (__builtin_cpu_supports("vaes") && __builtin_cpu_supports("avx2"))
+            return aes_isa::vaes;
+        return aes_isa::aesni;
+    }();
+    return isa;
+#else
+    return aes_isa::none;
+#endif
+}
+
+namespace aes_detail {
+
+static inline uint64_t wymix(uint64_t A, uint64_t B)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = A; r *= B;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    A = _umul128(A, B, &B);
+    return A ^ B;
+#else
+    uint64_t ha = A >> 32, hb = B >> 32, la = (uint32_t)A, lb = (uint32_t)B;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32); c += lo < t;
+    return lo ^ (rh + (rm0 >> 32) + (rm1 >> 32) + c);
+#endif
+}
+
+static inline uint64_t wyr8(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+static inline uint64_t wyr4(const uint8_t* p) { uint32_t v; memcpy(&v, p, 4); return v; }
+static inline uint64_t wyr3(const uint8_t* p, size_t k)
+{
+    return (((uint64_t)p[0]) << 16) | (((uint64_t)p[k >> 1]) << 8) | p[k - 1];
+}
+
+static constexpr uint64_t secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+//the first and last 8 bytes (or their 4/3 byte parts) of a key up to 16 bytes long, as wyhash
+static inline void load_short(const uint8_t* p, size_t len, uint64_t& a, uint64_t& b)
+{
+    if (len >= 4) {
+        const auto half = (len >> 3) << 2;
+        a = (wyr4(p) << 32U) | wyr4(p + half); p += len - 4;
+        b = (wyr4(p) << 32U) | wyr4(p - half);
+    } else {
+        a = len ? wyr3(p, len) : 0; b = 0;
+    }
+}
+
+//wyhash, the fallback without AES-NI
+static inline uint64_t wyhash(const void* key, size_t len, uint64_t seed)
+{
+    const uint8_t* p = (const uint8_t*)key;
+    uint64_t a, b;
+    seed ^= secret[0];
+    if (len <= 16) {
+        load_short(p, len, a, b);
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wymix(wyr8(p +  0) ^ secret[1], wyr8(p +  8) ^ seed);
+                see1 = wymix(wyr8(p + 16) ^ secret[2], wyr8(p + 24) ^ see1);
+                see2 = wymix(wyr8(p + 32) ^ secret[3], wyr8(p + 40) ^ see2);
+                p += 48; i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wymix(wyr8(p) ^ secret[1], wyr8(p + 8) ^ seed);
+            i -= 16; p += 16;
+        }
+        a = wyr8(p + i - 16);
+        b = wyr8(p + i - 8);
+    }
+
+    return wymix(secret[1] ^ len, wymix(a ^ secret[1], b ^ seed));
+}
+
+#if EMH_AES_SIMD
+#define EMH_AES_TARGET __attribute__((target("aes")))
+
+static inline __m128i load16(const uint8_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+
+EMH_AES_TARGET static inline uint64_t fold(__m128i h)
+{
+    return (uint64_t)_mm_cvtsi128_si64(h) ^ (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(h, h));
+}
+
+//merge the four states, every block gets at least three rounds after its last xor
+EMH_AES_TARGET static inline uint64_t finish(__m128i s0, __m128i s1, __m128i s2, __m128i s3, __m128i key)
+{
+    const __m128i a = _mm_aesenc_si128(s0, s2);
+    const __m128i b = _mm_aesenc_si128(s1, s3);
+    __m128i h = _mm_aesenc_si128(a, b);
+    h = _mm_aesenc_si128(h, key);
+    h = _mm_aesenc_si128(h, _mm_set_epi64x((long long)secret[2], (long long)secret[3]));
+    return fold(_mm_aesenc_si128(h, key));
+}
+
+//the four states start from the seed and the length
+EMH_AES_TARGET static inline void init(__m128i key, __m128i& s0, __m128i& s1, __m128i& s2, __m128i& s3)
+{
+    s0 = _mm_xor_si128(key, _mm_set_epi64x((long long)secret[0], (long long)secret[1]));
+    s1 = _mm_xor_si128(key, _mm_set_epi64x((long long)secret[1], (long long)secret[2]));
+    s2 = _mm_xor_si128(key, _mm_set_epi64x((long long)secret[2], (long long)secret[3]));
+    s3 = _mm_xor_si128(key, _mm_set_epi64x((long long)secret[3], (long long)secret[0]));
+}
+
+//up to 64 bytes ending at p + len, absorbed as overlapping first and last blocks
+EMH_AES_TARGET static inline uint64_t hash_tail(const uint8_t* p, size_t len, __m128i key,
+        __m128i s0, __m128i s1, __m128i s2, __m128i s3)
+{
+    s0 = _mm_aesenc_si128(s0, load16(p));
+    s1 = _mm_aesenc_si128(s1, load16(p + len - 16));
+    if (len > 32) {
+        s2 = _mm_aesenc_si128(s2, load16(p + 16));
+        s3 = _mm_aesenc_si128(s3, load16(p + len - 32));
+    }
+    return finish(s0, s1, s2, s3, key);
+}
+
+//keys longer than 16 bytes
+EMH_AES_TARGET static uint64_t hash_aesni(const uint8_t* p, size_t len, uint64_t seed)
+{
+    const __m128i key = _mm_set_epi64x((long long)(seed ^ secret[0]), (long long)(len ^ secret[1]));
+    __m128i s0, s1, s2, s3;
+    init(key, s0, s1, s2, s3);
+    size_t i = len;
+    for (; i > 64; i -= 64, p += 64) {
+        s0 = _mm_aesenc_si128(s0, load16(p +  0));
+        s1 = _mm_aesenc_si128(s1, load16(p + 16));
+        s2 = _mm_aesenc_si128(s2, load16(p + 32));
+        s3 = _mm_aesenc_si128(s3, load16(p + 48));
+    }
+    if (len > 64)
+        p -= 64 - i, i = 64;
+    return hash_tail(p, i, key, s0, s1, s2, s3);
+}
+
+//only keys longer than 64 bytes come here
+__attribute__((target("aes,vaes,avx2"))) static uint64_t hash_vaes(const uint8_t* p, size_t len, uint64_t seed)
+{
+    const __m128i key = _mm_set_epi64x((long long)(seed ^ secret[0]), (long long)(len ^ secret[1]));
+    __m128i s0, s1, s2, s3;
+    init(key, s0, s1, s2, s3);
+
+    __m256i s01 = _mm256_set_m128i(s1, s0), s23 = _mm256_set_m128i(s3, s2);
+    size_t i = len;
+    for (; i > 64; i -= 64, p += 64) {
+        s01 = _mm256_aesenc_epi128(s01, _mm256_loadu_si256((const __m256i*)(p +  0)));
+        s23 = _mm256_aesenc_epi128(s23, _mm256_loadu_si256((const __m256i*)(p + 32)));
+    }
+    p -= 64 - i;
+
+    s0 = _mm256_castsi256_si128(s01); s1 = _mm256_extracti128_si256(s01, 1);
+    s2 = _mm256_castsi256_si128(s23); s3 = _mm256_extracti128_si256(s23, 1);
+    return hash_tail(p, 64, key, s0, s1, s2, s3);
+}
+#undef EMH_AES_TARGET
+#endif
+
+} // namespace aes_detail
+
+/// Hashes len bytes at data, long keys with AES rounds where the cpu has them, wyhash otherwise.
+inline uint64_t aes_hash(const void* data, size_t len, uint64_t seed = 0)
+{
+    const uint8_t* p = (const uint8_t*)data;
+#if EMH_AES_SIMD
+    if (len > EMH_AES_MIN_LEN) {
+        const auto isa = aes_cpu();
+        if (isa == aes_isa::vaes && len > 64)
+            return aes_detail::hash_vaes(p, len, seed);
+        else if (isa != aes_isa::none)
+            return aes_detail::hash_aesni(p, len, seed);
+    }
+#endif
+    return aes_detail::wyhash(p, len, seed);
+}
+
+/// Transparent string hasher, std::string, string_view and C strings of equal text hash alike.
+struct aes_hasher
+{
+    using is_transparent = void;
+
+    size_t operator()(const std::string& key) const { return (size_t)aes_hash(key.data(), key.size()); }
+    size_t operator()(const char* key) const { return (size_t)aes_hash(key, strlen(key)); }
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+    size_t operator()(std::string_view key) const { return (size_t)aes_hash(key.data(), key.size()); }
+#endif
+};
+
+} // namespace emhash
@@ -0,0 +1,254 @@
+// emhash::hash_batch, SIMD batch hashing of integer keys for emhash
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_batch.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+
+// hash_batch<H>(keys, out, n) writes H::hash(keys[i]) to out[i] for integer keys, 4 keys per
+// step with AVX2 and 8 with AVX-512, picked at runtime. Each mixer is written once with plain
+// operators in mix(), so the scalar fallback and the vector kernels run the same code on uint64_t
+// and on GCC vector types and give the same results. A 64x64 high multiply has no SIMD instruction and
+// is built from four 32-bit products, so fold_hash is only vectorized with AVX-512.
+// Without GCC/clang on x86-64 (or with EMH_BATCH_SCALAR) only the scalar loop is compiled.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+    #pragma intrinsic(_umul128)
+#endif
+
+#if !defined(EMH_BATCH_SCALAR) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    #define EMH_BATCH_SIMD 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define EMH_BATCH_INLINE inline __attribute__((always_inline))
+#else
+    #define EMH_BATCH_INLINE inline
+#endif
+
+namespace emhash {
+
+/// Instruction sets of the batch kernels, batch_cpu() returns the best one this cpu runs.
+enum class batch_isa : uint8_t { scalar, avx2, avx512 };
+
+inline batch_isa batch_cpu()
+{
+#if EMH_BATCH_SIMD
+    static const batch_isa isa = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+            return batch_isa::avx512;
+        return __builtin_cpu_supports("avx2") ? batch_isa::avx2 : batch_isa::scalar;
+    }();
+    return isa;
+#else
+    return batch_isa::scalar;
+#endif
+}
+
+/// High 64 bits of key * b, from 32-bit halves for vector lanes.
+template<typename T>
+EMH_BATCH_INLINE void mul_hi(const T& key, uint64_t b, T& high)
+{
+    const uint64_t bl = b & 0xFFFFFFFFull, bh = b >> 32;
+    const T al = key & 0xFFFFFFFFull, ah = key >> 32;
+    const T ll = al * bl, hl = ah * bl, lh = al * bh;
+    const T mid = (ll >> 32) + (hl & 0xFFFFFFFFull) + (lh & 0xFFFFFFFFull);
+    high = ah * bh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+}
+
+EMH_BATCH_INLINE void mul_hi(uint64_t key, uint64_t b, uint64_t& high)
+{
+#if __SIZEOF_INT128__
+    high = (uint64_t)(((__uint128_t)key * b) >> 64);
+#elif _WIN64
+    _umul128(key, b, &high);
+#else
+    mul_hi<uint64_t>(key, b, high);
+#endif
+}
+
+// Each mixer transforms uint64_t or a vector of them in place with mix(), vectors are never
+// passed or returned by value so no -Wpsabi ABI note fires outside the target kernels.
+
+/// Fibonacci multiply folding the 128-bit product, by xor as hashfib and emhash7 EMH_INT_HASH 1
+/// or by add as emhash8 EMH_INT_HASH 1.
+template<bool ADD>
+struct fold_hash
+{
+    template<typename T>
+    static EMH_BATCH_INLINE void mix(T& h)
+    {
+        T high;
+        mul_hi(h, UINT64_C(11400714819323198485), high);
+        h *= UINT64_C(11400714819323198485);
+        if (ADD)
+            h += high;
+        else
+            h ^= high;
+    }
+
+    static uint64_t hash(uint64_t key) { mix(key); return key; }
+};
+
+/// MurmurHash3 finalizer, emhash7/8 EMH_INT_HASH 2.
+struct mur3_hash
+{
+    template<typename T>
+    static EMH_BATCH_INLINE void mix(T& h)
+    {
+        h ^= h >> 33;
+        h *= UINT64_C(0xff51afd7ed558ccd);
+        h ^= h >> 33;
+        h *= UINT64_C(0xc4ceb9fe1a85ec53);
+        h ^= h >> 33;
+    }
+
+    static uint64_t hash(uint64_t key) { mix(key); return key; }
+};
+
+/// hashmix in bench/util.h rotates the sum, emhash7/8 EMH_INT_HASH 3 doesn't.
+template<bool ROTATE>
+struct mix_hash
+{
+    template<typename T>
+    static EMH_BATCH_INLINE void mix(T& h)
+    {
+        const T ror = (h >> 32) | (h << 32);
+        h = h * UINT64_C(0xA24BAED4963EE407) + ror * UINT64_C(0x9FB21C651E98DF25);
+        if (ROTATE)
+            h = (h >> 32) | (h << 32);
+    }
+
+    static uint64_t hash(uint64_t key) { mix(key); return key; }
+};
+
+/// Stafford mix13, the default hash64 of emhash7/8.
+struct mix13_hash
+{
+    template<typename T>
+    static EMH_BATCH_INLINE void mix(T& h)
+    {
+        h = (h ^ (h >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+        h = (h ^ (h >> 27)) * UINT64_C(0x94d049bb133111eb);
+        h ^= h >> 31;
+    }
+
+    static uint64_t hash(uint64_t key) { mix(key); return key; }
+};
+
+/// udb_splitmix64 in bench/util.h.
+struct splitmix_hash
+{
+    template<typename T>
+    static EMH_BATCH_INLINE void mix(T& h)
+    {
+        h += UINT64_C(0x9e3779b97f4a7c15);
+        mix13_hash::mix(h);
+    }
+
+    static uint64_t hash(uint64_t key) { mix(key); return key; }
+};
+
+/// Slowest instruction set a mixer is worth vectorizing on, below it hash_batch runs the scalar
+/// loop. The emulated high multiply of fold_hash loses to scalar mulx on AVX2.
+template<typename H> struct batch_min_isa { static constexpr batch_isa value = batch_isa::avx2; };
+template<bool ADD> struct batch_min_isa<fold_hash<ADD>> { static constexpr batch_isa value = batch_isa::avx512; };
+
+namespace batch_detail {
+
+template<typename H, typename K>
+EMH_BATCH_INLINE void hash_scalar(const K* keys, uint64_t* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = H::hash((uint64_t)keys[i]);
+}
+
+#if EMH_BATCH_SIMD
+typedef uint64_t u64x4 __attribute__((vector_size(32)));
+typedef uint64_t u64x8 __attribute__((vector_size(64)));
+
+//keys narrower than 64 bits are widened as the scalar (uint64_t)key does
+template<typename H, typename V, typename K>
+EMH_BATCH_INLINE void hash_lanes(const K* keys, uint64_t* out, size_t n)
+{
+    constexpr size_t lanes = sizeof(V) / sizeof(uint64_t);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        V v;
+        if (sizeof(K) == sizeof(uint64_t))
+            memcpy(&v, keys + i, sizeof(v));
+        else {
+            for (size_t l = 0; l < lanes; l++)
+                v[l] = (uint64_t)keys[i + l];
+        }
+        H::mix(v);
+        memcpy(out + i, &v, sizeof(v));
+    }
+    hash_scalar<H>(keys + i, out + i, n - i);
+}
+
+template<typename H, typename K>
+__attribute__((target("avx2"))) void hash_avx2(const K* keys, uint64_t* out, size_t n)
+{
+    hash_lanes<H, u64x4>(keys, out, n);
+}
+
+template<typename H, typename K>
+__attribute__((target("avx512f,avx512dq"))) void hash_avx512(const K* keys, uint64_t* out, size_t n)
+{
+    hash_lanes<H, u64x8>(keys, out, n);
+}
+#endif
+
+} // namespace batch_detail
+
+/// out[i] = H::hash(keys[i]) for i < n, isa is capped by what the cpu supports and by batch_min_isa.
+template<typename H, typename K>
+inline void hash_batch(const K* keys, uint64_t* out, size_t n, batch_isa isa = batch_cpu())
+{
+    static_assert(std::is_integral<K>::value, "hash_batch only hashes integer keys");
+#if EMH_BATCH_SIMD
+    if (isa > batch_cpu())
+        isa = batch_cpu();
+    if (isa < batch_min_isa<H>::value)
+        isa = batch_isa::scalar;
+    if (isa == batch_isa::avx512)
+        return batch_detail::hash_avx512<H>(keys, out, n);
+    else if (isa == batch_isa::avx2)
+        return batch_detail::hash_avx2<H>(keys, out, n);
+#else
+    (void)isa;
+#endif
+    batch_detail::hash_scalar<H>(keys, out, n);
+}
+
+} // namespace emhash
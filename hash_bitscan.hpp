@@ -0,0 +1,119 @@
+// emhash::first_word, SIMD scan of the empty bucket bitmask for emhash
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_bitscan.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+
+// first_word(words, from, to) returns the index of the first nonzero word in words[from, to), or
+// to if they are all zero. emhash7 and emhash9 keep one bit per bucket with 1 for empty, so at
+// high load factors an insert whose main bucket word is full walks the bitmask word by word.
+// With AVX-512 8 words (512 buckets) are tested by one vptestmq and the first nonzero lane is
+// the tzcnt of the mask, with AVX2 two 256-bit loads are or-ed and tested by vptest.
+// The kernel is picked once at runtime, without GCC/clang on x86-64 (or with EMH_SCAN_SCALAR)
+// only the scalar loop is compiled.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#if !defined(EMH_SCAN_SCALAR) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    #define EMH_SCAN_SIMD 1
+    #include <immintrin.h>
+#endif
+
+namespace emhash {
+
+namespace scan_detail {
+
+typedef size_t (*scan_fn)(const size_t* words, size_t from, size_t to);
+
+static inline size_t first_word_scalar(const size_t* words, size_t from, size_t to)
+{
+    for (; from < to; from++) {
+        if (words[from] != 0)
+            return from;
+    }
+    return to;
+}
+
+#if EMH_SCAN_SIMD
+__attribute__((target("avx2"))) static inline size_t first_word_avx2(const size_t* words, size_t from, size_t to)
+{
+    for (; from + 8 <= to; from += 8) {
+        const __m256i v0 = _mm256_loadu_si256((const __m256i*)(words + from));
+        const __m256i v1 = _mm256_loadu_si256((const __m256i*)(words + from + 4));
+        const __m256i vo = _mm256_or_si256(v0, v1);
+        if (!_mm256_testz_si256(vo, vo)) {
+            const __m256i zero = _mm256_setzero_si256();
+            const unsigned z0 = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v0, zero)));
+            const unsigned z1 = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v1, zero)));
+            return from + __builtin_ctz(~(z0 | z1 << 4));
+        }
+    }
+    return first_word_scalar(words, from, to);
+}
+
+__attribute__((target("avx512f"))) static inline size_t first_word_avx512(const size_t* words, size_t from, size_t to)
+{
+    for (; from + 8 <= to; from += 8) {
+        const __m512i v = _mm512_loadu_si512((const void*)(words + from));
+        const unsigned nz = _mm512_test_epi64_mask(v, v);
+        if (nz != 0)
+            return from + __builtin_ctz(nz);
+    }
+    if (from < to) {
+        const __m512i v = _mm512_maskz_loadu_epi64((__mmask8)((1u << (to - from)) - 1), (const void*)(words + from));
+        const unsigned nz = _mm512_test_epi64_mask(v, v);
+        if (nz != 0)
+            return from + __builtin_ctz(nz);
+    }
+    return to;
+}
+#endif
+
+inline scan_fn scan_kernel()
+{
+#if EMH_SCAN_SIMD
+    static const scan_fn fn = []() -> scan_fn {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return first_word_avx512;
+        return __builtin_cpu_supports("avx2") ? first_word_avx2 : first_word_scalar;
+    }();
+    return fn;
+#else
+    return first_word_scalar;
+#endif
+}
+
+} // namespace scan_detail
+
+/// Index of the first nonzero word in words[from, to), to if there is none.
+inline size_t first_word(const size_t* words, size_t from, size_t to)
+{
+    return scan_detail::scan_kernel()(words, from, to);
+}
+
+} // namespace emhash
@@ -0,0 +1,188 @@
+// emhash::hash, a hasher for emhash containers with composite key support
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_composite.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+
+// emhash::hash<T> is std::hash<T> for every type std::hash supports, so integer and string keys
+// hash as before. std::pair, std::tuple, std::array and trivially copyable structs without
+// padding (has_unique_object_representations) have no std::hash, for them the fields are packed
+// into one buffer of fixed size and hashed with one mum (multiply and fold) per 16 bytes, instead
+// of hashing each field and combining the results. Integer, enum and pointer fields and nested
+// composites add their bytes, any other field (a std::string, a double) adds its own hash.
+// A struct hashes all of its bytes, so its operator== must compare every field.
+// Requires C++17. Pass it as HashT, or define EMH_COMPOSITE_HASH to make it the default HashT
+// of the emhash2-8 maps and sets, SegmentMap and the lru caches: their headers then include this
+// one and take EMH_DEFAULT_HASH from it, otherwise they fall back to std::hash. The default can
+// also be set directly with -DEMH_DEFAULT_HASH=<template>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <tuple>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+    #pragma intrinsic(_umul128)
+#endif
+
+namespace emhash {
+
+template<typename T, typename = void> struct hash;
+
+namespace composite_detail {
+
+/// std::hash<T> is enabled, disabled specializations are not default constructible.
+template<typename T, typename = void> struct has_std_hash : std::false_type {};
+template<typename T>
+struct has_std_hash<T, decltype((void)std::hash<T>()(std::declval<const T&>()))> : std::true_type {};
+
+/// Types whose object bytes are their value, equal keys have equal bytes.
+template<typename T>
+constexpr bool is_raw = std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T> ||
+    (std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>);
+
+template<typename T> struct is_composite : std::false_type {};
+template<typename A, typename B> struct is_composite<std::pair<A, B>> : std::true_type {};
+template<typename... Ts> struct is_composite<std::tuple<Ts...>> : std::true_type {};
+template<typename T, size_t N> struct is_composite<std::array<T, N>> : std::true_type {};
+
+//bytes a field adds to the buffer and how it writes them
+template<typename T, bool RAW = is_raw<T>, bool COMPOSITE = is_composite<T>::value>
+struct packer
+{
+    static constexpr size_t size = sizeof(T);
+    static void put(uint8_t*& p, const T& v) { memcpy(p, &v, sizeof(T)); p += sizeof(T); }
+};
+
+template<typename T>
+struct packer<T, false, false>
+{
+    static constexpr size_t size = sizeof(size_t);
+    static void put(uint8_t*& p, const T& v)
+    {
+        const size_t h = emhash::hash<T>()(v);
+        memcpy(p, &h, sizeof(h)); p += sizeof(h);
+    }
+};
+
+template<typename A, typename B>
+struct packer<std::pair<A, B>, false, true>
+{
+    static constexpr size_t size = packer<A>::size + packer<B>::size;
+    static void put(uint8_t*& p, const std::pair<A, B>& v) { packer<A>::put(p, v.first); packer<B>::put(p, v.second); }
+};
+
+template<typename... Ts>
+struct packer<std::tuple<Ts...>, false, true>
+{
+    static constexpr size_t size = (packer<Ts>::size + ... + 0);
+    static void put(uint8_t*& p, const std::tuple<Ts...>& v)
+    {
+        std::apply([&p](const Ts&... fields) { (packer<Ts>::put(p, fields), ...); }, v);
+    }
+};
+
+template<typename T, size_t N>
+struct packer<std::array<T, N>, false, true>
+{
+    static constexpr size_t size = packer<T>::size * N;
+    static void put(uint8_t*& p, const std::array<T, N>& v) { for (const auto& e : v) packer<T>::put(p, e); }
+};
+
+static constexpr uint64_t secret[3] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull};
+
+static inline uint64_t mum(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = a; r *= b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    a = _umul128(a, b, &b);
+    return a ^ b;
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32); c += lo < t;
+    return lo ^ (rh + (rm0 >> 32) + (rm1 >> 32) + c);
+#endif
+}
+
+static inline uint64_t read8(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+/// N is known at compile time, so the loads are plain moves and the loop unrolls.
+template<size_t N>
+inline uint64_t hash_bytes(const uint8_t* p)
+{
+    if constexpr (N <= 8) {
+        uint64_t a = 0;
+        memcpy(&a, p, N);
+        return mum(a ^ secret[1], secret[0] ^ N);
+    } else if constexpr (N <= 16) {
+        uint64_t b = 0;
+        memcpy(&b, p + 8, N - 8);
+        return mum(read8(p) ^ secret[1], b ^ secret[0] ^ N);
+    } else {
+        uint64_t seed = secret[0] ^ N;
+        for (size_t i = 0; i + 16 < N; i += 16)
+            seed = mum(read8(p + i) ^ secret[1], read8(p + i + 8) ^ seed);
+        return mum(read8(p + N - 16) ^ secret[2], read8(p + N - 8) ^ seed);
+    }
+}
+
+} // namespace composite_detail
+
+/// std::hash<T>, or the packed byte hash for keys std::hash has no specialization for.
+template<typename T, typename>
+struct hash : std::hash<T> {};
+
+template<typename T>
+struct hash<T, std::enable_if_t<!composite_detail::has_std_hash<T>::value &&
+    (composite_detail::is_raw<T> || composite_detail::is_composite<T>::value)>>
+{
+    size_t operator()(const T& key) const
+    {
+        using namespace composite_detail;
+        if constexpr (is_raw<T>) {
+            return (size_t)hash_bytes<sizeof(T)>((const uint8_t*)&key);
+        } else {
+            uint8_t buf[packer<T>::size];
+            uint8_t* p = buf;
+            packer<T>::put(p, key);
+            return (size_t)hash_bytes<packer<T>::size>(buf);
+        }
+    }
+};
+
+} // namespace emhash
+
+#if EMH_COMPOSITE_HASH && !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH emhash::hash
+#endif
@@ -0,0 +1,50 @@
+// emhash::RehashEvent, passed to the rehash hook of emhash5, emhash6, emhash7 and emhash8
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_event.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace emhash {
+
+/// Passed to the rehash hook when a rehash starts (finish = false) and when it ends (finish = true).
+/// One callback receives the events of every emhash table type.
+struct RehashEvent
+{
+    const void* map;
+    bool     finish;
+    size_t   size;
+    size_t   old_buckets;
+    size_t   new_buckets;
+    size_t   bytes_alloc; //emhash8 estimates its pairs from new_buckets and max_load_factor()
+    size_t   bytes_free;  //emhash8 estimates its pairs from old_buckets and max_load_factor()
+    uint64_t elapsed_ns;  //0 at start
+    float    collision;   //elements out of their main bucket, 0 at start
+};
+typedef void (*RehashHook)(const RehashEvent&);
+
+} // namespace emhash
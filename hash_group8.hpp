@@ -0,0 +1,525 @@
+// emhash8::GroupMap for C++17, emhash8 pairs behind a SIMD group-fingerprint index
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_group8.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+// emhash8 follows an index chain one bucket at a time, each hop may be a dependent cache miss.
+// GroupMap keeps the dense insertion-ordered pairs of emhash8 but indexes them by groups of one
+// cache line: 16 control bytes, each a 7-bit fingerprint of the hash or an empty marker, and the
+// slots in _pairs of the first 12. A lookup tests a whole group with one SSE2 compare and
+// movemask and reads _pairs only on a fingerprint hit. The last control byte is an overflow byte
+// as in boost::unordered_flat_map, bit hash % 8 is set when a key with that hash passed the group
+// full, so a miss ends in the first group whose bit is clear and erase needs no tombstone. 32-byte
+// AVX2 groups were tried, their slots take a second and third cache line and cost more on hits.
+// Groups are probed triangularly.
+
+#pragma once
+
+#include <stdexcept>
+#include "hash_table8.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+#endif
+
+namespace emhash8 {
+
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+class GroupMap
+{
+#ifndef EMH_DEFAULT_LOAD_FACTOR
+    constexpr static float EMH_DEFAULT_LOAD_FACTOR = 0.80f;
+#endif
+    constexpr static float EMH_MIN_LOAD_FACTOR     = 0.25f;
+
+public:
+    using value_type     = std::pair<KeyT, ValueT>;
+    using key_type       = KeyT;
+    using mapped_type    = ValueT;
+    using size_type      = uint32_t;
+    using hasher         = HashT;
+    using key_equal      = EqT;
+    using iterator       = value_type*;
+    using const_iterator = const value_type*;
+
+    static constexpr size_type GROUP = 16; //control bytes
+    static constexpr size_type SLOTS = 12; //16 control bytes and 12 slots fill a cache line
+    static constexpr int8_t EMPTY    = -128;
+    static constexpr size_type END   = 0 - 1u;
+
+private:
+    struct alignas(64) Group
+    {
+        int8_t    ctrl[GROUP];  //fingerprint 0..127 or EMPTY, ctrl[GROUP - 1] is the overflow byte
+        size_type slots[SLOTS]; //slot in _pairs of each full control byte
+    };
+
+public:
+    GroupMap(size_type bucket = 2, float mlf = EMH_DEFAULT_LOAD_FACTOR)
+    {
+        max_load_factor(mlf);
+        rebuild(groups_for(bucket));
+    }
+
+    GroupMap(const GroupMap& rhs) : _hasher(rhs._hasher), _eq(rhs._eq), _mlf(rhs._mlf)
+    {
+        rebuild(rhs._group_mask + 1);
+        for (size_type i = 0; i < rhs._num_filled; i++)
+            new(_pairs + i) value_type(rhs._pairs[i]);
+        _num_filled  = rhs._num_filled;
+        _num_dirty   = rhs._num_dirty;
+        memcpy((void*)_groups, rhs._groups, sizeof(Group) * (_group_mask + 1));
+    }
+
+    GroupMap(GroupMap&& rhs) noexcept : GroupMap(0) { swap(rhs); }
+
+    GroupMap(std::initializer_list<value_type> ilist) : GroupMap((size_type)ilist.size())
+    {
+        for (const auto& kv : ilist)
+            insert(kv);
+    }
+
+    GroupMap& operator=(const GroupMap& rhs)
+    {
+        if (this != &rhs) {
+            GroupMap tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    GroupMap& operator=(GroupMap&& rhs) noexcept
+    {
+        if (this != &rhs)
+            swap(rhs);
+        return *this;
+    }
+
+    ~GroupMap()
+    {
+        clearkv();
+        free(_pairs);
+        free_groups(_groups);
+    }
+
+    void swap(GroupMap& rhs)
+    {
+        std::swap(_hasher, rhs._hasher);
+        std::swap(_eq, rhs._eq);
+        std::swap(_pairs, rhs._pairs);
+        std::swap(_groups, rhs._groups);
+        std::swap(_group_mask, rhs._group_mask);
+        std::swap(_num_filled, rhs._num_filled);
+        std::swap(_num_dirty, rhs._num_dirty);
+        std::swap(_max_filled, rhs._max_filled);
+        std::swap(_mlf, rhs._mlf);
+    }
+
+    iterator begin() noexcept { return _pairs; }
+    iterator end() noexcept { return _pairs + _num_filled; }
+    const_iterator begin() const noexcept { return _pairs; }
+    const_iterator end() const noexcept { return _pairs + _num_filled; }
+    const_iterator cbegin() const noexcept { return _pairs; }
+    const_iterator cend() const noexcept { return _pairs + _num_filled; }
+
+    /// The pairs in insertion order until the first erase, as in emhash8.
+    value_type* values() const noexcept { return _pairs; }
+
+    size_type size() const noexcept { return _num_filled; }
+    bool empty() const noexcept { return _num_filled == 0; }
+    /// 2^27 groups hold it at any load factor, their positions g * GROUP + i stay below END
+    constexpr size_type max_size() const noexcept { return (size_type)1 << 28; }
+    size_type bucket_count() const noexcept { return (_group_mask + 1) * SLOTS; }
+    float load_factor() const noexcept { return (float)_num_filled / bucket_count(); }
+    float max_load_factor() const noexcept { return _mlf; }
+
+    HashT& hash_function() const { return _hasher; }
+    EqT& key_eq() const { return _eq; }
+
+    void max_load_factor(float mlf)
+    {
+        if (mlf < 0.999f && mlf > EMH_MIN_LOAD_FACTOR)
+            _mlf = mlf;
+    }
+
+    iterator find(const KeyT& key) noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        return pos == END ? end() : _pairs + slot_of(pos);
+    }
+
+    const_iterator find(const KeyT& key) const noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        return pos == END ? end() : _pairs + slot_of(pos);
+    }
+
+    bool contains(const KeyT& key) const noexcept { return find_pos(key, hash_key(key)) != END; }
+    size_type count(const KeyT& key) const noexcept { return contains(key) ? 1 : 0; }
+
+    ValueT& at(const KeyT& key)
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        if (pos == END)
+            throw std::out_of_range("at(): key not found");
+        return _pairs[slot_of(pos)].second;
+    }
+
+    const ValueT& at(const KeyT& key) const
+    {
+        return const_cast<GroupMap*>(this)->at(key);
+    }
+
+    ValueT* try_get(const KeyT& key) const noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        return pos == END ? nullptr : &_pairs[slot_of(pos)].second;
+    }
+
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        const auto hash = hash_key(key);
+        bool is_new;
+        const auto slot = find_or_allocate(key, hash, is_new);
+        if (is_new)
+            new(_pairs + slot) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+        return { _pairs + slot, is_new };
+    }
+
+    template<typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& val) { return try_emplace(std::forward<K>(key), std::forward<V>(val)); }
+
+    std::pair<iterator, bool> insert(const value_type& kv) { return try_emplace(kv.first, kv.second); }
+    std::pair<iterator, bool> insert(value_type&& kv) { return try_emplace(std::move(kv.first), std::move(kv.second)); }
+
+    template<typename Iter>
+    void insert(Iter first, Iter last)
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    template<typename K, typename V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& val)
+    {
+        auto result = try_emplace(std::forward<K>(key), std::forward<V>(val));
+        if (!result.second)
+            result.first->second = std::forward<V>(val);
+        return result;
+    }
+
+    ValueT& operator[](const KeyT& key) { return try_emplace(key).first->second; }
+    ValueT& operator[](KeyT&& key) { return try_emplace(std::move(key)).first->second; }
+
+    size_type erase(const KeyT& key) noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        if (pos == END)
+            return 0;
+        erase_pos(pos);
+        return 1;
+    }
+
+    /// The last pair moves into the erased one, so the returned iterator is cit itself.
+    iterator erase(const_iterator cit) noexcept
+    {
+        const auto slot = (size_type)(cit - _pairs);
+        erase_pos(find_slot_pos(hash_key(cit->first), slot));
+        return _pairs + slot;
+    }
+
+    template<typename Pred>
+    size_type erase_if(Pred pred)
+    {
+        const auto old_size = _num_filled;
+        for (auto it = begin(); it != end(); ) {
+            if (pred(*it))
+                it = erase(it);
+            else
+                ++it;
+        }
+        return old_size - _num_filled;
+    }
+
+    void clear() noexcept
+    {
+        clearkv();
+        clear_groups();
+    }
+
+    void shrink_to_fit(const float min_factor = EMH_DEFAULT_LOAD_FACTOR / 4)
+    {
+        if (load_factor() < min_factor)
+            rehash(_num_filled);
+    }
+
+    bool reserve(uint64_t num_elems)
+    {
+        if (num_elems <= _max_filled)
+            return false;
+        if (num_elems > max_size())
+            throw std::length_error("reserve(): more than max_size() elements");
+        rehash((size_type)num_elems);
+        return true;
+    }
+
+    /// Rebuilds the index for at least required elements, clearing every overflow byte.
+    void rehash(size_type required)
+    {
+        if (required < _num_filled)
+            required = _num_filled;
+        auto* old_pairs = _pairs;
+        auto* old_groups = _groups;
+        const auto num_filled = _num_filled;
+
+        rebuild(groups_for(required));
+        if (is_copy_trivially()) {
+            if (num_filled)
+                memcpy((void*)_pairs, (const void*)old_pairs, (size_t)num_filled * sizeof(value_type));
+        } else {
+            for (size_type i = 0; i < num_filled; i++) {
+                new(_pairs + i) value_type(std::move(old_pairs[i]));
+                old_pairs[i].~value_type();
+            }
+        }
+        free(old_pairs);
+        free_groups(old_groups);
+
+        for (size_type i = 0; i < num_filled; i++) {
+            const auto hash = hash_key(_pairs[i].first);
+            set_pos(find_free(hash), tag_of(hash), i);
+        }
+        _num_filled = num_filled;
+    }
+
+private:
+    static constexpr bool is_copy_trivially()
+    {
+        return std::is_trivially_copyable<KeyT>::value && std::is_trivially_copyable<ValueT>::value;
+    }
+
+    void clearkv()
+    {
+        if (!std::is_trivially_destructible<value_type>::value) {
+            for (size_type i = 0; i < _num_filled; i++)
+                _pairs[i].~value_type();
+        }
+        _num_filled = 0;
+    }
+
+    void clear_groups()
+    {
+        for (size_type g = 0; g <= _group_mask; g++) {
+            memset(_groups[g].ctrl, EMPTY, GROUP);
+            _groups[g].ctrl[GROUP - 1] = 0;
+        }
+        _num_dirty = 0;
+    }
+
+    //power of two groups that hold required elements under the load factor
+    size_type groups_for(size_type required) const
+    {
+        size_type num_groups = 1;
+        while ((uint64_t)((uint64_t)num_groups * SLOTS * _mlf) <= required)
+            num_groups *= 2;
+        return num_groups;
+    }
+
+    //allocates an empty index of num_groups and room for the pairs it may hold
+    void rebuild(size_type num_groups)
+    {
+        _group_mask = num_groups - 1;
+        _max_filled = (size_type)(num_groups * SLOTS * _mlf);
+        if (_max_filled >= num_groups * SLOTS)
+            _max_filled = num_groups * SLOTS - 1; //a free slot is left to end every insert probe
+        _num_filled = 0;
+
+        _pairs  = (value_type*)malloc((size_t)(_max_filled + 1) * sizeof(value_type));
+#if _WIN32
+        _groups = (Group*)_aligned_malloc((size_t)num_groups * sizeof(Group), alignof(Group));
+#else
+        _groups = (Group*)aligned_alloc(alignof(Group), (size_t)num_groups * sizeof(Group));
+#endif
+        clear_groups();
+    }
+
+    static void free_groups(Group* groups)
+    {
+#if _WIN32
+        _aligned_free(groups);
+#else
+        free(groups);
+#endif
+    }
+
+    /// Bit i is set if slot i of the group equals tag, the control bytes past the slots are masked off.
+    static uint32_t match_tag(const Group& group, int8_t tag)
+    {
+        constexpr uint32_t slot_mask = (1u << SLOTS) - 1;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)group.ctrl), _mm_set1_epi8(tag))) & slot_mask;
+#else
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < SLOTS; i++)
+            mask |= uint32_t(group.ctrl[i] == tag) << i;
+        return mask;
+#endif
+    }
+
+    static uint32_t match_empty(const Group& group) { return match_tag(group, EMPTY); }
+
+    uint64_t hash_key(const KeyT& key) const { return mix_hash((uint64_t)_hasher(key)); }
+
+    //the group comes from the low bits, the fingerprint and the overflow bit from the high ones
+    static int8_t tag_of(uint64_t hash) { return (int8_t)(hash >> 57); }
+    static int8_t overflow_of(uint64_t hash) { return (int8_t)(1 << ((hash >> 49) & 7)); }
+
+    //next group of the triangular probe, it visits every group of a power of two count once
+    size_type next_group(size_type group, size_type& step) const { return (group + ++step) & _group_mask; }
+
+    size_type slot_of(size_type pos) const { return _groups[pos / GROUP].slots[pos % GROUP]; }
+
+    void set_pos(size_type pos, int8_t tag, size_type slot)
+    {
+        _groups[pos / GROUP].ctrl[pos % GROUP]  = tag;
+        _groups[pos / GROUP].slots[pos % GROUP] = slot;
+    }
+
+    size_type find_pos(const KeyT& key, uint64_t hash) const
+    {
+        const auto tag = tag_of(hash), overflow = overflow_of(hash);
+        auto g = (size_type)hash & _group_mask;
+        for (size_type step = 0; step <= _group_mask; g = next_group(g, step)) {
+            const auto& group = _groups[g];
+            for (auto hit = match_tag(group, tag); hit; hit &= hit - 1) {
+                const auto i = CTZ(hit);
+                if (EMH_LIKELY(_eq(key, _pairs[group.slots[i]].first)))
+                    return g * GROUP + i;
+            }
+            if (EMH_LIKELY((group.ctrl[GROUP - 1] & overflow) == 0))
+                break;
+        }
+        return END;
+    }
+
+    //index position holding slot, the pair in the slot hashes to hash
+    size_type find_slot_pos(uint64_t hash, size_type slot) const
+    {
+        const auto tag = tag_of(hash);
+        auto g = (size_type)hash & _group_mask;
+        for (size_type step = 0; ; g = next_group(g, step)) {
+            const auto& group = _groups[g];
+            for (auto hit = match_tag(group, tag); hit; hit &= hit - 1) {
+                if (group.slots[CTZ(hit)] == slot)
+                    return g * GROUP + CTZ(hit);
+            }
+        }
+    }
+
+    //first free position on the probe of hash, the full groups passed get its overflow bit
+    size_type find_free(uint64_t hash, size_type g, size_type step)
+    {
+        for (; ; g = next_group(g, step)) {
+            auto& group = _groups[g];
+            const auto free = match_empty(group);
+            if (free)
+                return g * GROUP + CTZ(free);
+            group.ctrl[GROUP - 1] |= overflow_of(hash);
+        }
+    }
+
+    size_type find_free(uint64_t hash) { return find_free(hash, (size_type)hash & _group_mask, 0); }
+
+    //slot of key in _pairs, a new key gets the next slot and the caller constructs the pair
+    template<typename K>
+    size_type find_or_allocate(const K& key, uint64_t hash, bool& is_new)
+    {
+        const auto tag = tag_of(hash), overflow = overflow_of(hash);
+        auto g = (size_type)hash & _group_mask;
+        auto free_pos = END;
+        size_type step = 0;
+        for (; ; g = next_group(g, step)) {
+            const auto& group = _groups[g];
+            for (auto hit = match_tag(group, tag); hit; hit &= hit - 1) {
+                const auto i = CTZ(hit);
+                if (_eq(key, _pairs[group.slots[i]].first)) {
+                    is_new = false;
+                    return group.slots[i];
+                }
+            }
+            if (free_pos == END) {
+                const auto free = match_empty(group);
+                if (free)
+                    free_pos = g * GROUP + CTZ(free);
+            }
+            if (EMH_LIKELY((group.ctrl[GROUP - 1] & overflow) == 0))
+                break;
+        }
+
+        if (EMH_UNLIKELY(_num_filled + _num_dirty >= _max_filled)) {
+            rehash(_num_filled + 1);
+            free_pos = find_free(hash);
+        } else if (free_pos == END)
+            free_pos = find_free(hash, g, step);
+
+        is_new = true;
+        set_pos(free_pos, tag, _num_filled);
+        return _num_filled ++;
+    }
+
+    //probes may pass an erased slot of a group with overflow bits, they count until the next rehash
+    void erase_pos(size_type pos)
+    {
+        auto& group = _groups[pos / GROUP];
+        const auto slot = group.slots[pos % GROUP];
+        group.ctrl[pos % GROUP] = EMPTY;
+        if (group.ctrl[GROUP - 1])
+            _num_dirty ++;
+
+        const auto last = _num_filled - 1;
+        if (slot != last) {
+            const auto lpos = find_slot_pos(hash_key(_pairs[last].first), last);
+            _groups[lpos / GROUP].slots[lpos % GROUP] = slot;
+            if (is_copy_trivially())
+                memcpy((void*)(_pairs + slot), (const void*)(_pairs + last), sizeof(value_type));
+            else
+                _pairs[slot] = std::move(_pairs[last]);
+        }
+        _pairs[last].~value_type();
+        _num_filled --;
+    }
+
+    HashT      _hasher;
+    EqT        _eq;
+    value_type* _pairs  = nullptr;
+    Group*      _groups = nullptr;
+    size_type  _group_mask = 0;
+    size_type  _num_filled = 0;
+    size_type  _num_dirty  = 0;
+    size_type  _max_filled = 0;
+    float      _mlf = EMH_DEFAULT_LOAD_FACTOR;
+};
+} // namespace emhash8
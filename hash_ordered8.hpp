@@ -0,0 +1,639 @@
+// emhash8::OrderedMap for C++11, an insertion-ordered map with O(1) erase
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_ordered8.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+// emhash8 keeps its pairs dense and in insertion order until the first erase, which moves the last
+// pair into the hole. tsl::ordered_map keeps the order by shifting every later pair, an O(n) erase.
+// OrderedMap appends the pairs to _pairs as emhash8 does, but an erase only destroys the pair and
+// sets its bit in the _dead bitmap, iteration steps over the tombstones one bitmap word at a time.
+// Once more than EMH_MAX_TOMBSTONE of the used slots are tombstones, or the slots run out with at
+// least 1/8 of them dead, the live pairs slide down in order and each index entry takes its new slot
+// from a popcount rank of the bitmap, no key is hashed again. Both happen after as many erases as
+// the pairs moved, so erase stays amortized O(1). Erasing the last pair pops it with the tombstones
+// before it, and the first live slot is kept for begin(), so a FIFO window of pop_front() and
+// insert never scans its dead prefix.
+// The index is linear probing over {slot, 32-bit hash}, erase shifts the following entries back and
+// leaves no tombstone in the index either.
+
+#pragma once
+
+#include "hash_table8.hpp"
+
+namespace emhash8 {
+
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+class OrderedMap
+{
+#ifndef EMH_DEFAULT_LOAD_FACTOR
+    constexpr static float EMH_DEFAULT_LOAD_FACTOR = 0.60f; //linear probing, misses get long past it
+#endif
+    constexpr static float EMH_MIN_LOAD_FACTOR     = 0.25f;
+#ifndef EMH_MAX_TOMBSTONE
+    constexpr static float EMH_MAX_TOMBSTONE       = 0.50f; //compact once half of the used slots are dead
+#endif
+
+public:
+    using value_type     = std::pair<KeyT, ValueT>;
+    using key_type       = KeyT;
+    using mapped_type    = ValueT;
+    using size_type      = uint32_t;
+    using hasher         = HashT;
+    using key_equal      = EqT;
+
+    static constexpr size_type END = 0 - 1u;
+
+private:
+    struct Index
+    {
+        size_type slot; //slot in _pairs, END if the bucket is empty
+        uint32_t  hash; //low bits of the hash, its bucket and a filter before the key compare
+    };
+
+    template<bool IsConst>
+    class iter_t
+    {
+        using map_ptr = typename std::conditional<IsConst, const OrderedMap*, OrderedMap*>::type;
+        friend class OrderedMap;
+        template<bool> friend class iter_t;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = typename OrderedMap::value_type;
+        using pointer           = typename std::conditional<IsConst, const value_type*, value_type*>::type;
+        using reference         = typename std::conditional<IsConst, const value_type&, value_type&>::type;
+
+        iter_t() = default;
+        iter_t(map_ptr map, size_type slot) : _map(map), _slot(slot), _bits(map->live_bits(slot)) {}
+        template<bool C, typename = typename std::enable_if<IsConst && !C>::type>
+        iter_t(const iter_t<C>& it) : _map(it._map), _slot(it._slot), _bits(it._bits) {}
+
+        //steps within the cached bitmap word, the next word is read only when it runs out
+        iter_t& operator++()
+        {
+            _bits &= _bits - 1;
+            if (_bits)
+                _slot = (_slot & ~size_type(63)) + CTZ(_bits);
+            else {
+                _slot = _map->next_live((_slot | 63) + 1);
+                _bits = _map->live_bits(_slot);
+            }
+            return *this;
+        }
+
+        iter_t operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        reference operator*() const { return _map->_pairs[_slot]; }
+        pointer operator->() const { return _map->_pairs + _slot; }
+
+        template<bool C> bool operator==(const iter_t<C>& rhs) const { return _slot == rhs._slot; }
+        template<bool C> bool operator!=(const iter_t<C>& rhs) const { return _slot != rhs._slot; }
+
+    private:
+        map_ptr   _map  = nullptr;
+        size_type _slot = 0;
+        uint64_t  _bits = 0; //live slots of the word from _slot on
+    };
+
+public:
+    using iterator       = iter_t<false>;
+    using const_iterator = iter_t<true>;
+
+    OrderedMap(size_type bucket = 4, float mlf = EMH_DEFAULT_LOAD_FACTOR)
+    {
+        max_load_factor(mlf);
+        rehash(bucket);
+        relocate(bucket > 4 ? bucket : 4);
+    }
+
+    OrderedMap(const OrderedMap& rhs) : _hasher(rhs._hasher), _eq(rhs._eq), _mlf(rhs._mlf)
+    {
+        rehash(rhs._num_filled);
+        relocate(rhs._num_filled > 4 ? rhs._num_filled : 4);
+        for (const auto& kv : rhs)
+            insert(kv);
+    }
+
+    OrderedMap(OrderedMap&& rhs) noexcept : OrderedMap(0) { swap(rhs); }
+
+    OrderedMap(std::initializer_list<value_type> ilist) : OrderedMap((size_type)ilist.size())
+    {
+        for (const auto& kv : ilist)
+            insert(kv);
+    }
+
+    OrderedMap& operator=(const OrderedMap& rhs)
+    {
+        if (this != &rhs) {
+            OrderedMap tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    OrderedMap& operator=(OrderedMap&& rhs) noexcept
+    {
+        if (this != &rhs)
+            swap(rhs);
+        return *this;
+    }
+
+    ~OrderedMap()
+    {
+        clearkv();
+        free(_pairs);
+        free(_dead);
+        free(_index);
+    }
+
+    void swap(OrderedMap& rhs)
+    {
+        std::swap(_hasher, rhs._hasher);
+        std::swap(_eq, rhs._eq);
+        std::swap(_pairs, rhs._pairs);
+        std::swap(_dead, rhs._dead);
+        std::swap(_index, rhs._index);
+        std::swap(_mask, rhs._mask);
+        std::swap(_num_filled, rhs._num_filled);
+        std::swap(_num_slots, rhs._num_slots);
+        std::swap(_capacity, rhs._capacity);
+        std::swap(_head, rhs._head);
+        std::swap(_max_filled, rhs._max_filled);
+        std::swap(_mlf, rhs._mlf);
+    }
+
+    iterator begin() noexcept { return { this, _head }; }
+    iterator end() noexcept { return { this, _num_slots }; }
+    const_iterator begin() const noexcept { return { this, _head }; }
+    const_iterator end() const noexcept { return { this, _num_slots }; }
+    const_iterator cbegin() const noexcept { return { this, _head }; }
+    const_iterator cend() const noexcept { return { this, _num_slots }; }
+
+    /// The oldest and the newest pair, the last used slot is never a tombstone.
+    value_type& front() { return _pairs[_head]; }
+    const value_type& front() const { return _pairs[_head]; }
+    value_type& back() { return _pairs[_num_slots - 1]; }
+    const value_type& back() const { return _pairs[_num_slots - 1]; }
+
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(const_iterator(this, _num_slots - 1)); }
+
+    size_type size() const noexcept { return _num_filled; }
+    bool empty() const noexcept { return _num_filled == 0; }
+    size_type bucket_count() const noexcept { return _mask + 1; }
+    float load_factor() const noexcept { return (float)_num_filled / bucket_count(); }
+    float max_load_factor() const noexcept { return _mlf; }
+
+    /// Erased slots not reclaimed yet.
+    size_type tombstones() const noexcept { return _num_slots - _num_filled; }
+
+    const HashT& hash_function() const { return _hasher; }
+    const EqT& key_eq() const { return _eq; }
+
+    void max_load_factor(float mlf)
+    {
+        if (mlf < 0.999f && mlf > EMH_MIN_LOAD_FACTOR)
+            _mlf = mlf;
+    }
+
+    iterator find(const KeyT& key) noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        return { this, pos == END ? _num_slots : _index[pos].slot };
+    }
+
+    const_iterator find(const KeyT& key) const noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        return { this, pos == END ? _num_slots : _index[pos].slot };
+    }
+
+    bool contains(const KeyT& key) const noexcept { return find_pos(key, hash_key(key)) != END; }
+    size_type count(const KeyT& key) const noexcept { return contains(key) ? 1 : 0; }
+
+    ValueT& at(const KeyT& key)
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        if (pos == END)
+            throw std::out_of_range("at(): key not found");
+        return _pairs[_index[pos].slot].second;
+    }
+
+    const ValueT& at(const KeyT& key) const
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        if (pos == END)
+            throw std::out_of_range("at(): key not found");
+        return _pairs[_index[pos].slot].second;
+    }
+
+    ValueT* try_get(const KeyT& key) noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        return pos == END ? nullptr : &_pairs[_index[pos].slot].second;
+    }
+
+    const ValueT* try_get(const KeyT& key) const noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        return pos == END ? nullptr : &_pairs[_index[pos].slot].second;
+    }
+
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        bool is_new;
+        const auto slot = find_or_allocate(key, hash_key(key), is_new);
+        if (is_new)
+            new(_pairs + slot) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+        return { { this, slot }, is_new };
+    }
+
+    template<typename K, typename V>
+    std::pair<iterator, bool> emplace(K&& key, V&& val) { return try_emplace(std::forward<K>(key), std::forward<V>(val)); }
+
+    std::pair<iterator, bool> insert(const value_type& kv) { return try_emplace(kv.first, kv.second); }
+    std::pair<iterator, bool> insert(value_type&& kv) { return try_emplace(std::move(kv.first), std::move(kv.second)); }
+
+    template<typename Iter>
+    void insert(Iter first, Iter last)
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    /// An existing key keeps its place in the order.
+    template<typename K, typename V>
+    std::pair<iterator, bool> insert_or_assign(K&& key, V&& val)
+    {
+        auto result = try_emplace(std::forward<K>(key), std::forward<V>(val));
+        if (!result.second)
+            result.first->second = std::forward<V>(val);
+        return result;
+    }
+
+    ValueT& operator[](const KeyT& key) { return try_emplace(key).first->second; }
+    ValueT& operator[](KeyT&& key) { return try_emplace(std::move(key)).first->second; }
+
+    size_type erase(const KeyT& key) noexcept
+    {
+        const auto pos = find_pos(key, hash_key(key));
+        if (pos == END)
+            return 0;
+        const auto slot = _index[pos].slot;
+        erase_pos(pos);
+        erase_slot(slot);
+        return 1;
+    }
+
+    /// Returns the pair after cit in insertion order. Any erase may compact the pairs, so it
+    /// invalidates every other iterator.
+    iterator erase(const_iterator cit) noexcept
+    {
+        const auto slot = cit._slot;
+        erase_pos(find_slot_pos((uint32_t)hash_key(_pairs[slot].first), slot));
+        return { this, erase_slot(slot) };
+    }
+
+    /// One pass that tombstones every match, then at most one compaction.
+    template<typename Pred>
+    size_type erase_if(Pred pred)
+    {
+        const auto old_size = _num_filled;
+        for (auto slot = _head; slot < _num_slots; slot = next_live(slot + 1)) {
+            if (!pred(_pairs[slot]))
+                continue;
+            erase_pos(find_slot_pos((uint32_t)hash_key(_pairs[slot].first), slot));
+            _pairs[slot].~value_type();
+            set_dead(slot);
+            _num_filled --;
+        }
+        trim();
+        if (tombstones() > _num_slots * EMH_MAX_TOMBSTONE)
+            relocate(_capacity);
+        return old_size - _num_filled;
+    }
+
+    void clear() noexcept
+    {
+        clearkv();
+        memset((void*)_index, 0xFF, sizeof(Index) * (_mask + 1));
+    }
+
+    /// Slides the live pairs over every tombstone now.
+    void compact()
+    {
+        if (_num_slots != _num_filled)
+            relocate(_capacity);
+    }
+
+    void shrink_to_fit(const float min_factor = EMH_DEFAULT_LOAD_FACTOR / 4)
+    {
+        if (load_factor() < min_factor)
+            rehash(_num_filled);
+        relocate(_num_filled > 4 ? _num_filled : 4);
+    }
+
+    bool reserve(uint64_t num_elems)
+    {
+        if (num_elems > _capacity)
+            relocate((size_type)num_elems);
+        if (num_elems <= _max_filled)
+            return false;
+        rehash((size_type)num_elems);
+        return true;
+    }
+
+    /// Rebuilds the index for at least required elements from the stored hashes.
+    void rehash(size_type required)
+    {
+        if (required < _num_filled)
+            required = _num_filled;
+        size_type buckets = 4;
+        while ((uint64_t)(buckets * _mlf) <= required)
+            buckets *= 2;
+
+        auto* old_index = _index;
+        const auto old_mask = _mask;
+        _index = (Index*)malloc(sizeof(Index) * buckets);
+        memset((void*)_index, 0xFF, sizeof(Index) * buckets);
+        _mask = buckets - 1;
+        _max_filled = (size_type)(buckets * _mlf);
+        if (_max_filled >= buckets)
+            _max_filled = buckets - 1; //an empty bucket is left to end every probe
+
+        if (old_index) {
+            for (size_type pos = 0; pos <= old_mask; pos++) {
+                if (old_index[pos].slot != END)
+                    _index[find_free(old_index[pos].hash)] = old_index[pos];
+            }
+            free(old_index);
+        }
+    }
+
+private:
+    static constexpr bool is_copy_trivially()
+    {
+        return std::is_trivially_copyable<KeyT>::value && std::is_trivially_copyable<ValueT>::value;
+    }
+
+    static size_type dead_words(size_type slots) { return (slots + 63) / 64; }
+
+    bool is_dead(size_type slot) const { return (_dead[slot / 64] >> (slot % 64)) & 1; }
+    void set_dead(size_type slot) { _dead[slot / 64] |= uint64_t(1) << (slot % 64); }
+    void clear_dead(size_type slot) { _dead[slot / 64] &= ~(uint64_t(1) << (slot % 64)); }
+
+    //first live slot from slot on, _num_slots if there is none
+    size_type next_live(size_type slot) const
+    {
+        while (slot < _num_slots) {
+            const auto live = ~_dead[slot / 64] >> (slot % 64);
+            if (live) {
+                slot += CTZ(live);
+                return slot < _num_slots ? slot : _num_slots;
+            }
+            slot = (slot | 63) + 1;
+        }
+        return _num_slots;
+    }
+
+    //live slots of the word holding slot, from slot on and before _num_slots
+    uint64_t live_bits(size_type slot) const
+    {
+        if (slot >= _num_slots)
+            return 0;
+        auto bits = ~_dead[slot / 64] & (~uint64_t(0) << (slot % 64));
+        if (slot / 64 == (_num_slots - 1) / 64 && _num_slots % 64)
+            bits &= (uint64_t(1) << (_num_slots % 64)) - 1;
+        return bits;
+    }
+
+    //tombstones in [0, slot)
+    size_type dead_before(size_type slot) const
+    {
+        size_type dead = 0;
+        for (size_type w = 0; w < slot / 64; w++)
+            dead += POPCOUNT(_dead[w]);
+        if (slot % 64)
+            dead += POPCOUNT(_dead[slot / 64] & ((uint64_t(1) << (slot % 64)) - 1));
+        return dead;
+    }
+
+    void clearkv()
+    {
+        if (!std::is_trivially_destructible<value_type>::value) {
+            for (auto slot = _head; slot < _num_slots; slot = next_live(slot + 1))
+                _pairs[slot].~value_type();
+        }
+        memset(_dead, 0, sizeof(uint64_t) * dead_words(_num_slots));
+        _num_filled = _num_slots = _head = 0;
+    }
+
+    /// Moves the live pairs in order to the front of a buffer of capacity slots, the current one
+    /// if capacity is unchanged. Each index entry drops the tombstones before its slot.
+    void relocate(size_type capacity)
+    {
+        const auto words = dead_words(_num_slots);
+        if (_num_slots != _num_filled) {
+            auto* rank = (size_type*)malloc(sizeof(size_type) * (words + 1));
+            size_type dead = 0;
+            for (size_type w = 0; w < words; w++) {
+                rank[w] = dead;
+                dead += POPCOUNT(_dead[w]);
+            }
+            for (size_type pos = 0; pos <= _mask; pos++) {
+                const auto slot = _index[pos].slot;
+                if (slot != END)
+                    _index[pos].slot = slot - rank[slot / 64] - POPCOUNT(_dead[slot / 64] & ((uint64_t(1) << (slot % 64)) - 1));
+            }
+            free(rank);
+        }
+
+        const bool in_place = capacity == _capacity;
+        auto* pairs = in_place ? _pairs : (value_type*)malloc(sizeof(value_type) * capacity);
+        if (!in_place && is_copy_trivially() && _num_slots == _num_filled) {
+            if (_num_filled)
+                memcpy((void*)pairs, (const void*)_pairs, sizeof(value_type) * _num_filled);
+        } else {
+            size_type dst = 0;
+            for (auto slot = _head; slot < _num_slots; slot = next_live(slot + 1), dst++) {
+                if (in_place && dst == slot)
+                    continue;
+                if (is_copy_trivially())
+                    memcpy((void*)(pairs + dst), (const void*)(_pairs + slot), sizeof(value_type));
+                else {
+                    new(pairs + dst) value_type(std::move(_pairs[slot]));
+                    _pairs[slot].~value_type();
+                }
+            }
+        }
+
+        if (in_place)
+            memset(_dead, 0, sizeof(uint64_t) * words);
+        else {
+            free(_pairs);
+            free(_dead);
+            _pairs = pairs;
+            _dead = (uint64_t*)calloc(dead_words(capacity), sizeof(uint64_t));
+            _capacity = capacity;
+        }
+        _num_slots = _num_filled;
+        _head = 0;
+    }
+
+    //full slots compact in place if that frees 1/8 of them, else they double and lose the tombstones on the way
+    void grow_slots()
+    {
+        const auto dead = tombstones();
+        if (dead > 0 && dead >= _capacity / 8)
+            relocate(_capacity);
+        else
+            relocate(_capacity < 4 ? 4 : _capacity * 2);
+    }
+
+    //pops the tombstones ending the slots and moves _head to the first live slot
+    void trim()
+    {
+        if (_num_filled == 0) {
+            memset(_dead, 0, sizeof(uint64_t) * dead_words(_num_slots));
+            _num_slots = _head = 0;
+            return;
+        }
+        while (is_dead(_num_slots - 1))
+            clear_dead(-- _num_slots);
+        if (is_dead(_head))
+            _head = next_live(_head + 1);
+    }
+
+    //destroys the pair in slot whose index entry is already gone, returns the slot now after it
+    size_type erase_slot(size_type slot)
+    {
+        _pairs[slot].~value_type();
+        _num_filled --;
+        set_dead(slot);
+        trim();
+        if (slot >= _num_slots)
+            return _num_slots;
+
+        auto next = next_live(slot + 1);
+        if (EMH_UNLIKELY(tombstones() > _num_slots * EMH_MAX_TOMBSTONE)) {
+            next -= dead_before(next);
+            relocate(_capacity);
+        }
+        return next;
+    }
+
+    uint64_t hash_key(const KeyT& key) const { return mix_hash((uint64_t)_hasher(key)); }
+
+    size_type find_pos(const KeyT& key, uint64_t hash) const
+    {
+        const auto hash32 = (uint32_t)hash;
+        for (auto pos = hash32 & _mask; ; pos = (pos + 1) & _mask) {
+            const auto& entry = _index[pos];
+            if (entry.slot == END)
+                return END;
+            if (entry.hash == hash32 && _eq(key, _pairs[entry.slot].first))
+                return pos;
+        }
+    }
+
+    //index position holding slot, the pair in the slot hashes to hash32
+    size_type find_slot_pos(uint32_t hash32, size_type slot) const
+    {
+        auto pos = hash32 & _mask;
+        while (_index[pos].slot != slot)
+            pos = (pos + 1) & _mask;
+        return pos;
+    }
+
+    size_type find_free(uint32_t hash32) const
+    {
+        auto pos = hash32 & _mask;
+        while (_index[pos].slot != END)
+            pos = (pos + 1) & _mask;
+        return pos;
+    }
+
+    //slot of key in _pairs, a new key is appended and the caller constructs the pair
+    template<typename K>
+    size_type find_or_allocate(const K& key, uint64_t hash, bool& is_new)
+    {
+        const auto hash32 = (uint32_t)hash;
+        auto pos = hash32 & _mask;
+        for (; _index[pos].slot != END; pos = (pos + 1) & _mask) {
+            const auto slot = _index[pos].slot;
+            if (_index[pos].hash == hash32 && _eq(key, _pairs[slot].first)) {
+                is_new = false;
+                return slot;
+            }
+        }
+
+        if (EMH_UNLIKELY(_num_filled >= _max_filled)) {
+            rehash(_num_filled + 1);
+            pos = find_free(hash32);
+        }
+        if (EMH_UNLIKELY(_num_slots == _capacity))
+            grow_slots();
+
+        is_new = true;
+        _index[pos] = { _num_slots, hash32 };
+        _num_filled ++;
+        return _num_slots ++;
+    }
+
+    //empties pos and shifts back the entries of the run after it that may live there
+    void erase_pos(size_type pos)
+    {
+        auto hole = pos;
+        for (auto next = (pos + 1) & _mask; _index[next].slot != END; next = (next + 1) & _mask) {
+            const auto home = _index[next].hash & _mask;
+            if (((next - home) & _mask) >= ((next - hole) & _mask)) {
+                _index[hole] = _index[next];
+                hole = next;
+            }
+        }
+        _index[hole].slot = END;
+    }
+
+    HashT      _hasher;
+    EqT        _eq;
+    value_type* _pairs = nullptr;
+    uint64_t*  _dead   = nullptr; //bit per slot, set for an erased pair
+    Index*     _index  = nullptr;
+    size_type  _mask   = 0;
+    size_type  _num_filled = 0; //live pairs
+    size_type  _num_slots  = 0; //used slots, live pairs and tombstones
+    size_type  _capacity   = 0;
+    size_type  _head       = 0; //first live slot, every slot before it is a tombstone
+    size_type  _max_filled = 0;
+    float      _mlf = EMH_DEFAULT_LOAD_FACTOR;
+};
+} // namespace emhash8
@@ -0,0 +1,391 @@
+// emhash8::SegmentMap for C++14/17, extendible hashing over emhash8::HashMap
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_segment8.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+// A monolithic map holds the old and the new table during rehash, a 20 GB map needs 40+ GB
+// for a moment. SegmentMap splits the key space by the top bits of a mixed hash into emhash8
+// sub maps (segments) found through a directory. A full segment is split in two instead of
+// doubling its table, so growing never holds more than one segment twice.
+
+#pragma once
+
+#include <vector>
+#include "hash_table8.hpp"
+
+namespace emhash8 {
+
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+class SegmentMap
+{
+public:
+    using table_type  = HashMap<KeyT, ValueT, HashT, EqT>;
+    using value_type  = typename table_type::value_type;
+    using key_type    = KeyT;
+    using mapped_type = ValueT;
+    using size_type   = size_t;
+
+private:
+    struct Segment
+    {
+        table_type table;
+        uint32_t   depth; //local depth, the segment owns 1 << (_depth - depth) directory slots
+        size_type  limit; //size at which the next split is tried
+    };
+
+public:
+    class const_iterator;
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = typename SegmentMap::value_type;
+        using pointer           = value_type*;
+        using reference         = value_type&;
+
+        iterator() : map_(nullptr), seg_(0) {}
+        iterator(SegmentMap* map, size_type seg, typename table_type::iterator it) : map_(map), seg_(seg), it_(it) { skip(); }
+
+        iterator& operator++()
+        {
+            ++it_;
+            skip();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto cur = *this; ++(*this);
+            return cur;
+        }
+
+        reference operator*() const { return *it_; }
+        pointer operator->() const { return &*it_; }
+
+        bool operator == (const iterator& rhs) const { return seg_ == rhs.seg_ && it_ == rhs.it_; }
+        bool operator != (const iterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        void skip()
+        {
+            while (seg_ < map_->_segments.size() && it_ == map_->_segments[seg_].table.end()) {
+                if (++seg_ < map_->_segments.size())
+                    it_ = map_->_segments[seg_].table.begin();
+                else
+                    it_ = typename table_type::iterator();
+            }
+        }
+
+        friend class const_iterator;
+        SegmentMap* map_;
+        size_type   seg_;
+        typename table_type::iterator it_;
+    };
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = typename SegmentMap::value_type;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        const_iterator() : map_(nullptr), seg_(0), it_(typename table_type::iterator()) {}
+        const_iterator(const iterator& it) : map_(it.map_), seg_(it.seg_), it_(it.it_) {}
+        const_iterator(const SegmentMap* map, size_type seg, typename table_type::const_iterator it) : map_(map), seg_(seg), it_(it) { skip(); }
+
+        const_iterator& operator++()
+        {
+            ++it_;
+            skip();
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto cur = *this; ++(*this);
+            return cur;
+        }
+
+        reference operator*() const { return *it_; }
+        pointer operator->() const { return &*it_; }
+
+        bool operator == (const const_iterator& rhs) const { return seg_ == rhs.seg_ && it_ == rhs.it_; }
+        bool operator != (const const_iterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        void skip()
+        {
+            while (seg_ < map_->_segments.size() && it_ == map_->_segments[seg_].table.cend()) {
+                if (++seg_ < map_->_segments.size())
+                    it_ = map_->_segments[seg_].table.cbegin();
+                else
+                    it_ = typename table_type::const_iterator(typename table_type::iterator());
+            }
+        }
+
+        const SegmentMap* map_;
+        size_type   seg_;
+        typename table_type::const_iterator it_;
+    };
+
+    /// A segment splits instead of growing past the table holding segment_size elements,
+    /// which bounds the extra memory of a growth step to about one segment. A segment whose
+    /// keys all fall into one half (equal hashes) grows like a plain emhash8 map instead.
+    explicit SegmentMap(size_type segment_size = 1 << 20)
+    {
+        //split right before the sub map would rehash, so both halves start at half load
+        const auto mlf = table_type().max_load_factor();
+        size_type buckets = 16;
+        while (buckets * mlf < segment_size) buckets *= 2;
+        _segment_size = (size_type)((buckets - 2) * mlf);
+        clear();
+    }
+
+    iterator begin() { return {this, 0, _segments[0].table.begin()}; }
+    iterator end() { return {this, _segments.size(), typename table_type::iterator()}; }
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end() const { return cend(); }
+    const_iterator cbegin() const { return {this, 0, _segments[0].table.cbegin()}; }
+    const_iterator cend() const { return {this, _segments.size(), typename table_type::const_iterator(typename table_type::iterator())}; }
+
+    size_type size() const { return _num_filled; }
+    bool empty() const { return _num_filled == 0; }
+    size_type segment_count() const { return _segments.size(); }
+    uint32_t depth() const { return _depth; }
+
+    size_type bucket_count() const
+    {
+        size_type buckets = 0;
+        for (const auto& seg : _segments)
+            buckets += seg.table.bucket_count();
+        return buckets;
+    }
+
+    /// Sum of the segment stats, the ratios are weighted by segment size
+    HashStats stats(float sample_ratio = 1.0f) const
+    {
+        HashStats st = {};
+        for (const auto& seg : _segments) {
+            const auto ss = seg.table.stats(sample_ratio);
+            st.size    += ss.size;
+            st.buckets += ss.buckets;
+            st.bytes   += ss.bytes;
+            st.sampled += ss.sampled;
+            for (size_t i = 0; i < sizeof(st.chains) / sizeof(st.chains[0]); i++)
+                st.chains[i] += ss.chains[i];
+            st.main_ratio += ss.main_ratio * ss.size;
+            st.hit_lines  += ss.hit_lines * ss.size;
+            st.miss_lines += ss.miss_lines * ss.size;
+        }
+
+        st.bytes += _dir.capacity() * sizeof(_dir[0]) + _segments.capacity() * sizeof(Segment);
+        if (st.size > 0) {
+            st.load_factor = (float)st.size / st.buckets;
+            st.main_ratio /= st.size;
+            st.hit_lines  /= st.size;
+            st.miss_lines /= st.size;
+        }
+        return st;
+    }
+
+    iterator find(const KeyT& key)
+    {
+        const auto seg = segment_of(key);
+        const auto it = _segments[seg].table.find(key);
+        return it == _segments[seg].table.end() ? end() : iterator(this, seg, it);
+    }
+
+    const_iterator find(const KeyT& key) const
+    {
+        const auto seg = segment_of(key);
+        const auto it = _segments[seg].table.find(key);
+        return it == _segments[seg].table.cend() ? cend() : const_iterator(this, seg, it);
+    }
+
+    bool contains(const KeyT& key) const { return _segments[segment_of(key)].table.contains(key); }
+    size_type count(const KeyT& key) const { return _segments[segment_of(key)].table.count(key); }
+
+    ValueT& at(const KeyT& key) { return _segments[segment_of(key)].table.at(key); }
+    const ValueT& at(const KeyT& key) const { return _segments[segment_of(key)].table.at(key); }
+
+    ValueT* try_get(const KeyT& key) { return _segments[segment_of(key)].table.try_get(key); }
+    const ValueT* try_get(const KeyT& key) const { return _segments[segment_of(key)].table.try_get(key); }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value.first), std::move(value.second)); }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace(K&& key, Args&&... args)
+    {
+        const auto seg = grow_segment(key);
+        const auto result = _segments[seg].table.emplace(std::forward<K>(key), std::forward<Args>(args)...);
+        _num_filled += result.second;
+        return {iterator(this, seg, result.first), result.second};
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        const auto seg = grow_segment(key);
+        const auto result = _segments[seg].table.try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+        _num_filled += result.second;
+        return {iterator(this, seg, result.first), result.second};
+    }
+
+    template <typename K>
+    std::pair<iterator, bool> insert_or_assign(K&& key, ValueT&& val)
+    {
+        const auto seg = grow_segment(key);
+        const auto result = _segments[seg].table.insert_or_assign(std::forward<K>(key), std::move(val));
+        _num_filled += result.second;
+        return {iterator(this, seg, result.first), result.second};
+    }
+
+    ValueT& operator[](const KeyT& key)
+    {
+        auto& table = _segments[grow_segment(key)].table;
+        const auto old_size = table.size();
+        auto& val = table[key];
+        _num_filled += table.size() - old_size;
+        return val;
+    }
+
+    size_type erase(const KeyT& key)
+    {
+        const auto erased = _segments[segment_of(key)].table.erase(key);
+        _num_filled -= erased;
+        return erased;
+    }
+
+    void clear()
+    {
+        _segments.clear();
+        _segments.push_back({table_type(), 0, _segment_size});
+        _dir.assign(1, 0);
+        _depth = 0;
+        _num_filled = 0;
+    }
+
+    void swap(SegmentMap& rhs)
+    {
+        std::swap(_segments, rhs._segments);
+        std::swap(_dir, rhs._dir);
+        std::swap(_depth, rhs._depth);
+        std::swap(_num_filled, rhs._num_filled);
+        std::swap(_segment_size, rhs._segment_size);
+    }
+
+private:
+    //the sub maps index with the low bits of HashT, the directory uses the top bits of a mixed copy
+    uint64_t dir_hash(const KeyT& key) const
+    {
+        return (uint64_t)_hasher(key) * 0x9E3779B97F4A7C15ull;
+    }
+
+    size_type segment_of(const KeyT& key) const
+    {
+        return _depth == 0 ? 0 : _dir[dir_hash(key) >> (64 - _depth)];
+    }
+
+    //the directory may use a few bits more than the segment count needs, keys sharing a long
+    //hash prefix grow their segment past segment_size instead of doubling the directory
+    uint32_t max_depth() const
+    {
+        uint32_t depth = 6;
+        for (auto segs = _num_filled / _segment_size; segs > 0; segs /= 2) depth ++;
+        return depth < 32 ? depth : 32;
+    }
+
+    //split the segment of key until it has room for one more element
+    size_type grow_segment(const KeyT& key)
+    {
+        const auto hash = dir_hash(key);
+        auto seg = segment_of(key);
+        while (EMH_UNLIKELY(_segments[seg].table.size() >= _segments[seg].limit)) {
+            if (_segments[seg].depth >= max_depth() || !split(seg, hash)) {
+                //not separable now, try again once the segment has doubled
+                _segments[seg].limit = _segments[seg].table.size() * 2;
+                break;
+            }
+            seg = segment_of(key);
+        }
+        return seg;
+    }
+
+    //hash is the dir_hash of a key in seg, false if all keys of seg fall into one half
+    bool split(const size_type seg, const uint64_t hash)
+    {
+        const auto depth = _segments[seg].depth;
+        const auto bit = 63 - depth;
+        size_type upper = 0;
+        for (const auto& kv : _segments[seg].table)
+            upper += (dir_hash(kv.first) >> bit) & 1;
+        if (upper == 0 || upper == _segments[seg].table.size())
+            return false;
+
+        if (depth == _depth) {
+            //double the directory, slot i of the new one covers the hashes of slot i / 2
+            std::vector<uint32_t> dir(_dir.size() * 2);
+            for (size_t i = 0; i < dir.size(); i++)
+                dir[i] = _dir[i / 2];
+            _dir.swap(dir);
+            _depth ++;
+        }
+
+        //the slots of seg are contiguous and start at its hash prefix, the upper half now points to the new segment
+        const auto sibling = (uint32_t)_segments.size();
+        const size_t span  = (size_t)1 << (_depth - depth);
+        const size_t first = depth == 0 ? 0 : (size_t)(hash >> (64 - depth)) << (_depth - depth);
+        assert(_dir[first] == seg && _dir[first + span - 1] == seg);
+        for (size_t i = first + span / 2; i < first + span; i++)
+            _dir[i] = sibling;
+
+        //both halves are rebuilt like a rehash of this one segment
+        _segments.push_back({table_type(), depth + 1, _segment_size});
+        auto& table = _segments[seg].table;
+        table_type left;
+        left.reserve(table.size() - upper);
+        _segments[sibling].table.reserve(upper);
+
+        for (auto& kv : table) {
+            auto& half = (dir_hash(kv.first) >> bit) & 1 ? _segments[sibling].table : left;
+            half.insert_unique(std::move(kv.first), std::move(kv.second));
+        }
+        table = std::move(left);
+        _segments[seg].depth = depth + 1;
+        _segments[seg].limit = _segment_size;
+        return true;
+    }
+
+    std::vector<Segment>  _segments;
+    std::vector<uint32_t> _dir;
+    HashT     _hasher;
+    uint32_t  _depth;
+    size_type _num_filled;
+    size_type _segment_size;
+};
+} // namespace emhash8
@@ -49,6 +49,9 @@
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
 
 #ifdef __has_include
     #if __has_include("wyhash.h")
@@ -62,6 +65,13 @@
     #undef EMH_ENTRY
 #endif
 
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 // likely/unlikely
 #if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
 #    define EMH_LIKELY(condition) __builtin_expect(condition, 1)
@@ -76,8 +86,34 @@
 
 namespace emhash2 {
 
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the wyhash path, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
 /// A cache-friendly hash table with open addressing, linear probing and power-of-two capacity
-template <typename KeyT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
 class HashSet
 {
 public:
@@ -227,6 +263,16 @@ public:
         size_type  _bucket;
     };
 
+    /// Enables erase(K) when both HashT and EqT are transparent.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     // ------------------------------------------------------------------------
 
     void init(size_type bucket, float lf)
@@ -684,24 +730,28 @@ public:
 
     // ------------------------------------------------------------
 
-    iterator find(const KeyT& key)
+    template<typename K=KeyT>
+    iterator find(const K& key)
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<K>>(key))};
     }
 
-    const_iterator find(const KeyT& key) const
+    template<typename K=KeyT>
+    const_iterator find(const K& key) const
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<K>>(key))};
     }
 
-    bool contains(const KeyT& key) const
+    template<typename K=KeyT>
+    bool contains(const K& key) const
     {
-        return find_filled_bucket(key) != _num_buckets;
+        return find_filled_bucket(static_cast<key_arg<K>>(key)) != _num_buckets;
     }
 
-    size_type count(const KeyT& key) const
+    template<typename K=KeyT>
+    size_type count(const K& key) const
     {
-        return find_filled_bucket(key) == _num_buckets ? 0 : 1;
+        return find_filled_bucket(static_cast<key_arg<K>>(key)) == _num_buckets ? 0 : 1;
     }
 
     /// Returns a pair consisting of an iterator to the inserted element
@@ -895,6 +945,17 @@ public:
         return 1;
     }
 
+    template<typename K, if_transparent<K> = 0>
+    size_type erase(const K& key)
+    {
+        const auto bucket = erase_key(static_cast<key_arg<K>>(key));
+        if (bucket == INACTIVE)
+            return 0;
+
+        clear_bucket(bucket);
+        return 1;
+    }
+
     iterator erase(const_iterator cit)
     {
         iterator it(this, cit._bucket);
@@ -1042,7 +1103,8 @@ private:
         return reserve(_num_filled);
     }
 
-    size_type erase_key(const KeyT& key)
+    template<typename K>
+    size_type erase_key(const K& key)
     {
         const auto bucket = hash_bucket(key);
         auto next_bucket = _pairs[bucket].second;
@@ -1111,7 +1173,8 @@ private:
     }
 
     // Find the bucket with this key, or return bucket size
-    size_type find_filled_bucket(const KeyT& key) const
+    template<typename K>
+    size_type find_filled_bucket(const K& key) const
     {
         const auto bucket = hash_bucket(key);
         auto next_bucket = _pairs[bucket].second;
@@ -1339,7 +1402,7 @@ private:
 #endif
     }
 
-    template<typename UType, typename std::enable_if<std::is_same<UType, std::string>::value, size_type>::type = 0>
+    template<typename UType, typename std::enable_if<is_string<UType>::value, size_type>::type = 0>
     inline size_type hash_bucket(const UType& key) const
     {
 #ifdef WYHASH_LITTLE_ENDIAN
@@ -1349,7 +1412,7 @@ private:
 #endif
     }
 
-    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !std::is_same<UType, std::string>::value, size_type>::type = 0>
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !is_string<UType>::value, size_type>::type = 0>
     inline size_type hash_bucket(const UType& key) const
     {
 #ifdef EMH_INT_HASH
@@ -48,6 +48,9 @@
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
 
 #ifdef  EMH_KEY
     #undef  EMH_BUCKET
@@ -55,6 +58,13 @@
     #undef  NEW_KEY
 #endif
 
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 // likely/unlikely
 #if (__GNUC__ >= 4 || __clang__)
 #    define EMH_LIKELY(condition)   __builtin_expect(condition, 1)
@@ -87,8 +97,37 @@
 #define EMH_BUCKET(p,n)   p[n].second
 
 namespace emhash7 {
+#ifndef EMH7_KEY_TRAITS //shared with hash_table7.hpp
+#define EMH7_KEY_TRAITS
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the EMH_WY_HASH path, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+#endif
+
 /// A cache-friendly hash table with open addressing, linear probing and power-of-two capacity
-template <typename KeyT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
 class HashSet
 {
     constexpr static uint32_t INACTIVE = 0xFFFFFFFF;
@@ -231,6 +270,16 @@ public:
         uint32_t  _bucket;
     };
 
+    /// Enables erase(K) when both HashT and EqT are transparent.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     // ------------------------------------------------------------------------
 
     void init()
@@ -552,24 +601,28 @@ public:
 
     // ------------------------------------------------------------
 
-    iterator find(const KeyT& key)
+    template<typename K=KeyT>
+    iterator find(const K& key)
     {
-        return {this, find_colls_bucket(key)};
+        return {this, find_colls_bucket(static_cast<key_arg<K>>(key))};
     }
 
-    const_iterator find(const KeyT& key) const
+    template<typename K=KeyT>
+    const_iterator find(const K& key) const
     {
-        return {this, find_colls_bucket(key)};
+        return {this, find_colls_bucket(static_cast<key_arg<K>>(key))};
     }
 
-    bool contains(const KeyT& key) const
+    template<typename K=KeyT>
+    bool contains(const K& key) const
     {
-        return find_colls_bucket(key) != _total_buckets;
+        return find_colls_bucket(static_cast<key_arg<K>>(key)) != _total_buckets;
     }
 
-    size_type count(const KeyT& key) const
+    template<typename K=KeyT>
+    size_type count(const K& key) const
     {
-        return find_colls_bucket(key) == _total_buckets ? 0 : 1;
+        return find_colls_bucket(static_cast<key_arg<K>>(key)) == _total_buckets ? 0 : 1;
     }
 
     /// Returns a pair consisting of an iterator to the inserted element
@@ -586,7 +639,7 @@ public:
             if (bucket_size == INACTIVE) {
                 new_key(key, main_bucket, main_bucket);
                 return { {this, main_bucket}, true };
-            } else if (_eq(key, EMH_KEY(_pairs, main_bucket)) && bucket_size % 2 > 0) {
+            } else if (bucket_size % 2 > 0 && _eq(key, EMH_KEY(_pairs, main_bucket))) {
                 return { {this, main_bucket}, false };
             } else if (bucket_size % 2 == 0) {
                 auto next_bucket = find_colls_bucket(key);
@@ -624,7 +677,8 @@ public:
         }
     }
 
-    void del_key(uint32_t bucket, const KeyT& key)
+    template<typename K>
+    void del_key(uint32_t bucket, const K& key)
     {
         const auto main_bucket = hash_main_bucket(key);
         auto& bucket_size = EMH_BUCKET(_pairs, main_bucket);
@@ -781,24 +835,13 @@ public:
     /// Erase an element from the hash table.
     size_type erase(const KeyT& key)
     {
-        const auto main_bucket = hash_main_bucket(key);
-        auto& bucket_size = EMH_BUCKET(_pairs, main_bucket);
-        if (bucket_size == INACTIVE)
-            return 0;
-
-        const auto& bucket_key = EMH_KEY(_pairs, main_bucket);
-        if (_eq(key, bucket_key) && bucket_size % 2 > 0) {
-            del_main(main_bucket, bucket_size);
-            return 1;
-        } else if (bucket_size <= 1)
-            return 0;
-
-        const auto bucket = erase_key(key);
-        if (bucket == INACTIVE)
-            return 0;
+        return do_erase(key);
+    }
 
-        del_key(bucket, key);
-        return 1;
+    template<typename K, if_transparent<K> = 0>
+    size_type erase(const K& key)
+    {
+        return do_erase(static_cast<key_arg<K>>(key));
     }
 
     iterator erase(const_iterator cit)
@@ -995,7 +1038,31 @@ private:
         return reserve(_num_colls);
     }
 
-    uint32_t erase_key(const KeyT& key)
+    template<typename K>
+    size_type do_erase(const K& key)
+    {
+        const auto main_bucket = hash_main_bucket(key);
+        auto& bucket_size = EMH_BUCKET(_pairs, main_bucket);
+        if (bucket_size == INACTIVE)
+            return 0;
+
+        const auto& bucket_key = EMH_KEY(_pairs, main_bucket);
+        if (bucket_size % 2 > 0 && _eq(key, bucket_key)) {
+            del_main(main_bucket, bucket_size);
+            return 1;
+        } else if (bucket_size <= 1)
+            return 0;
+
+        const auto bucket = erase_key(key);
+        if (bucket == INACTIVE)
+            return 0;
+
+        del_key(bucket, key);
+        return 1;
+    }
+
+    template<typename K>
+    uint32_t erase_key(const K& key)
     {
         const auto bucket = hash_coll_bucket(key);
         auto next_bucket = EMH_BUCKET(_pairs, bucket);
@@ -1055,7 +1122,8 @@ private:
     }
 
     // Find the bucket with this key, or return bucket size
-    uint32_t find_colls_bucket(const KeyT& key) const
+    template<typename K>
+    uint32_t find_colls_bucket(const K& key) const
     {
         const auto main_bucket = hash_main_bucket(key);
         const auto bucket_size = EMH_BUCKET(_pairs, main_bucket);
@@ -1063,7 +1131,7 @@ private:
         {
             if (bucket_size == INACTIVE)
                 return _total_buckets;
-            else if (_eq(key, EMH_KEY(_pairs, main_bucket)) && bucket_size % 2 > 0)
+            else if (bucket_size % 2 > 0 && _eq(key, EMH_KEY(_pairs, main_bucket)))
                 return main_bucket;
             else if (bucket_size == 1)
                 return _total_buckets;
@@ -34,6 +34,9 @@
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
 
 #ifdef __has_include
     #if __has_include("wyhash.h")
@@ -43,6 +46,19 @@
     #include "wyhash.h"
 #endif
 
+//EMH_SIMD_SCAN: an insert whose bitmask word is full finds the next empty bucket with the
+//AVX2/AVX-512 scan of hash_bitscan.hpp, 256-512 buckets per step instead of one word
+#if EMH_SIMD_SCAN
+    #include "hash_bitscan.hpp"
+#endif
+
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 // likely/unlikely
 #if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
 #    define EMH_LIKELY(condition) __builtin_expect(condition, 1)
@@ -65,6 +81,30 @@ constexpr uint32_t MASK_BIT = sizeof(uint8_t) * 8;
 constexpr uint32_t SIZE_BIT = sizeof(size_t) * 8;
 constexpr uint32_t INACTIVE = 0xFFFFFFFF;
 
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the wyhash path, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+
 static uint32_t CTZ(size_t n)
 {
 #if defined(__x86_64__) || defined(_WIN32) || (__BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
@@ -102,8 +142,10 @@ static uint32_t CTZ(size_t n)
     return (uint32_t)index;
 }
 
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
 /// A cache-friendly hash table with open addressing, linear probing and power-of-two capacity
-template <typename KeyT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
 class HashSet
 {
 public:
@@ -304,6 +346,16 @@ public:
         uint32_t _from;
     };
 
+    /// Enables erase(K) when both HashT and EqT are transparent.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     // ------------------------------------------------------------------------
 
     void init(uint32_t bucket, float load_factor = 0.95f)
@@ -660,24 +712,28 @@ public:
 
     // ------------------------------------------------------------
 
-    inline iterator find(const KeyT& key) noexcept
+    template<typename K=KeyT>
+    inline iterator find(const K& key) noexcept
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<K>>(key))};
     }
 
-    inline const_iterator find(const KeyT& key) const noexcept
+    template<typename K=KeyT>
+    inline const_iterator find(const K& key) const noexcept
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<K>>(key))};
     }
 
-    inline bool contains(const KeyT& key) const noexcept
+    template<typename K=KeyT>
+    inline bool contains(const K& key) const noexcept
     {
-        return find_filled_bucket(key) != _num_buckets;
+        return find_filled_bucket(static_cast<key_arg<K>>(key)) != _num_buckets;
     }
 
-    inline size_type count(const KeyT& key) const noexcept
+    template<typename K=KeyT>
+    inline size_type count(const K& key) const noexcept
     {
-        return find_filled_bucket(key) == _num_buckets ? 0 : 1;
+        return find_filled_bucket(static_cast<key_arg<K>>(key)) == _num_buckets ? 0 : 1;
     }
 
     /// Returns a pair consisting of an iterator to the inserted element
@@ -869,6 +925,17 @@ public:
         return 1;
     }
 
+    template<typename K, if_transparent<K> = 0>
+    size_type erase(const K& key)
+    {
+        const auto bucket = erase_key(static_cast<key_arg<K>>(key));
+        if (bucket == INACTIVE)
+            return 0;
+
+        clear_bucket(bucket);
+        return 1;
+    }
+
     iterator erase(const_iterator cit)
     {
         iterator it(cit);
@@ -1013,7 +1080,8 @@ private:
         return reserve(_num_filled);
     }
 
-    uint32_t erase_key(const KeyT& key)
+    template<typename K>
+    uint32_t erase_key(const K& key)
     {
         const auto bucket = hash_bucket(key) & _mask;
         auto next_bucket = _pairs[bucket].second;
@@ -1073,7 +1141,8 @@ private:
     }
 
     // Find the bucket with this key, or return bucket size
-    uint32_t find_filled_bucket(const KeyT& key) const
+    template<typename K>
+    uint32_t find_filled_bucket(const K& key) const
     {
         const auto bucket = hash_bucket(key) & _mask;
         auto next_bucket = _pairs[bucket].second;
@@ -1219,7 +1288,21 @@ private:
             return bucket_from + offset;
         }
 
+        //the load factor leaves an empty bucket, so some word is nonzero: the loop below
+        //would spin and the SIMD path take CTZ(0) on a full bitmask
+        assert(_num_filled < _num_buckets);
         const auto qmask = _mask / SIZE_BIT;
+#if EMH_SIMD_SCAN
+        //go on from the word the last empty bucket was found in, then wrap around
+        const auto* words = (const size_t*)_bitmask;
+        const auto from = _last & qmask;
+        if (EMH_LIKELY(words[from] != 0))
+            return (_last = from) * SIZE_BIT + CTZ(words[from]);
+        _last = (uint32_t)emhash::first_word(words, from + 1, qmask + 1);
+        if (_last > qmask)
+            _last = (uint32_t)emhash::first_word(words, 0, from);
+        return _last * SIZE_BIT + CTZ(words[_last]);
+#endif
         for (size_t i = 2; ; i++) {
             const auto bmask2 = *((size_t*)_bitmask + _last);
             if (bmask2 != 0)
@@ -1333,7 +1416,7 @@ private:
 #endif
     }
 
-    template<typename UType, typename std::enable_if<std::is_same<UType, std::string>::value, uint32_t>::type = 0>
+    template<typename UType, typename std::enable_if<is_string<UType>::value, uint32_t>::type = 0>
     inline uint32_t hash_bucket(const UType& key) const
     {
 #ifdef WYHASH_LITTLE_ENDIAN
@@ -1343,7 +1426,7 @@ private:
 #endif
     }
 
-    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !std::is_same<UType, std::string>::value, uint32_t>::type = 0>
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !is_string<UType>::value, uint32_t>::type = 0>
     inline uint32_t hash_bucket(const UType& key) const
     {
 #ifdef EMH_INT_HASH
@@ -36,6 +36,9 @@
 #include <functional>
 #include <iterator>
 #include <algorithm>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
 
 #ifdef EMH_KEY
     #undef  EMH_KEY
@@ -45,6 +48,19 @@
     #undef  EMH_PREVET
 #endif
 
+//EMH_SPARSE_CLEAR: clear() walks the used chains instead of resetting the whole index below
+//1/EMH_SPARSE_CLEAR load, the divisor must be at least 1
+#if defined(EMH_SPARSE_CLEAR) && EMH_SPARSE_CLEAR < 1
+    #error "EMH_SPARSE_CLEAR must be 1 or more"
+#endif
+
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 // likely/unlikely
 #if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
 #    define EMH_LIKELY(condition)   __builtin_expect(condition, 1)
@@ -74,13 +90,49 @@ constexpr uint32_t INACTIVE = 0xAAAAAAAA;
 constexpr uint32_t END      = 0-0x1u;
 constexpr uint32_t EAD      = 2;
 
+#ifndef EMH8_KEY_TRAITS //shared with hash_table8.hpp
+#define EMH8_KEY_TRAITS
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the EMH_WYHASH_HASH path, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+#endif
+
 /// A cache-friendly hash table with open addressing, linear/quadratic probing and power-of-two capacity
-template <typename KeyT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
 class HashSet
 {
 #ifndef EMH_DEFAULT_LOAD_FACTOR
     constexpr static float EMH_DEFAULT_LOAD_FACTOR = 0.80f;
 #endif
+#ifndef EMH_SPARSE_CLEAR
+    constexpr static uint32_t EMH_SPARSE_CLEAR     = 64; //clear() walks the chains below 1/64 load
+#endif
+#ifndef EMH_CACHE_LINE_SIZE
+    constexpr static uint32_t EMH_CACHE_LINE_SIZE  = 64;
+#endif
+
 public:
     using htype = HashSet<KeyT, HashT, EqT>;
     using value_type = KeyT;
@@ -214,6 +266,16 @@ public:
         const value_type* kv_;
     };
 
+    /// Enables erase(K) when both HashT and EqT are transparent.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     void init(size_type bucket, float mlf = EMH_DEFAULT_LOAD_FACTOR)
     {
         _pairs = nullptr;
@@ -433,7 +495,6 @@ public:
 
     size_type get_diss(size_type bucket, size_type next_bucket, const size_type slots) const
     {
-        constexpr static uint32_t EMH_CACHE_LINE_SIZE  = 64;
         auto pbucket = reinterpret_cast<uint64_t>(&_pairs[bucket]);
         auto pnext   = reinterpret_cast<uint64_t>(&_pairs[next_bucket]);
         if (pbucket / EMH_CACHE_LINE_SIZE == pnext / EMH_CACHE_LINE_SIZE)
@@ -514,29 +575,29 @@ public:
 
     // ------------------------------------------------------------
     template<typename K=KeyT>
-    iterator find(const KeyT& key) noexcept
+    iterator find(const K& key) noexcept
     {
-        return {this, find_filled_slot(key)};
+        return {this, find_filled_slot(static_cast<key_arg<K>>(key))};
     }
 
     template<typename K=KeyT>
     const_iterator find(const K& key) const noexcept
     {
-        return {this, find_filled_slot(key)};
+        return {this, find_filled_slot(static_cast<key_arg<K>>(key))};
     }
 
     template<typename K=KeyT>
     bool contains(const K& key) const noexcept
     {
-        return find_filled_slot(key) != _num_filled;
+        return find_filled_slot(static_cast<key_arg<K>>(key)) != _num_filled;
     }
 
     template<typename K=KeyT>
     size_type count(const K& key) const noexcept
     {
-        return find_filled_slot(key) == _num_filled ? 0 : 1;
+        return find_filled_slot(static_cast<key_arg<K>>(key)) == _num_filled ? 0 : 1;
         //return find_sorted_bucket(key) == END ? 0 : 1;
-        //return find_hash_bucket(key) == END ? 0 : 1;
+        //return find_hash_bucket(static_cast<key_arg<K>>(key)) == END ? 0 : 1;
     }
 
     template<typename K=KeyT>
@@ -722,14 +783,13 @@ public:
     /// return 0 if element was not found
     size_type erase(const KeyT& key)
     {
-        const auto key_hash = hash_key(key);
-        const auto sbucket = find_filled_bucket(key, key_hash);
-        if (sbucket == END)
-            return 0;
+        return erase_key(key);
+    }
 
-        const auto main_bucket = key_hash & _mask;
-        erase_slot(sbucket, main_bucket);
-        return 1;
+    template<typename K, if_transparent<K> = 0>
+    size_type erase(const K& key)
+    {
+        return erase_key(static_cast<key_arg<K>>(key));
     }
 
     //iterator erase(const_iterator begin_it, const_iterator end_it)
@@ -793,6 +853,22 @@ public:
 #endif
     }
 
+    //every filled bucket is on the chain of its key's main bucket, so walking the chain from
+    //the main bucket of each key empties them all, reading _num_filled keys instead of the index
+    void clear_chains()
+    {
+        for (size_type slot = 0; slot < _num_filled; ++slot) {
+            auto bucket = hash_bucket(EMH_KEY(_pairs, slot));
+            while (!EMH_EMPTY(_index, bucket)) {
+                const auto next_bucket = EMH_BUCKET(_index, bucket);
+                memset((char*)(_index + bucket), INACTIVE, sizeof(_index[0]));
+                if (next_bucket == bucket)
+                    break;
+                bucket = next_bucket;
+            }
+        }
+    }
+
     void clearkv()
     {
         if (is_triviall_destructable()) {
@@ -802,9 +878,12 @@ public:
     }
 
     /// Remove all elements, keeping full capacity.
+    /// A table holding few keys for its size only resets the index chains of those keys.
     void clear()
     {
-        if (_num_filled > 0)
+        if (_num_filled > 0 && _num_filled < _num_buckets / EMH_SPARSE_CLEAR)
+            clear_chains();
+        else if (_num_filled > 0)
             memset((char*)_index, INACTIVE, sizeof(_index[0]) * _num_buckets);
 
         clearkv();
@@ -1035,8 +1114,22 @@ private:
         return 0;
     }
 
+    template<typename K>
+    size_type erase_key(const K& key)
+    {
+        const auto key_hash = hash_key(key);
+        const auto sbucket = find_filled_bucket(key, key_hash);
+        if (sbucket == END)
+            return 0;
+
+        const auto main_bucket = key_hash & _mask;
+        erase_slot(sbucket, main_bucket);
+        return 1;
+    }
+
     // Find the slot with this key, or return bucket size
-    size_type find_filled_bucket(const KeyT& key, uint64_t key_hash) const
+    template<typename K>
+    size_type find_filled_bucket(const K& key, uint64_t key_hash) const
     {
         const auto bucket = size_type(key_hash & _mask);
         auto next_bucket = EMH_BUCKET(_index, bucket);
@@ -1067,7 +1160,8 @@ private:
     }
 
     // Find the slot with this key, or return bucket size
-    size_type find_filled_slot(const KeyT& key) const
+    template<typename K>
+    size_type find_filled_slot(const K& key) const
     {
         const auto key_hash = hash_key(key);
         const auto bucket = size_type(key_hash & _mask);
@@ -1498,7 +1592,7 @@ public:
 #endif
     }
 
-template<typename UType, typename std::enable_if<std::is_same<UType, std::string>::value, uint32_t>::type = 0>
+template<typename UType, typename std::enable_if<is_string<UType>::value, uint32_t>::type = 0>
     inline uint64_t hash_key(const UType& key) const
     {
 #if EMH_WYHASH_HASH
@@ -1510,7 +1604,7 @@ template<typename UType, typename std::enable_if<std::is_same<UType, std::string
 #endif
     }
 
-    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !std::is_same<UType, std::string>::value, uint32_t>::type = 0>
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !is_string<UType>::value, uint32_t>::type = 0>
     inline uint64_t hash_key(const UType& key) const
     {
 #ifdef EMH_INT_HASH
@@ -0,0 +1,222 @@
+// emhash::small_key for C++17, short string keys stored inline
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_small_key.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+
+// Most string keys are 8-23 bytes. std::string keeps them in its SSO buffer, but every hash
+// and compare still goes through data() and a length branch. small_key<N> stores up to N bytes
+// inline, zero padded, so equal short keys compare with N / 8 word loads and hash with a fixed
+// size wyhash round. A longer key spills to its own heap copy and takes the usual byte loop.
+// It works as the KeyT of emhash7/emhash8 (or any map) through the std::hash specialization.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <functional>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+    #pragma intrinsic(_umul128)
+#endif
+
+#ifndef EMH_LIKELY
+#if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
+#    define EMH_LIKELY(condition)   __builtin_expect(condition, 1)
+#    define EMH_UNLIKELY(condition) __builtin_expect(condition, 0)
+#else
+#    define EMH_LIKELY(condition)   condition
+#    define EMH_UNLIKELY(condition) condition
+#endif
+#endif
+
+namespace emhash {
+
+template <size_t N = 16>
+class small_key
+{
+    static_assert(N >= 8 && N % 8 == 0, "small_key holds whole 64-bit words");
+    static constexpr size_t WORDS = N / 8;
+
+public:
+    static constexpr size_t capacity = N;
+
+    small_key() noexcept : _words{}, _size(0) {}
+    small_key(const char* str) : small_key(std::string_view(str)) {}
+    small_key(const std::string& str) : small_key(std::string_view(str)) {}
+    small_key(std::string_view str) : _words{}, _size(str.size())
+    {
+        if (EMH_LIKELY(_size <= N)) {
+            if (_size > 0)
+                memcpy(_words, str.data(), _size);
+        } else {
+            auto heap = (char*)malloc(_size);
+            memcpy(heap, str.data(), _size);
+            memcpy(_words, &heap, sizeof(heap));
+        }
+    }
+
+    small_key(const small_key& rhs) : small_key(rhs.view()) {}
+    small_key(small_key&& rhs) noexcept : _size(rhs._size)
+    {
+        memcpy(_words, rhs._words, N);
+        rhs._size = 0;
+        memset(rhs._words, 0, N);
+    }
+
+    small_key& operator=(const small_key& rhs)
+    {
+        if (this != &rhs) {
+            small_key tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    small_key& operator=(small_key&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            small_key tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~small_key() { if (spilled()) free(heap()); }
+
+    void swap(small_key& rhs) noexcept
+    {
+        uint64_t words[WORDS];
+        memcpy(words, _words, N);
+        memcpy(_words, rhs._words, N);
+        memcpy(rhs._words, words, N);
+        std::swap(_size, rhs._size);
+    }
+
+    size_t size() const noexcept { return (size_t)_size; }
+    bool empty() const noexcept { return _size == 0; }
+    bool spilled() const noexcept { return _size > N; }
+    const char* data() const noexcept { return spilled() ? heap() : (const char*)_words; }
+    std::string_view view() const noexcept { return {data(), size()}; }
+    operator std::string_view() const noexcept { return view(); }
+    std::string str() const { return std::string(data(), size()); }
+
+    bool operator==(const small_key& rhs) const noexcept
+    {
+        if (_size != rhs._size)
+            return false;
+        if (EMH_LIKELY(_size <= N)) {
+            uint64_t diff = 0;
+            for (size_t i = 0; i < WORDS; i++)
+                diff |= _words[i] ^ rhs._words[i];
+            return diff == 0;
+        }
+        return memcmp(heap(), rhs.heap(), (size_t)_size) == 0;
+    }
+
+    bool operator!=(const small_key& rhs) const noexcept { return !(*this == rhs); }
+    bool operator<(const small_key& rhs) const noexcept { return view() < rhs.view(); }
+
+    uint64_t hash() const noexcept
+    {
+        if (EMH_LIKELY(_size <= N)) {
+            //the padding is zero, so whole words hash the same bytes as the key
+            uint64_t seed = secret[0] ^ _size;
+            size_t i = 0;
+            for (; i + 1 < WORDS; i += 2)
+                seed = mix(_words[i] ^ secret[1], _words[i + 1] ^ seed);
+            if (WORDS % 2)
+                seed = mix(_words[i] ^ secret[2], seed ^ secret[3]);
+            return mix(secret[1] ^ _size, seed);
+        }
+        return hash_bytes((const uint8_t*)heap(), (size_t)_size);
+    }
+
+private:
+    char* heap() const noexcept { char* p; memcpy(&p, _words, sizeof(p)); return p; }
+
+    static inline uint64_t mix(uint64_t A, uint64_t B)
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = A; r *= B;
+        return (uint64_t)r ^ (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t hi;
+        const uint64_t lo = _umul128(A, B, &hi);
+        return lo ^ hi;
+#else
+        uint64_t ha = A >> 32, hb = B >> 32, la = (uint32_t)A, lb = (uint32_t)B, hi, lo;
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+        lo = t + (rm1 << 32); c += lo < t; hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        return lo ^ hi;
+#endif
+    }
+
+    static inline uint64_t wyr8(const uint8_t* p) { uint64_t v; memcpy(&v, p, 8); return v; }
+
+    //wyhash for keys longer than N >= 8 bytes, see HashMap::wyhashstr of hash_table8.hpp
+    static uint64_t hash_bytes(const uint8_t* p, size_t len)
+    {
+        uint64_t seed = secret[0];
+        size_t i = len;
+        if (EMH_UNLIKELY(i > 48)) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mix(wyr8(p +  0) ^ secret[1], wyr8(p +  8) ^ seed);
+                see1 = mix(wyr8(p + 16) ^ secret[2], wyr8(p + 24) ^ see1);
+                see2 = mix(wyr8(p + 32) ^ secret[3], wyr8(p + 40) ^ see2);
+                p += 48; i -= 48;
+            } while (EMH_LIKELY(i > 48));
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mix(wyr8(p) ^ secret[1], wyr8(p + 8) ^ seed);
+            i -= 16; p += 16;
+        }
+        const auto a = wyr8(len > 16 ? p + i - 16 : p);
+        const auto b = wyr8(p + i - 8);
+        return mix(secret[1] ^ len, mix(a ^ secret[1], b ^ seed));
+    }
+
+    static constexpr uint64_t secret[4] = {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+        0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+    uint64_t _words[WORDS]; //inline bytes, or the heap pointer once spilled
+    uint64_t _size;
+};
+
+} // namespace emhash
+
+namespace std {
+template <size_t N>
+struct hash<emhash::small_key<N>>
+{
+    size_t operator()(const emhash::small_key<N>& key) const noexcept { return (size_t)key.hash(); }
+};
+} // namespace std
@@ -0,0 +1,47 @@
+// emhash::HashStats, the table health reported by stats() of emhash7, emhash8 and lru_size
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_stats.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+#pragma once
+
+#include <cstddef>
+
+namespace emhash {
+
+/// Table health returned by stats(), chain figures are estimated from the sampled buckets.
+struct HashStats
+{
+    size_t size;
+    size_t buckets;
+    float  load_factor;
+    size_t bytes;       //allocated by the table
+    size_t sampled;     //buckets sampled
+    float  main_ratio;  //elements sitting in their main bucket
+    float  hit_lines;   //cache lines touched per successful find
+    float  miss_lines;  //cache lines touched per unsuccessful find
+    size_t chains[17];  //sampled chains by length, [0] empty buckets and [16] 16 or longer
+};
+
+} // namespace emhash
@@ -0,0 +1,266 @@
+// emhash8::StringMap for C++17, string keys stored in an append-only arena
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_string8.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+
+// HashMap<std::string, V> pays one heap allocation per key longer than the SSO buffer and
+// a pointer chase on every compare. StringMap copies each inserted key once into large
+// arena blocks and keeps a string_view to it in the emhash8 pairs, the hash fragment stays
+// in the index slot as usual. Blocks never move, so rehash only moves the views. Erased keys
+// leave dead bytes in the arena until shrink_to_fit() compacts it.
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include "hash_table8.hpp"
+
+namespace emhash8 {
+
+template <typename ValueT, typename HashT = std::hash<std::string_view>, typename EqT = std::equal_to<std::string_view>>
+class StringMap
+{
+public:
+    using table_type     = HashMap<std::string_view, ValueT, HashT, EqT>;
+    using value_type     = typename table_type::value_type;
+    using key_type       = std::string_view;
+    using mapped_type    = ValueT;
+    using size_type      = typename table_type::size_type;
+    using iterator       = typename table_type::iterator;
+    using const_iterator = typename table_type::const_iterator;
+
+#ifndef EMH_DEFAULT_LOAD_FACTOR
+    constexpr static float EMH_DEFAULT_LOAD_FACTOR = 0.80f;
+#endif
+    static constexpr size_t MIN_BLOCK = 4 << 10;
+    static constexpr size_t MAX_BLOCK = 1 << 20;
+
+    StringMap(size_type bucket = 2, float mlf = EMH_DEFAULT_LOAD_FACTOR) : _map(bucket, mlf) {}
+
+    StringMap(const StringMap& rhs) : _map(rhs._map) { compact(); }
+    StringMap(StringMap&& rhs) noexcept : StringMap(0) { swap(rhs); }
+
+    StringMap& operator=(const StringMap& rhs)
+    {
+        if (this != &rhs) {
+            StringMap tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    StringMap& operator=(StringMap&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    ~StringMap() { free_blocks(); }
+
+    void swap(StringMap& rhs)
+    {
+        _map.swap(rhs._map);
+        _blocks.swap(rhs._blocks);
+        std::swap(_cur, rhs._cur);
+        std::swap(_left, rhs._left);
+        std::swap(_block_size, rhs._block_size);
+        std::swap(_arena_bytes, rhs._arena_bytes);
+        std::swap(_dead_bytes, rhs._dead_bytes);
+    }
+
+    iterator begin() noexcept { return _map.begin(); }
+    iterator end() noexcept { return _map.end(); }
+    const_iterator begin() const noexcept { return _map.cbegin(); }
+    const_iterator end() const noexcept { return _map.cend(); }
+    const_iterator cbegin() const noexcept { return _map.cbegin(); }
+    const_iterator cend() const noexcept { return _map.cend(); }
+
+    size_type size() const noexcept { return _map.size(); }
+    bool empty() const noexcept { return _map.empty(); }
+    size_type bucket_count() const { return _map.bucket_count(); }
+    float load_factor() const { return _map.load_factor(); }
+    float max_load_factor() const { return _map.max_load_factor(); }
+    void max_load_factor(float mlf) { _map.max_load_factor(mlf); }
+    bool reserve(uint64_t num_elems) { return _map.reserve(num_elems, false); }
+
+    /// Bytes of arena blocks allocated and bytes owned by erased keys
+    size_t arena_bytes() const { return _arena_bytes; }
+    size_t dead_bytes() const { return _dead_bytes; }
+
+    HashStats stats(float sample_ratio = 1.0f) const
+    {
+        auto st = _map.stats(sample_ratio);
+        st.bytes += _arena_bytes + _blocks.capacity() * sizeof(_blocks[0]);
+        return st;
+    }
+
+    iterator find(std::string_view key) noexcept { return _map.find(key); }
+    const_iterator find(std::string_view key) const noexcept { return _map.find(key); }
+    bool contains(std::string_view key) const noexcept { return _map.contains(key); }
+    size_type count(std::string_view key) const noexcept { return _map.count(key); }
+
+    ValueT& at(std::string_view key) { return _map.at(key); }
+    const ValueT& at(std::string_view key) const { return _map.at(key); }
+    ValueT* try_get(std::string_view key) noexcept { return _map.try_get(key); }
+    const ValueT* try_get(std::string_view key) const noexcept { return _map.try_get(key); }
+
+    /// The caller's view is inserted first and swapped for the arena copy only if the key
+    /// is new, both have the same contents so the stored hash fragment stays valid
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(std::string_view key, Args&&... args)
+    {
+        auto result = _map.try_emplace(key, std::forward<Args>(args)...);
+        if (result.second)
+            result.first->first = store(key);
+        return result;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(std::string_view key, Args&&... args)
+    {
+        return try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> insert(const std::pair<std::string_view, ValueT>& kv) { return try_emplace(kv.first, kv.second); }
+
+    template <typename V>
+    std::pair<iterator, bool> insert_or_assign(std::string_view key, V&& val)
+    {
+        auto result = try_emplace(key, std::forward<V>(val));
+        if (!result.second)
+            result.first->second = std::forward<V>(val);
+        return result;
+    }
+
+    ValueT& operator[](std::string_view key)
+    {
+        const auto old_size = _map.size();
+        auto& val = _map[key];
+        if (_map.size() != old_size)
+            _map.last()->first = store(key); //a new pair is always the last one
+        return val;
+    }
+
+    size_type erase(std::string_view key)
+    {
+        const auto it = _map.find(key);
+        if (it == _map.end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    iterator erase(const const_iterator& cit)
+    {
+        _dead_bytes += cit->first.size();
+        return _map.erase(cit);
+    }
+
+    void clear()
+    {
+        _map.clear();
+        free_blocks();
+    }
+
+    /// Copy the live keys into one block to drop the dead bytes, then shrink the table.
+    /// Views into the old blocks obtained from this map are invalidated.
+    void shrink_to_fit(const float min_factor = EMH_DEFAULT_LOAD_FACTOR / 4)
+    {
+        if (_dead_bytes > 0 || _blocks.size() > 1)
+            compact();
+        _map.shrink_to_fit(min_factor);
+    }
+
+private:
+    std::string_view store(std::string_view key)
+    {
+        if (key.empty())
+            return {};
+        if (EMH_UNLIKELY(_left < key.size()))
+            new_block(key.size());
+
+        memcpy(_cur, key.data(), key.size());
+        const std::string_view view(_cur, key.size());
+        _cur  += key.size();
+        _left -= key.size();
+        return view;
+    }
+
+    //blocks double up to MAX_BLOCK, a longer key gets a block of its own
+    void new_block(size_t need)
+    {
+        if (_block_size < MAX_BLOCK)
+            _block_size = _block_size == 0 ? MIN_BLOCK : _block_size * 2;
+
+        const auto bytes = need > _block_size ? need : _block_size;
+        _cur = (char*)malloc(bytes);
+        _blocks.push_back(_cur);
+        _left = bytes;
+        _arena_bytes += bytes;
+    }
+
+    void compact()
+    {
+        std::vector<char*> old_blocks;
+        old_blocks.swap(_blocks);
+        _cur = nullptr;
+        _left = _arena_bytes = _dead_bytes = 0;
+
+        size_t live = 0;
+        for (const auto& kv : _map)
+            live += kv.first.size();
+        if (live > 0) {
+            _cur = (char*)malloc(live);
+            _blocks.push_back(_cur);
+            _left = _arena_bytes = live;
+        }
+        for (auto& kv : _map)
+            kv.first = store(kv.first);
+
+        for (auto block : old_blocks)
+            free(block);
+    }
+
+    void free_blocks()
+    {
+        for (auto block : _blocks)
+            free(block);
+        _blocks.clear();
+        _cur = nullptr;
+        _left = _block_size = _arena_bytes = _dead_bytes = 0;
+    }
+
+    table_type _map;
+    std::vector<char*> _blocks;
+    char*  _cur = nullptr;
+    size_t _left = 0;
+    size_t _block_size = 0;
+    size_t _arena_bytes = 0;
+    size_t _dead_bytes = 0;
+};
+} // namespace emhash8
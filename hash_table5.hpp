@@ -37,11 +37,28 @@
 #include <functional>
 #include <iterator>
 #include <algorithm>
+#include <chrono>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
+
+#include "hash_event.hpp"
 
 #if EMH_WY_HASH
     #include "wyhash.h"
 #endif
 
+#if EMH_AES_HASH
+    #include "hash_aes.hpp"
+#endif
+
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 #ifdef EMH_KEY
     #undef  EMH_KEY
     #undef  EMH_VAL
@@ -103,6 +120,34 @@ namespace emhash5 {
     static constexpr uint32_t EMH_MALIGN = 16;
 #endif
 
+/// Passed to the rehash hook, shared with the other emhash tables.
+using RehashEvent = emhash::RehashEvent;
+using RehashHook  = emhash::RehashHook;
+
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the EMH_WY_HASH and EMH_AES_HASH paths, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+
 template <typename First, typename Second>
 struct entry {
     using first_type =  First;
@@ -207,8 +252,10 @@ struct entry {
 #endif
 };
 
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
 /// A cache-friendly hash table with open addressing, linear/qua probing and power-of-two capacity
-template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
 class HashMap
 {
 #ifndef EMH_DEFAULT_LOAD_FACTOR
@@ -334,6 +381,76 @@ public:
         size_type _bucket;
     };
 
+    /// Owns a key and value moved out by extract(), insert(node_type&&) moves them into a map.
+    /// Unlike std::unordered_map::node_type nothing is allocated, the pair lives in the handle.
+    class node_type
+    {
+    public:
+        typedef KeyT   key_type;
+        typedef ValueT mapped_type;
+
+        node_type() noexcept : _filled(false) {}
+        node_type(node_type&& rhs) : _filled(false) { *this = std::move(rhs); }
+        ~node_type() { reset(); }
+
+        node_type& operator=(node_type&& rhs)
+        {
+            if (this != &rhs) {
+                reset();
+                if (rhs._filled) {
+                    fill(std::move(rhs._kv.first), std::move(rhs._kv.second));
+                    rhs.reset();
+                }
+            }
+            return *this;
+        }
+
+        bool empty() const noexcept { return !_filled; }
+        explicit operator bool() const noexcept { return _filled; }
+        KeyT& key() { return _kv.first; }
+        const KeyT& key() const { return _kv.first; }
+        ValueT& mapped() { return _kv.second; }
+        const ValueT& mapped() const { return _kv.second; }
+
+    private:
+        friend class HashMap;
+
+        template<typename K, typename V>
+        void fill(K&& key, V&& val)
+        {
+            new(&_kv) value_type(std::forward<K>(key), std::forward<V>(val));
+            _filled = true;
+        }
+
+        void reset()
+        {
+            if (_filled)
+                _kv.~value_type();
+            _filled = false;
+        }
+
+        union { value_type _kv; };
+        bool _filled;
+    };
+
+    struct insert_return_type
+    {
+        iterator  position;
+        bool      inserted;
+        node_type node;
+    };
+
+    /// Enables the K overloads that insert or erase when both HashT and EqT are transparent,
+    /// a K which is a KeyT or an iterator keeps the plain overloads.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     void init(size_type bucket, float mlf = EMH_DEFAULT_LOAD_FACTOR) noexcept
     {
         _pairs = nullptr;
@@ -725,33 +842,33 @@ public:
     template<typename K=KeyT>
     iterator find(const K& key) noexcept
     {
-        return {this, find_filled_key(key)};
+        return {this, find_filled_key(static_cast<key_arg<K>>(key))};
     }
 
     template<typename K=KeyT>
     const_iterator find(const K& key) const noexcept
     {
-        return {this, find_filled_key(key)};
+        return {this, find_filled_key(static_cast<key_arg<K>>(key))};
     }
 
     template<typename K=KeyT>
     iterator find(const K& key, size_type key_hash) noexcept
     {
         const auto main_bucket = key_hash & _mask;
-        return {this, find_hash_bucket(key, main_bucket)};
+        return {this, find_hash_bucket(static_cast<key_arg<K>>(key), main_bucket)};
     }
 
     template<typename K=KeyT>
     const_iterator find(const K& key, size_type key_hash) const noexcept
     {
         const auto main_bucket = key_hash & _mask;
-        return {this, find_hash_bucket(key, main_bucket)};
+        return {this, find_hash_bucket(static_cast<key_arg<K>>(key), main_bucket)};
     }
 
     template<typename K=KeyT>
     ValueT& at(const K& key)
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         //throw
         return EMH_VAL(_pairs, bucket);
     }
@@ -759,7 +876,7 @@ public:
     template<typename K=KeyT>
     const ValueT& at(const K& key) const
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         return EMH_VAL(_pairs, bucket);
     }
 
@@ -767,7 +884,7 @@ public:
     ValueT& at(const K& key, size_type key_hash)
     {
         const auto main_bucket = key_hash & _mask;
-        const auto bucket = find_hash_bucket(key, main_bucket);
+        const auto bucket = find_hash_bucket(static_cast<key_arg<K>>(key), main_bucket);
         return EMH_VAL(_pairs, bucket);
     }
 
@@ -775,34 +892,34 @@ public:
     const ValueT& at(const K& key, size_type key_hash) const
     {
         const auto main_bucket = key_hash & _mask;
-        const auto bucket = find_hash_bucket(key, main_bucket);
+        const auto bucket = find_hash_bucket(static_cast<key_arg<K>>(key), main_bucket);
         return EMH_VAL(_pairs, bucket);
     }
 
     template<typename K=KeyT>
     bool contains(const K& key) const noexcept
     {
-        return find_filled_key(key) != _num_buckets;
+        return find_filled_key(static_cast<key_arg<K>>(key)) != _num_buckets;
     }
 
     template<typename K=KeyT>
     bool contains(const K& key, size_type key_hash) const noexcept
     {
         const auto main_bucket = key_hash & _mask;
-        return find_hash_bucket(key, main_bucket) != _num_buckets;
+        return find_hash_bucket(static_cast<key_arg<K>>(key), main_bucket) != _num_buckets;
     }
 
     template<typename K=KeyT>
     size_type count(const K& key) const noexcept
     {
-        return find_filled_key(key) == _num_buckets ? 0 : 1;
+        return find_filled_key(static_cast<key_arg<K>>(key)) == _num_buckets ? 0 : 1;
     }
 
     template<typename K=KeyT>
     size_type count(const K& key, size_type key_hash) const noexcept
     {
         const auto main_bucket = key_hash & _mask;
-        return find_hash_bucket(key, main_bucket) == _num_buckets ? 0 : 1;
+        return find_hash_bucket(static_cast<key_arg<K>>(key), main_bucket) == _num_buckets ? 0 : 1;
     }
 
     template<typename K=KeyT>
@@ -849,6 +966,75 @@ public:
         }
     }
 
+    /// Move the entry out of the map, KeyT and ValueT are moved and never copied.
+    node_type extract(const_iterator cit)
+    {
+        node_type node;
+        extract_to(cit, node);
+        return node;
+    }
+
+    /// An empty node_type if key isn't found.
+    node_type extract(const KeyT& key)
+    {
+        node_type node;
+        const auto it = find(key);
+        if (it != end())
+            extract_to(it, node);
+        return node;
+    }
+
+    /// Move the key and value of node into the map, node keeps them if the key is found.
+    insert_return_type insert(node_type&& node)
+    {
+        if (node.empty())
+            return {end(), false, node_type()};
+
+        const auto result = try_emplace(std::move(node._kv.first), std::move(node._kv.second));
+        if (result.second)
+            node.reset();
+        return {result.first, result.second, std::move(node)};
+    }
+
+    /// Move the entries pred accepts, and whose key dst doesn't have, into dst. pred is called
+    /// once per entry: the first pass marks the buckets to move, so that dst is reserved once.
+    template<typename Pred>
+    size_type transfer_if(HashMap& dst, Pred pred)
+    {
+        if (&dst == this)
+            return 0;
+
+        auto* marks = (uint64_t*)calloc(_num_buckets / 64 + 1, sizeof(uint64_t));
+        const auto flip = [marks](size_type bucket) { marks[bucket / 64] ^= 1ull << (bucket % 64); };
+        const auto marked = [marks](size_type bucket) { return (marks[bucket / 64] >> (bucket % 64)) & 1; };
+        size_type matched = 0;
+        for (auto it = cbegin(), last = cend(); it != last; ++it) {
+            if (pred(*it) && !dst.contains(it->first)) {
+                flip(it._bucket);
+                matched ++;
+            }
+        }
+
+        if (matched > 0)
+            dst.reserve(dst.size() + matched);
+        node_type node;
+        for (size_type bucket = 0; bucket < _num_buckets; bucket++) {
+            while (marked(bucket)) {
+                flip(bucket);
+                //an entry moved into bucket takes its mark along
+                const auto ebucket = extract_bucket(bucket, node);
+                if (ebucket != bucket && marked(ebucket)) {
+                    flip(ebucket);
+                    flip(bucket);
+                }
+                dst.insert_unique(std::move(node._kv.first), std::move(node._kv.second));
+                node.reset();
+            }
+        }
+        free(marks);
+        return matched;
+    }
+
     /// Return the old value or ValueT() if it didn't exist.
     ValueT set_get(const KeyT& key, const ValueT& val)
     {
@@ -867,9 +1053,10 @@ public:
 
 #ifdef EMH_EXT
     /// Returns the matching ValueT or nullptr if k isn't found.
-    bool try_get(const KeyT& key, ValueT& val) const
+    template<typename K=KeyT>
+    bool try_get(const K& key, ValueT& val) const
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         const auto found = bucket != _num_buckets;
         if (found) {
             val = EMH_VAL(_pairs, bucket);
@@ -878,23 +1065,26 @@ public:
     }
 
     /// Returns the matching ValueT or nullptr if k isn't found.
-    ValueT* try_get(const KeyT& key)
+    template<typename K=KeyT>
+    ValueT* try_get(const K& key)
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         return bucket != _num_buckets ? &EMH_VAL(_pairs, bucket) : nullptr;
     }
 
     /// Const version of the above
-    ValueT* try_get(const KeyT& key) const
+    template<typename K=KeyT>
+    ValueT* try_get(const K& key) const
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         return bucket != _num_buckets ? &EMH_VAL(_pairs, bucket) : nullptr;
     }
 
     /// set value if key exist
-    bool try_set(const KeyT& key, const ValueT& val)
+    template<typename K=KeyT>
+    bool try_set(const K& key, const ValueT& val)
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         if (bucket == _num_buckets)
             return false;
 
@@ -903,9 +1093,10 @@ public:
     }
 
     /// set value if key exist
-    bool try_set(const KeyT& key, ValueT&& val)
+    template<typename K=KeyT>
+    bool try_set(const K& key, ValueT&& val)
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         if (bucket == _num_buckets)
             return false;
 
@@ -914,9 +1105,10 @@ public:
     }
 
     /// Convenience function.
-    ValueT get_or_return_default(const KeyT& key) const
+    template<typename K=KeyT>
+    ValueT get_or_return_default(const K& key) const
     {
-        const auto bucket = find_filled_key(key);
+        const auto bucket = find_filled_key(static_cast<key_arg<K>>(key));
         return bucket == _num_buckets ? ValueT() : EMH_VAL(_pairs, bucket);
     }
 #endif
@@ -957,7 +1149,7 @@ public:
     template<typename K, typename V>
     std::pair<iterator, bool> do_insert(K&& key, V&& val) noexcept
     {
-        const auto bucket = find_or_allocate(key);
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key));
         const auto bempty = EMH_EMPTY(_pairs, bucket);
         if (bempty) {
             EMH_NEW(std::forward<K>(key), std::forward<V>(val), bucket);
@@ -965,11 +1157,29 @@ public:
         return { {this, bucket}, bempty };
     }
 
+    /// The value is built from args in place, and only once the key is known to be missing
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> do_try_emplace(K&& key, Args&&... args) noexcept
+    {
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key));
+        const auto bempty = EMH_EMPTY(_pairs, bucket);
+        if (bempty) {
+            new(&EMH_VAL(_pairs, bucket)) ValueT(std::forward<Args>(args)...);
+            new(&EMH_KEY(_pairs, bucket)) KeyT(std::forward<K>(key));
+            EMH_BUCKET(_pairs, bucket) = bucket;
+            _num_filled ++;
+#if EMH_BUCKET_INDEX == 1
+            if (bucket < _first) _first = bucket;
+#endif
+        }
+        return { {this, bucket}, bempty };
+    }
+
     template<typename K, typename V>
     std::pair<iterator, bool> do_assign(K&& key, V&& val) noexcept
     {
         check_expand_need();
-        const auto bucket = find_or_allocate(key);
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key));
         const auto bempty = EMH_EMPTY(_pairs, bucket);
         if (bempty) {
             EMH_NEW(std::forward<K>(key), std::forward<V>(val), bucket);
@@ -1097,32 +1307,27 @@ public:
         return do_insert(std::move(value)).first;
     }
 
-#if 0
-    //TODO: fix tuple
     template<class... Args>
     std::pair<iterator, bool> try_emplace(const KeyT& key, Args&&... args)
     {
         check_expand_need();
-        const auto bucket = find_or_allocate(key);
-        const auto bempty = EMH_EMPTY(_pairs, bucket);
-        if (bempty) {
-//            EMH_NEW(key, std::forward_as_tuple(std::forward<Args>(args)...), bucket);
-        }
-        return { {this, bucket}, bempty };
+        return do_try_emplace(key, std::forward<Args>(args)...);
     }
 
     template<class... Args>
     std::pair<iterator, bool> try_emplace(KeyT&& key, Args&&... args)
     {
         check_expand_need();
-        const auto bucket = find_or_allocate(key);
-        const auto bempty = EMH_EMPTY(_pairs, bucket);
-        if (bempty) {
-//            EMH_NEW(std::move(key), std::forward_as_tuple(std::forward<Args>(args)...), bucket);
-        }
-        return { {this, bucket}, bempty };
+        return do_try_emplace(std::move(key), std::forward<Args>(args)...);
+    }
+
+    /// The KeyT is built from key only if it isn't found
+    template<typename K, class... Args, if_transparent<K> = 0>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        check_expand_need();
+        return do_try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
     }
-#endif
 
     template<class... Args>
     iterator try_emplace(const_iterator hint, const KeyT& key, Args&&... args)
@@ -1142,6 +1347,8 @@ public:
     std::pair<iterator, bool> insert_or_assign(const KeyT& key, M&& val) noexcept { return do_assign(key, std::forward<M>(val)); }
     template <class M>
     std::pair<iterator, bool> insert_or_assign(KeyT&& key, M&& val) noexcept { return do_assign(std::move(key), std::forward<M>(val)); }
+    template <typename K, class M, if_transparent<K> = 0>
+    std::pair<iterator, bool> insert_or_assign(K&& key, M&& val) noexcept { return do_assign(std::forward<K>(key), std::forward<M>(val)); }
 
     template <class M>
     iterator insert_or_assign(const_iterator hint, const KeyT& key, M&& val) {
@@ -1189,6 +1396,18 @@ public:
         return EMH_VAL(_pairs, bucket);
     }
 
+    template<typename K, if_transparent<K> = 0>
+    ValueT& operator[](K&& key) noexcept
+    {
+        check_expand_need();
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key));
+        if (EMH_EMPTY(_pairs, bucket)) {
+            EMH_NEW(KeyT(std::forward<K>(key)), std::move(ValueT()), bucket);
+        }
+
+        return EMH_VAL(_pairs, bucket);
+    }
+
     // -------------------------------------------------------
     /// return 0 if not erase
 #if 0
@@ -1214,18 +1433,16 @@ public:
         return 1;
     }
 
-#if 0
-    template <typename K=KeyT>
-    size_type erase(K&& key)
+    template<typename K, if_transparent<K> = 0>
+    size_type erase(const K& key) noexcept
     {
-        const auto bucket = erase_key(key);
-        if ((int)bucket < 0)
+        const auto bucket = erase_key(static_cast<key_arg<K>>(key));
+        if (bucket == INACTIVE)
             return 0;
 
         clear_bucket(bucket);
         return 1;
     }
-#endif
 
     //iterator erase(const_iterator begin_it, const_iterator end_it)
     iterator erase(const_iterator cit) noexcept
@@ -1358,6 +1575,13 @@ public:
         return true;
     }
 
+    /// Hook called by rehash() of every map of this type, nullptr (the default) costs a branch per rehash.
+    static RehashHook& rehash_hook() noexcept
+    {
+        static RehashHook hook = nullptr;
+        return hook;
+    }
+
     void rehash(uint64_t required_buckets)
     {
         if (required_buckets < _num_filled)
@@ -1385,8 +1609,8 @@ public:
 #if EMH_REHASH_LOG
         auto omask = _mask;
         auto last = _last;
-        size_type collision = 0;
 #endif
+        size_type collision = 0;
 #if EMH_HIGH_LOAD
         _ehead = 0;
 #endif
@@ -1402,6 +1626,15 @@ public:
 #endif
         _num_buckets = num_buckets;
 
+        const auto hook = rehash_hook();
+        RehashEvent event = {};
+        std::chrono::steady_clock::time_point start;
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            event = {this, false, old_num_filled, old_buckets, num_buckets, (2 + num_buckets) * sizeof(PairT), old_pairs ? (2 + old_buckets) * sizeof(PairT) : 0, 0, 0};
+            hook(event);
+            start = std::chrono::steady_clock::now();
+        }
+
 #if EMH_SMALL_SIZE
         if (num_buckets <= EMH_SMALL_SIZE && old_pairs != (PairT*)_small)
             _pairs = (PairT*)_small;
@@ -1443,8 +1676,10 @@ public:
                     continue;
 #if EMH_REHASH_LOG
                 else if (src_bucket != EMH_BUCKET(old_pairs, src_bucket))
-                    collision ++;
+#else
+                else if (EMH_UNLIKELY(hook != nullptr) && src_bucket != EMH_BUCKET(old_pairs, src_bucket))
 #endif
+                    collision ++;
 
                 const auto& key = EMH_KEY(old_pairs, src_bucket);
                 const auto bucket = find_unique_bucket(key);
@@ -1455,6 +1690,13 @@ public:
             }
         }
 
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            event.finish     = true;
+            event.elapsed_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            event.collision  = _num_filled ? (float)collision / _num_filled : 0;
+            hook(event);
+        }
+
 #if EMH_REHASH_LOG
         if (_num_filled > EMH_REHASH_LOG) {
             auto mbucket = _num_filled - collision;
@@ -1557,6 +1799,31 @@ private:
         return reserve(_num_filled);
     }
 
+    //move the entry at cit out to node and erase it, returns the next iterator as erase() does
+    iterator extract_to(const_iterator cit, node_type& node)
+    {
+        const auto bucket = cit._bucket;
+        const auto ebucket = extract_bucket(bucket, node);
+        iterator it(this, bucket);
+        return (ebucket == bucket) ? ++it : it;
+    }
+
+    /// Returns the bucket cleared, if it isn't bucket its entry was moved into bucket.
+    size_type extract_bucket(const size_type bucket, node_type& node)
+    {
+        //erase_bucket hashes the key of a chain tail to unlink it and moves the next entry over any other
+        auto ebucket = bucket;
+        if (EMH_BUCKET(_pairs, bucket) == bucket) {
+            erase_bucket(bucket);
+            node.fill(std::move(EMH_KEY(_pairs, bucket)), std::move(EMH_VAL(_pairs, bucket)));
+        } else {
+            node.fill(std::move(EMH_KEY(_pairs, bucket)), std::move(EMH_VAL(_pairs, bucket)));
+            ebucket = erase_bucket(bucket);
+        }
+        clear_bucket(ebucket);
+        return ebucket;
+    }
+
     void clear_bucket(size_type bucket, bool bclear = true) noexcept
     {
         if (is_triviall_destructable()) {
@@ -2011,17 +2278,19 @@ one-way search strategy.
 #endif
     }
 
-    template<typename UType, typename std::enable_if<std::is_same<UType, std::string>::value, size_type>::type = 0>
+    template<typename UType, typename std::enable_if<is_string<UType>::value, size_type>::type = 0>
     size_type hash_key(const UType& key) const
     {
-#if EMH_WY_HASH
+#if EMH_AES_HASH
+        return (size_type)emhash::aes_hash(key.data(), key.size());
+#elif EMH_WY_HASH
         return (size_type)wyhash(key.data(), key.size(), 0);
 #else
         return (size_type)_hasher(key);
 #endif
     }
 
-    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !std::is_same<UType, std::string>::value, size_type>::type = 0>
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !is_string<UType>::value, size_type>::type = 0>
     size_type hash_key(const UType& key) const
     {
         return (size_type)_hasher(key);
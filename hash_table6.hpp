@@ -37,11 +37,28 @@
 #include <functional>
 #include <iterator>
 #include <algorithm>
+#include <chrono>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
+
+#include "hash_event.hpp"
 
 #if EMH_WY_HASH
     #include "wyhash.h"
 #endif
 
+#if EMH_AES_HASH
+    #include "hash_aes.hpp"
+#endif
+
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 #ifdef EMH_KEY
     #undef  EMH_KEY
     #undef  EMH_VAL
@@ -119,6 +136,34 @@ namespace emhash6 {
 
 static_assert((int)INACTIVE < 0, "INACTIVE must be even and < 0(to int)");
 
+/// Passed to the rehash hook, shared with the other emhash tables.
+using RehashEvent = emhash::RehashEvent;
+using RehashHook  = emhash::RehashHook;
+
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the EMH_WY_HASH and EMH_AES_HASH paths, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+
 //https://gist.github.com/jtbr/1896790eb6ad50506d5f042991906c30
 static inline size_type CTZ(size_t n)
 {
@@ -220,8 +265,10 @@ struct entry {
 #endif
 };
 
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
 /// A cache-friendly hash table with open addressing, linear/qua probing and power-of-two capacity
-template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
 class HashMap
 {
 #ifndef EMH_DEFAULT_LOAD_FACTOR
@@ -449,6 +496,76 @@ public:
         size_t    _bmask;
     };
 
+    /// Owns a key and value moved out by extract(), insert(node_type&&) moves them into a map.
+    /// Unlike std::unordered_map::node_type nothing is allocated, the pair lives in the handle.
+    class node_type
+    {
+    public:
+        typedef KeyT   key_type;
+        typedef ValueT mapped_type;
+
+        node_type() noexcept : _filled(false) {}
+        node_type(node_type&& rhs) : _filled(false) { *this = std::move(rhs); }
+        ~node_type() { reset(); }
+
+        node_type& operator=(node_type&& rhs)
+        {
+            if (this != &rhs) {
+                reset();
+                if (rhs._filled) {
+                    fill(std::move(rhs._kv.first), std::move(rhs._kv.second));
+                    rhs.reset();
+                }
+            }
+            return *this;
+        }
+
+        bool empty() const noexcept { return !_filled; }
+        explicit operator bool() const noexcept { return _filled; }
+        KeyT& key() { return _kv.first; }
+        const KeyT& key() const { return _kv.first; }
+        ValueT& mapped() { return _kv.second; }
+        const ValueT& mapped() const { return _kv.second; }
+
+    private:
+        friend class HashMap;
+
+        template<typename K, typename V>
+        void fill(K&& key, V&& val)
+        {
+            new(&_kv) value_type(std::forward<K>(key), std::forward<V>(val));
+            _filled = true;
+        }
+
+        void reset()
+        {
+            if (_filled)
+                _kv.~value_type();
+            _filled = false;
+        }
+
+        union { value_type _kv; };
+        bool _filled;
+    };
+
+    struct insert_return_type
+    {
+        iterator  position;
+        bool      inserted;
+        node_type node;
+    };
+
+    /// Enables the K overloads that insert when both HashT and EqT are transparent, a K which
+    /// is a KeyT or an iterator keeps the plain overloads.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     void init(size_type bucket, float lf = EMH_DEFAULT_LOAD_FACTOR)
     {
 #if EMH_SAFE_HASH
@@ -813,39 +930,39 @@ public:
     template<typename Key = KeyT>
     inline iterator find(const Key& key, size_t key_hash) noexcept
     {
-        return {this, find_filled_hash(key, key_hash)};
+        return {this, find_filled_hash(static_cast<key_arg<Key>>(key), key_hash)};
     }
 
     template<typename Key = KeyT>
     inline const_iterator find(const Key& key, size_t key_hash) const noexcept
     {
-        return {this, find_filled_hash(key, key_hash)};
+        return {this, find_filled_hash(static_cast<key_arg<Key>>(key), key_hash)};
     }
 
     template<typename Key=KeyT>
     inline iterator find(const Key& key) noexcept
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<Key>>(key))};
     }
 
     template<typename Key = KeyT>
     inline const_iterator find(const Key& key) const noexcept
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<Key>>(key))};
     }
 
     template<typename Key = KeyT>
-    inline ValueT& at(const KeyT& key)
+    inline ValueT& at(const Key& key)
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         //throw
         return EMH_VAL(_pairs, bucket);
     }
 
     template<typename Key = KeyT>
-    inline const ValueT& at(const KeyT& key) const
+    inline const ValueT& at(const Key& key) const
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         //throw
         return EMH_VAL(_pairs, bucket);
     }
@@ -853,13 +970,13 @@ public:
     template<typename Key = KeyT>
     inline bool contains(const Key& key) const noexcept
     {
-        return find_filled_bucket(key) <= _mask;
+        return find_filled_bucket(static_cast<key_arg<Key>>(key)) <= _mask;
     }
 
     template<typename Key = KeyT>
     inline size_type count(const Key& key) const noexcept
     {
-        return find_filled_bucket(key) <= _mask ? 1 : 0;
+        return find_filled_bucket(static_cast<key_arg<Key>>(key)) <= _mask ? 1 : 0;
     }
 
     template<typename Key = KeyT>
@@ -900,10 +1017,81 @@ public:
         }
     }
 
+    /// Move the entry out of the map, KeyT and ValueT are moved and never copied.
+    node_type extract(const_iterator cit)
+    {
+        node_type node;
+        extract_to(cit, node);
+        return node;
+    }
+
+    /// An empty node_type if key isn't found.
+    node_type extract(const KeyT& key)
+    {
+        node_type node;
+        const auto it = find(key);
+        if (it != end())
+            extract_to(it, node);
+        return node;
+    }
+
+    /// Move the key and value of node into the map, node keeps them if the key is found.
+    insert_return_type insert(node_type&& node)
+    {
+        if (node.empty())
+            return {end(), false, node_type()};
+
+        const auto result = try_emplace(std::move(node._kv.first), std::move(node._kv.second));
+        if (result.second)
+            node.reset();
+        return {result.first, result.second, std::move(node)};
+    }
+
+    /// Move the entries pred accepts, and whose key dst doesn't have, into dst. pred is called
+    /// once per entry: the first pass marks the buckets to move, so that dst is reserved once.
+    template<typename Pred>
+    size_type transfer_if(HashMap& dst, Pred pred)
+    {
+        if (&dst == this)
+            return 0;
+
+        const auto num_buckets = _mask + 1;
+        auto* marks = (size_t*)calloc(num_buckets / SIZE_BIT + 1, sizeof(size_t));
+        const auto flip = [marks](size_type bucket) { marks[bucket / SIZE_BIT] ^= (size_t)1 << (bucket % SIZE_BIT); };
+        const auto marked = [marks](size_type bucket) { return (marks[bucket / SIZE_BIT] >> (bucket % SIZE_BIT)) & 1; };
+        size_type matched = 0;
+        for (auto it = cbegin(), last = cend(); it != last; ++it) {
+            if (pred(*it) && !dst.contains(it->first)) {
+                flip(it._bucket);
+                matched ++;
+            }
+        }
+
+        if (matched > 0)
+            dst.reserve(dst.size() + matched);
+        node_type node;
+        for (size_type bucket = 0; bucket < num_buckets; bucket++) {
+            while (marked(bucket)) {
+                flip(bucket);
+                //an entry moved into bucket takes its mark along
+                const auto ebucket = extract_bucket(bucket, node);
+                if (ebucket != bucket && marked(ebucket)) {
+                    flip(ebucket);
+                    flip(bucket);
+                }
+                dst.insert_unique(std::move(node._kv.first), std::move(node._kv.second));
+                node.reset();
+            }
+        }
+        free(marks);
+        return matched;
+    }
+
 #ifdef EMH_EXT
-    bool try_get(const KeyT& key, ValueT& val) const noexcept
+    template<typename Key = KeyT>
+    bool try_get(const Key& key, ValueT& val) const noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         const auto found = bucket <= _mask;
         if (found) {
             val = EMH_VAL(_pairs, bucket);
@@ -912,23 +1100,26 @@ public:
     }
 
     /// Returns the matching ValueT or nullptr if k isn't found.
-    ValueT* try_get(const KeyT& key) noexcept
+    template<typename Key = KeyT>
+    ValueT* try_get(const Key& key) noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         return bucket <= _mask ? &EMH_VAL(_pairs, bucket) : nullptr;
     }
 
     /// Const version of the above
-    ValueT* try_get(const KeyT& key) const noexcept
+    template<typename Key = KeyT>
+    ValueT* try_get(const Key& key) const noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         return bucket <= _mask ? &EMH_VAL(_pairs, bucket) : nullptr;
     }
 
     /// Convenience function.
-    ValueT get_or_return_default(const KeyT& key) const noexcept
+    template<typename Key = KeyT>
+    ValueT get_or_return_default(const Key& key) const noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         return bucket <= _mask ? EMH_VAL(_pairs, bucket) : ValueT();
     }
 #endif
@@ -962,7 +1153,7 @@ public:
     template<typename K, typename V>
     std::pair<iterator, bool> do_insert(K&& key, V&& val)
     {
-        const auto bucket = find_or_allocate(key);
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key));
         const auto next   = bucket / 2;
         const auto found  = EMH_EMPTY(_pairs, next);
         if (found) {
@@ -975,7 +1166,7 @@ public:
     std::pair<iterator, bool> do_assign(K&& key, V&& val)
     {
         check_expand_need();
-        const auto bucket = find_or_allocate(key);
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key));
         const auto next   = bucket / 2;
         const auto found = EMH_EMPTY(_pairs, next);
         if (found) {
@@ -1050,6 +1241,8 @@ public:
 
     std::pair<iterator, bool> insert_or_assign(const KeyT& key, ValueT&& val) { return do_assign(key, std::forward<ValueT>(val)); }
     std::pair<iterator, bool> insert_or_assign(KeyT&& key, ValueT&& val) { return do_assign(std::move(key), std::forward<ValueT>(val)); }
+    template<typename K, if_transparent<K> = 0>
+    std::pair<iterator, bool> insert_or_assign(K&& key, ValueT&& val) { return do_assign(std::forward<K>(key), std::forward<ValueT>(val)); }
 
     template <typename... Args>
     inline std::pair<iterator, bool> emplace(Args&&... args) noexcept
@@ -1080,6 +1273,14 @@ public:
         return do_insert(std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    /// The KeyT is built from key only if it isn't found
+    template<typename K, class... Args, if_transparent<K> = 0>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        check_expand_need();
+        return do_insert(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
     template <class... Args>
     inline size_type emplace_unique(Args&&... args) noexcept
     {
@@ -1112,13 +1313,26 @@ public:
         return EMH_VAL(_pairs, next);
     }
 
+    template<typename K, if_transparent<K> = 0>
+    ValueT& operator[](K&& key) noexcept
+    {
+        check_expand_need();
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key));
+        const auto next   = bucket / 2;
+        if (EMH_EMPTY(_pairs, next)) {
+            EMH_NEW(KeyT(std::forward<K>(key)), std::move(ValueT()), next, bucket);
+        }
+
+        return EMH_VAL(_pairs, next);
+    }
+
     // -------------------------------------------------------
     /// Erase an element from the hash table.
     /// return 0 if element was not found
     template<typename Key = KeyT>
     size_type erase(const Key& key)
     {
-        const auto bucket = erase_key(key);
+        const auto bucket = erase_key(static_cast<key_arg<Key>>(key));
         if (bucket == INACTIVE)
             return 0;
 
@@ -1137,6 +1351,10 @@ public:
     /// Returns an iterator to the next element (or end()).
     iterator erase(iterator it)
     {
+#ifndef EMH_ITER_SAFE
+        //a lazy iterator reads its bitmask word on ++, once the bucket is cleared that would skip the next entry
+        if (it._from == (size_type)-1) it.init();
+#endif
         const auto bucket = erase_bucket(it._bucket);
         clear_bucket(bucket);
         if (bucket == it._bucket) {
@@ -1234,6 +1452,13 @@ public:
     }
 
     ///three ways may incr rehash: bad hash function, load_factor is high, or need shrink
+    /// Hook called by rehash() of every map of this type, nullptr (the default) costs a branch per rehash.
+    static RehashHook& rehash_hook() noexcept
+    {
+        static RehashHook hook = nullptr;
+        return hook;
+    }
+
     void rehash(uint64_t required_buckets)
     {
         if (required_buckets < _num_filled)
@@ -1269,6 +1494,15 @@ public:
 
         auto old_pairs = _pairs;
 
+        const auto hook = rehash_hook();
+        RehashEvent event = {};
+        std::chrono::steady_clock::time_point start;
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            event = {this, false, _num_filled, old_pairs ? old_mask + 1 : 0, num_buckets, AllocSize(num_buckets), old_pairs ? AllocSize(old_mask + 1) : 0, 0, 0};
+            hook(event);
+            start = std::chrono::steady_clock::now();
+        }
+
         _bitmask = decltype(_bitmask)(new_pairs + PACK_SIZE + num_buckets);
         const auto bitmask_pack = ((size_t)_bitmask) % sizeof(size_t);
         if (bitmask_pack != 0) {
@@ -1305,9 +1539,7 @@ public:
         //pack last position to bit 0
         /**************** -------------------------------- *************/
 
-#if EMH_REHASH_LOG
-        auto collision = 0;
-#endif
+        size_type collision = 0;
         //for (size_type src_bucket = 0; _num_filled < old_num_filled; src_bucket++) {
         for (size_type src_bucket = old_mask; _num_filled < old_num_filled; src_bucket --) {
             if (EMH_EMPTY(old_pairs, src_bucket))
@@ -1318,12 +1550,21 @@ public:
             EMH_NEW(std::move(key), std::move(EMH_VAL(old_pairs, src_bucket)), bucket / 2, bucket);
 #if EMH_REHASH_LOG
             if (bucket / 2 != hash_main(bucket / 2))
-                collision++;
+#else
+            if (EMH_UNLIKELY(hook != nullptr) && bucket / 2 != hash_main(bucket / 2))
 #endif
+                collision++;
             if (is_triviall_destructable())
                 old_pairs[src_bucket].~PairT();
         }
 
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            event.finish     = true;
+            event.elapsed_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            event.collision  = _num_filled ? (float)collision / _num_filled : 0;
+            hook(event);
+        }
+
 #if EMH_REHASH_LOG
         if (_num_filled > EMH_REHASH_LOG) {
 #ifndef EMH_SAFE_HASH
@@ -1371,6 +1612,40 @@ private:
     }
 #endif
 
+    //move the entry at cit out to node and erase it, returns the next iterator as erase() does
+    iterator extract_to(const_iterator cit, node_type& node)
+    {
+        iterator it(cit);
+#ifndef EMH_ITER_SAFE
+        //a lazy iterator reads its bitmask word on ++, once the bucket is cleared that would skip the next entry
+        if (it._from == (size_type)-1) it.init();
+#endif
+        const auto bucket = it._bucket;
+        const auto ebucket = extract_bucket(bucket, node);
+        if (ebucket == bucket)
+            return ++it;
+        it.clear(ebucket);
+        return it;
+    }
+
+    /// Returns the bucket cleared, if it isn't bucket its entry was moved into bucket.
+    size_type extract_bucket(const size_type bucket, node_type& node)
+    {
+        //erase_bucket moves the next entry of a main bucket over it, any other entry stays in
+        //place and may have its key hashed to unlink it
+        const auto next_bucket = EMH_ADDR(_pairs, bucket);
+        auto ebucket = bucket;
+        if (next_bucket % 2 == 0 && next_bucket != bucket * 2) {
+            node.fill(std::move(EMH_KEY(_pairs, bucket)), std::move(EMH_VAL(_pairs, bucket)));
+            ebucket = erase_bucket(bucket);
+        } else {
+            ebucket = erase_bucket(bucket);
+            node.fill(std::move(EMH_KEY(_pairs, ebucket)), std::move(EMH_VAL(_pairs, ebucket)));
+        }
+        clear_bucket(ebucket);
+        return ebucket;
+    }
+
     void clear_bucket(size_type bucket)
     {
         EMH_CLS(bucket);
@@ -1729,7 +2004,7 @@ private:
         return EMH_ADDR(_pairs, last_bucket) = find_empty_bucket(last_bucket) * 2 + 1;
     }
 
-#if EMH_INT_HASH
+#if EMH_INT_HASH || EMH_SAFE_HASH
     static constexpr uint64_t KC = UINT64_C(11400714819323198485);
     inline static uint64_t hash64(uint64_t key)
     {
@@ -1788,17 +2063,19 @@ private:
 #endif
     }
 
-    template<typename UType, typename std::enable_if<std::is_same<UType, std::string>::value, size_type>::type = 0>
+    template<typename UType, typename std::enable_if<is_string<UType>::value, size_type>::type = 0>
     inline size_type hash_key(const UType& key) const
     {
-#if EMH_WY_HASH
+#if EMH_AES_HASH
+        return emhash::aes_hash(key.data(), key.size());
+#elif EMH_WY_HASH
         return wyhash(key.data(), key.size(), 0);
 #else
         return (size_type)_hasher(key);
 #endif
     }
 
-    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !std::is_same<UType, std::string>::value, size_type>::type = 0>
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !is_string<UType>::value, size_type>::type = 0>
     inline size_type hash_key(const UType& key) const
     {
         return (size_type)_hasher(key);
@@ -87,11 +87,43 @@ of resizing granularity. Ignoring variance, the expected occurrences of list siz
 #include <functional>
 #include <iterator>
 #include <algorithm>
+#include <chrono>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
+
+#include "hash_stats.hpp"
+#include "hash_event.hpp"
 
 #if EMH_WY_HASH
     #include "wyhash.h"
 #endif
 
+#if EMH_AES_HASH
+    #include "hash_aes.hpp"
+#endif
+
+//EMH_SIMD_SCAN: an insert whose bitmask word is full finds the next empty bucket with the
+//AVX2/AVX-512 scan of hash_bitscan.hpp, 256-512 buckets per step instead of one word
+#if EMH_SIMD_SCAN
+    #include "hash_bitscan.hpp"
+#endif
+
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
+//EMH_INT_HASH: hash_batch() runs the hash64 mixer over 4 or 8 integer keys at once with the
+//AVX2/AVX-512 kernels of hash_batch.hpp if it is found next to this header
+#if EMH_INT_HASH && defined(__has_include)
+    #if __has_include("hash_batch.hpp")
+    #include "hash_batch.hpp"
+    #endif
+#endif
+
 #ifdef EMH_NEW
     #undef  EMH_KEY
     #undef  EMH_VAL
@@ -116,6 +148,21 @@ of resizing granularity. Ignoring variance, the expected occurrences of list siz
     #define EMH_BUCKET_INDEX 1
 #endif
 
+//EMH_SAFE_HASH: hash_key runs through a 64-bit mixer keyed by a per-instance seed, an insert walking
+//a chain longer than EMH_SAFE_CHAIN draws a new seed with a one-time rehash
+#if EMH_SAFE_HASH && !defined(EMH_SAFE_CHAIN)
+    #define EMH_SAFE_CHAIN 32
+#endif
+
+//EMH_FAST_RANGE: the bucket count is not rounded up to a power of two, the main bucket is picked by
+//a multiply-shift range reduction and the table grows by EMH_FAST_RANGE percent (25-50) instead of doubling
+
+//EMH_FINGERPRINT: 8 or 16, an 8 or 16-bit fingerprint of each key hash is kept in an array after _bitmask
+//and compared before _eq, so a find miss on long string keys rarely reads key data
+#if EMH_FINGERPRINT && EMH_FINGERPRINT != 8 && EMH_FINGERPRINT != 16
+    #error "EMH_FINGERPRINT must be 8 or 16"
+#endif
+
 #if EMH_BUCKET_INDEX == 0
     #define EMH_KEY(p,n)     p[n].second.first
     #define EMH_VAL(p,n)     p[n].second.second
@@ -146,6 +193,14 @@ of resizing granularity. Ignoring variance, the expected occurrences of list siz
 #define EMH_CLS(n)        _bitmask[n / MASK_BIT] |= EMH_MASK(n)
 #define EMH_EMPTY(n)      (_bitmask[n / MASK_BIT] & (EMH_MASK(n))) != 0
 
+#if EMH_FINGERPRINT
+    #define EMH_FPEQ(n, fp)     (_fprint[n] == fp)
+    #define EMH_FPMOV(to, from) _fprint[to] = _fprint[from]
+#else
+    #define EMH_FPEQ(n, fp)     ((void)fp, true)
+    #define EMH_FPMOV(to, from)
+#endif
+
 #if _WIN32
     #include <intrin.h>
 #if _WIN64
@@ -175,6 +230,42 @@ static_assert(EMH_MALIGN >= 16 && 0 == (EMH_MALIGN & (EMH_MALIGN - 1)));
 static_assert((int)INACTIVE < 0, "INACTIVE must negative (to int)");
 #endif
 
+/// Table health returned by stats(), shared with the other emhash tables.
+using HashStats = emhash::HashStats;
+
+/// Passed to the rehash hook, shared with the other emhash tables.
+using RehashEvent = emhash::RehashEvent;
+using RehashHook  = emhash::RehashHook;
+
+#ifndef EMH7_KEY_TRAITS //shared with hash_set3.hpp
+#define EMH7_KEY_TRAITS
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the EMH_WY_HASH and EMH_AES_HASH paths, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+#endif
+
 //count the leading zero bit
 static inline int CTZ(size_t n)
 {
@@ -310,7 +401,7 @@ struct entry {
 };
 
 /// A cache-friendly hash table with open addressing, linear/qua probing and power-of-two capacity
-template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
 class HashMap
 {
 #ifndef EMH_DEFAULT_LOAD_FACTOR
@@ -340,6 +431,11 @@ public:
     typedef EqT    key_equal;
     typedef PairT&       reference;
     typedef const PairT& const_reference;
+#if EMH_FINGERPRINT == 16
+    typedef uint16_t     fprint_t;
+#else
+    typedef uint8_t      fprint_t;
+#endif
 
     class const_iterator;
     class iterator
@@ -538,11 +634,88 @@ public:
         size_t    _bmask;
     };
 
+    /// Owns a key and value moved out by extract(), insert(node_type&&) moves them into a map.
+    /// Unlike std::unordered_map::node_type nothing is allocated, the pair lives in the handle.
+    class node_type
+    {
+    public:
+        typedef KeyT   key_type;
+        typedef ValueT mapped_type;
+
+        node_type() noexcept : _filled(false) {}
+        node_type(node_type&& rhs) : _filled(false) { *this = std::move(rhs); }
+        ~node_type() { reset(); }
+
+        node_type& operator=(node_type&& rhs)
+        {
+            if (this != &rhs) {
+                reset();
+                if (rhs._filled) {
+                    fill(std::move(rhs._kv.first), std::move(rhs._kv.second));
+                    rhs.reset();
+                }
+            }
+            return *this;
+        }
+
+        bool empty() const noexcept { return !_filled; }
+        explicit operator bool() const noexcept { return _filled; }
+        KeyT& key() { return _kv.first; }
+        const KeyT& key() const { return _kv.first; }
+        ValueT& mapped() { return _kv.second; }
+        const ValueT& mapped() const { return _kv.second; }
+
+    private:
+        friend class HashMap;
+
+        template<typename K, typename V>
+        void fill(K&& key, V&& val)
+        {
+            new(&_kv) value_type(std::forward<K>(key), std::forward<V>(val));
+            _filled = true;
+        }
+
+        void reset()
+        {
+            if (_filled)
+                _kv.~value_type();
+            _filled = false;
+        }
+
+        union { value_type _kv; };
+        bool _filled;
+    };
+
+    struct insert_return_type
+    {
+        iterator  position;
+        bool      inserted;
+        node_type node;
+    };
+
+    /// Enables the K overloads that insert when both HashT and EqT are transparent, a K which
+    /// is a KeyT or an iterator keeps the plain overloads.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     void init(size_type bucket, float mlf = EMH_DEFAULT_LOAD_FACTOR)
     {
         _pairs = nullptr;
         _bitmask = nullptr;
+#if EMH_FINGERPRINT
+        _fprint = nullptr;
+#endif
         _num_buckets = _num_filled = 0;
+#if EMH_SAFE_HASH
+        _seed = make_seed((uint64_t)this);
+        _hash_inter = 0;
+#endif
         _mlf = (uint32_t)((1 << 27) / EMH_DEFAULT_LOAD_FACTOR);
         max_load_factor(mlf);
         rehash(bucket);
@@ -555,7 +728,27 @@ public:
 
     static size_t AllocSize(uint64_t num_buckets)
     {
-        return (num_buckets + EPACK_SIZE) * sizeof(PairT) + (num_buckets + 7) / 8 + BIT_PACK;
+        return (num_buckets + EPACK_SIZE) * sizeof(PairT) + FprintOffset(num_buckets) + FprintSize(num_buckets);
+    }
+
+    //_bitmask and the padding after it, the fingerprints start there aligned
+    static size_t FprintOffset(uint64_t num_buckets)
+    {
+#if EMH_FINGERPRINT
+        return ((num_buckets + 7) / 8 + BIT_PACK + sizeof(fprint_t) - 1) / sizeof(fprint_t) * sizeof(fprint_t);
+#else
+        return (num_buckets + 7) / 8 + BIT_PACK;
+#endif
+    }
+
+    static size_t FprintSize(uint64_t num_buckets)
+    {
+#if EMH_FINGERPRINT
+        return num_buckets * sizeof(fprint_t);
+#else
+        (void)num_buckets;
+        return 0;
+#endif
     }
 
     static PairT* alloc_bucket(size_type num_buckets)
@@ -587,6 +780,10 @@ public:
 #else
         _num_buckets = _num_filled = _mask = 0;
         _pairs = nullptr;
+#if EMH_SAFE_HASH
+        _seed = make_seed((uint64_t)this);
+        _hash_inter = 0;
+#endif
 #endif
         swap(rhs);
     }
@@ -678,14 +875,21 @@ public:
         _mask        = rhs._mask;
         _mlf         = rhs._mlf;
         _num_buckets = rhs._num_buckets;
+#if EMH_SAFE_HASH
+        _seed        = rhs._seed;
+        _hash_inter  = rhs._hash_inter;
+#endif
 
         _bitmask     = decltype(_bitmask)(_pairs + EPACK_SIZE + _num_buckets);
+#if EMH_FINGERPRINT
+        _fprint      = (fprint_t*)(_bitmask + FprintOffset(_num_buckets));
+#endif
         auto* opairs = rhs._pairs;
 
         if (is_copy_trivially())
             memcpy((char*)_pairs, opairs, AllocSize(_num_buckets));
         else {
-            memcpy((char*)(_pairs + _num_buckets), opairs + _num_buckets, EPACK_SIZE * sizeof(PairT) + (_num_buckets + 7) / 8 + BIT_PACK);
+            memcpy((char*)(_pairs + _num_buckets), opairs + _num_buckets, EPACK_SIZE * sizeof(PairT) + FprintOffset(_num_buckets) + FprintSize(_num_buckets));
             for (auto it = rhs.cbegin(); it.bucket() < _num_buckets; ++it) {
                 const auto bucket = it.bucket();
                 new(_pairs + bucket) PairT(opairs[bucket]); EMH_BUCKET(_pairs, bucket) = EMH_BUCKET(opairs, bucket);
@@ -703,6 +907,13 @@ public:
         std::swap(_mask, rhs._mask);
         std::swap(_mlf, rhs._mlf);
         std::swap(_bitmask, rhs._bitmask);
+#if EMH_FINGERPRINT
+        std::swap(_fprint, rhs._fprint);
+#endif
+#if EMH_SAFE_HASH
+        std::swap(_seed, rhs._seed);
+        std::swap(_hash_inter, rhs._hash_inter);
+#endif
     }
 
     // -------------------------------------------------------------
@@ -748,6 +959,30 @@ public:
         return {this, bucket};
     }
 
+    /// Random element by rejection sampling of the buckets, end() if empty. A draw hits a filled
+    /// bucket with probability load_factor(), after 32 misses (a nearly empty table) the next
+    /// filled bucket is taken, which favours elements behind long runs of empty buckets.
+    template<typename RNG>
+    iterator sample(RNG& rng)
+    {
+        return {this, sample_bucket(rng)};
+    }
+
+    template<typename RNG>
+    const_iterator sample(RNG& rng) const
+    {
+        return {this, sample_bucket(rng)};
+    }
+
+    /// Writes k iterators to random elements to out (with replacement), none if empty.
+    template<typename RNG, typename OutIt>
+    OutIt sample_n(RNG& rng, size_type k, OutIt out)
+    {
+        for (size_type i = 0; _num_filled > 0 && i < k; i++)
+            *out++ = iterator(this, sample_bucket(rng));
+        return out;
+    }
+
     inline const_iterator begin() const noexcept { return cbegin(); }
 
     inline iterator end() noexcept { return {this, _num_buckets}; }
@@ -763,6 +998,20 @@ public:
     inline HashT& hash_function() const { return _hasher; }
     inline EqT& key_eq() const { return _eq; }
 
+    /// Writes hash_key(keys[i]) to out[i], integer keys take the SIMD kernels of hash_batch.hpp
+    /// with EMH_INT_HASH, other keys are hashed one at a time.
+    void hash_batch(const KeyT* keys, uint64_t* out, size_t n) const
+    {
+        hash_batch_raw(keys, out, n);
+        for (size_t i = 0; i < n; i++) {
+#if EMH_SAFE_HASH
+            out[i] = (size_type)hash_seed(out[i]);
+#else
+            out[i] = (size_type)out[i];
+#endif
+        }
+    }
+
     inline void max_load_factor(float mlf)
     {
         if (mlf <= 0.999f && mlf > EMH_MIN_LOAD_FACTOR)
@@ -783,11 +1032,62 @@ public:
         return main_size;
     }
 
+    /// Always available unlike dump_statics(), only every 1/sample_ratio-th bucket is walked
+    HashStats stats(float sample_ratio = 1.0f) const
+    {
+        constexpr uint64_t cache_line_size = 64;
+        HashStats st = {};
+        st.size        = _num_filled;
+        st.buckets     = _num_buckets;
+        st.load_factor = load_factor();
+        st.bytes       = _num_buckets > 0 ? AllocSize(_num_buckets) : 0;
+        if (_num_filled == 0)
+            return st;
+
+        const size_type step = sample_ratio >= 1.0f || sample_ratio <= 0 ? 1 : (size_type)(1 / sample_ratio);
+        size_t occupied = 0, mains = 0, hits = 0, hit_lines = 0, miss_lines = 0;
+        for (size_type bucket = 0; bucket < _num_buckets; bucket += step) {
+            st.sampled ++;
+            if (EMH_EMPTY(bucket)) {
+                st.chains[0] ++;
+                miss_lines ++; //the _bitmask word
+                continue;
+            }
+
+            //every step compares the key stored in the bucket
+            const bool is_main = key_bucket(hash_key(EMH_KEY(_pairs, bucket))) == bucket;
+            auto next_bucket = EMH_BUCKET(_pairs, bucket);
+            size_t lines = 1, chain_size = 1, chain_hit = 1;
+            for (auto cur_bucket = bucket; next_bucket != cur_bucket; ) {
+                if ((uint64_t)(_pairs + next_bucket) / cache_line_size != (uint64_t)(_pairs + cur_bucket) / cache_line_size)
+                    lines ++;
+                chain_size ++;
+                chain_hit += lines;
+                cur_bucket  = next_bucket;
+                next_bucket = EMH_BUCKET(_pairs, cur_bucket);
+            }
+
+            occupied ++;
+            miss_lines += lines;
+            if (is_main) {
+                mains ++;
+                hits += chain_size;
+                hit_lines += chain_hit;
+                st.chains[chain_size < 16 ? chain_size : 16] ++;
+            }
+        }
+
+        st.main_ratio = occupied ? (float)mains / occupied : 0;
+        st.hit_lines  = hits ? (float)hit_lines / hits : 0;
+        st.miss_lines = (float)miss_lines / st.sampled;
+        return st;
+    }
+
 #if EMH_STATIS
     //Returns the bucket number where the element with key k is located.
     size_type bucket(const KeyT& key) const
     {
-        const auto bucket = hash_key(key) & _mask;
+        const auto bucket = key_bucket(hash_key(key));
         const auto next_bucket = EMH_BUCKET(_pairs, bucket);
         if (EMH_EMPTY(bucket))
             return 0;
@@ -795,7 +1095,7 @@ public:
             return bucket + 1;
 
         const auto& bucket_key = EMH_KEY(_pairs, bucket);
-        return (hash_key(bucket_key) & _mask) + 1;
+        return key_bucket(hash_key(bucket_key)) + 1;
     }
 
     //Returns the number of elements in bucket n.
@@ -805,7 +1105,7 @@ public:
             return 0;
 
         auto next_bucket = EMH_BUCKET(_pairs, bucket);
-        next_bucket = hash_key(EMH_KEY(_pairs, bucket)) & _mask;
+        next_bucket = key_bucket(hash_key(EMH_KEY(_pairs, bucket)));
         size_type bucket_size = 1;
 
         //iterator each item in current main bucket
@@ -826,7 +1126,7 @@ public:
             return INACTIVE;
 
         const auto& bucket_key = EMH_KEY(_pairs, bucket);
-        const auto main_bucket = hash_key(bucket_key) & _mask;
+        const auto main_bucket = key_bucket(hash_key(bucket_key));
         return main_bucket;
     }
 
@@ -849,7 +1149,7 @@ public:
             return -1;
 
         auto next_bucket = EMH_BUCKET(_pairs, bucket);
-        if ((hash_key(EMH_KEY(_pairs, bucket)) & _mask) != bucket)
+        if (key_bucket(hash_key(EMH_KEY(_pairs, bucket))) != bucket)
             return 0;
         else if (next_bucket == bucket)
             return 1;
@@ -944,39 +1244,39 @@ public:
     template<typename Key = KeyT>
     inline iterator find(const Key& key, size_t key_hash) noexcept
     {
-        return {this, find_filled_hash(key, key_hash)};
+        return {this, find_filled_hash(static_cast<key_arg<Key>>(key), key_hash)};
     }
 
     template<typename Key = KeyT>
     inline const_iterator find(const Key& key, size_t key_hash) const noexcept
     {
-        return {this, find_filled_hash(key, key_hash)};
+        return {this, find_filled_hash(static_cast<key_arg<Key>>(key), key_hash)};
     }
 
     template<typename Key=KeyT>
     inline iterator find(const Key& key) noexcept
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<Key>>(key))};
     }
 
     template<typename Key = KeyT>
     inline const_iterator find(const Key& key) const noexcept
     {
-        return {this, find_filled_bucket(key)};
+        return {this, find_filled_bucket(static_cast<key_arg<Key>>(key))};
     }
 
     template<typename Key = KeyT>
-    ValueT& at(const KeyT& key)
+    ValueT& at(const Key& key)
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         //throw
         return EMH_VAL(_pairs, bucket);
     }
 
     template<typename Key = KeyT>
-    const ValueT& at(const KeyT& key) const
+    const ValueT& at(const Key& key) const
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         //throw
         return EMH_VAL(_pairs, bucket);
     }
@@ -984,19 +1284,19 @@ public:
     template<typename Key = KeyT>
     inline bool contains(const Key& key) const noexcept
     {
-        return find_filled_bucket(key) != _num_buckets;
+        return find_filled_bucket(static_cast<key_arg<Key>>(key)) != _num_buckets;
     }
 
     template<typename Key = KeyT>
     inline size_type count(const Key& key) const noexcept
     {
-        return find_filled_bucket(key) != _num_buckets ? 1 : 0;
+        return find_filled_bucket(static_cast<key_arg<Key>>(key)) != _num_buckets ? 1 : 0;
     }
 
     template<typename Key = KeyT>
     std::pair<iterator, iterator> equal_range(const Key& key) const noexcept
     {
-        const auto found = {this, find_filled_bucket(key), true};
+        const auto found = {this, find_filled_bucket(static_cast<key_arg<Key>>(key)), true};
         if (found.bucket() == _num_buckets)
             return { found, found };
         else
@@ -1006,7 +1306,7 @@ public:
     template<typename K=KeyT>
     std::pair<const_iterator, const_iterator> equal_range(const K& key) const
     {
-        const auto found = {this, find_filled_bucket(key), true};
+        const auto found = {this, find_filled_bucket(static_cast<key_arg<K>>(key)), true};
         if (found.bucket() == _num_buckets)
             return { found, found };
         else
@@ -1031,10 +1331,80 @@ public:
         }
     }
 
+    /// Move the entry out of the map, KeyT and ValueT are moved and never copied.
+    node_type extract(const_iterator cit)
+    {
+        node_type node;
+        extract_to(cit, node);
+        return node;
+    }
+
+    /// An empty node_type if key isn't found.
+    node_type extract(const KeyT& key)
+    {
+        node_type node;
+        const auto it = find(key);
+        if (it != end())
+            extract_to(it, node);
+        return node;
+    }
+
+    /// Move the key and value of node into the map, node keeps them if the key is found.
+    insert_return_type insert(node_type&& node)
+    {
+        if (node.empty())
+            return {end(), false, node_type()};
+
+        const auto result = try_emplace(std::move(node._kv.first), std::move(node._kv.second));
+        if (result.second)
+            node.reset();
+        return {result.first, result.second, std::move(node)};
+    }
+
+    /// Move the entries pred accepts, and whose key dst doesn't have, into dst. pred is called
+    /// once per entry: the first pass marks the buckets to move, so that dst is reserved once.
+    template<typename Pred>
+    size_type transfer_if(HashMap& dst, Pred pred)
+    {
+        if (&dst == this)
+            return 0;
+
+        auto* marks = (size_t*)calloc(_num_buckets / SIZE_BIT + 1, sizeof(size_t));
+        const auto flip = [marks](size_type bucket) { marks[bucket / SIZE_BIT] ^= (size_t)1 << (bucket % SIZE_BIT); };
+        const auto marked = [marks](size_type bucket) { return (marks[bucket / SIZE_BIT] >> (bucket % SIZE_BIT)) & 1; };
+        size_type matched = 0;
+        for (auto it = cbegin(), last = cend(); it != last; ++it) {
+            if (pred(*it) && !dst.contains(it->first)) {
+                flip(it._bucket);
+                matched ++;
+            }
+        }
+
+        if (matched > 0)
+            dst.reserve(dst.size() + matched);
+        node_type node;
+        for (size_type bucket = 0; bucket < _num_buckets; bucket++) {
+            while (marked(bucket)) {
+                flip(bucket);
+                //an entry moved into bucket takes its mark along
+                const auto ebucket = extract_bucket(bucket, node);
+                if (ebucket != bucket && marked(ebucket)) {
+                    flip(ebucket);
+                    flip(bucket);
+                }
+                dst.insert_unique(std::move(node._kv.first), std::move(node._kv.second));
+                node.reset();
+            }
+        }
+        free(marks);
+        return matched;
+    }
+
 #ifdef EMH_EXT
-    bool try_get(const KeyT& key, ValueT& val) const noexcept
+    template<typename Key = KeyT>
+    bool try_get(const Key& key, ValueT& val) const noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         const auto found = bucket != _num_buckets;
         if (found) {
             val = EMH_VAL(_pairs, bucket);
@@ -1043,23 +1413,26 @@ public:
     }
 
     /// Returns the matching ValueT or nullptr if k isn't found.
-    ValueT* try_get(const KeyT& key) noexcept
+    template<typename Key = KeyT>
+    ValueT* try_get(const Key& key) noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         return bucket == _num_buckets ? nullptr : &EMH_VAL(_pairs, bucket);
     }
 
     /// Const version of the above
-    ValueT* try_get(const KeyT& key) const noexcept
+    template<typename Key = KeyT>
+    ValueT* try_get(const Key& key) const noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         return bucket == _num_buckets ? nullptr : &EMH_VAL(_pairs, bucket);
     }
 
     /// Convenience function.
-    ValueT get_or_return_default(const KeyT& key) const noexcept
+    template<typename Key = KeyT>
+    ValueT get_or_return_default(const Key& key) const noexcept
     {
-        const auto bucket = find_filled_bucket(key);
+        const auto bucket = find_filled_bucket(static_cast<key_arg<Key>>(key));
         return bucket == _num_buckets ? ValueT() : EMH_VAL(_pairs, bucket);
     }
 #endif
@@ -1071,7 +1444,7 @@ public:
         reserve(_num_filled);
 
         bool isempty;
-        const auto bucket = find_or_allocate(key, isempty);
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key), isempty);
         if (isempty) {
             EMH_NEW(std::forward<K>(key), std::forward<V>(val), bucket);
         } else {
@@ -1104,7 +1477,7 @@ public:
     std::pair<iterator, bool> do_insert(K&& key, V&& val)
     {
         bool isempty;
-        const auto bucket = find_or_allocate(key, isempty);
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key), isempty);
         if (isempty) {
             EMH_NEW(std::forward<K>(key), std::forward<V>(val), bucket);
         }
@@ -1175,6 +1548,8 @@ public:
 
     std::pair<iterator, bool> insert_or_assign(const KeyT& key, ValueT&& val) { return do_assign(key, std::forward<ValueT>(val)); }
     std::pair<iterator, bool> insert_or_assign(KeyT&& key, ValueT&& val) { return do_assign(std::move(key), std::forward<ValueT>(val)); }
+    template<typename K, if_transparent<K> = 0>
+    std::pair<iterator, bool> insert_or_assign(K&& key, ValueT&& val) { return do_assign(std::forward<K>(key), std::forward<ValueT>(val)); }
 
     template <typename... Args>
     std::pair<iterator, bool> emplace(Args&&... args) noexcept
@@ -1205,6 +1580,14 @@ public:
         return do_insert(std::forward<KeyT>(key), std::forward<Args>(args)...);
     }
 
+    /// The KeyT is built from key only if it isn't found
+    template<typename K, class... Args, if_transparent<K> = 0>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        check_expand_need();
+        return do_insert(std::forward<K>(key), std::forward<Args>(args)...);
+    }
+
     template <class... Args>
     size_type emplace_unique(Args&&... args) noexcept
     {
@@ -1238,13 +1621,27 @@ public:
         return EMH_VAL(_pairs, bucket);
     }
 
+    template<typename K, if_transparent<K> = 0>
+    ValueT& operator[](K&& key) noexcept
+    {
+        check_expand_need();
+
+        bool isempty;
+        const auto bucket = find_or_allocate(static_cast<key_arg<K>>(key), isempty);
+        if (isempty) {
+            EMH_NEW(KeyT(std::forward<K>(key)), std::move(ValueT()), bucket);
+        }
+
+        return EMH_VAL(_pairs, bucket);
+    }
+
     // -------------------------------------------------------
     /// Erase an element from the hash table.
     /// return 0 if element was not found
     template<typename Key = KeyT>
     size_type erase(const Key& key)
     {
-        const auto bucket = erase_key(key);
+        const auto bucket = erase_key(static_cast<key_arg<Key>>(key));
         if (bucket == INACTIVE)
             return 0;
 
@@ -1263,6 +1660,10 @@ public:
     /// Returns an iterator to the next element (or end()).
     iterator erase(iterator it)
     {
+#ifndef EMH_ITER_SAFE
+        //a lazy iterator reads its bitmask word on ++, once the bucket is cleared that would skip the next entry
+        if (it._from == (size_type)-1) it.init();
+#endif
         const auto bucket = erase_bucket(it._bucket);
         clear_bucket(bucket);
         if (bucket == it._bucket) {
@@ -1359,13 +1760,33 @@ public:
         return true;
     }
 
+    /// Hook called by rehash() of every map of this type, nullptr (the default) costs a branch per rehash.
+    static RehashHook& rehash_hook() noexcept
+    {
+        static RehashHook hook = nullptr;
+        return hook;
+    }
+
     void rehash(uint64_t required_buckets)
     {
         if (required_buckets < _num_filled)
             return;
 
+#if EMH_FAST_RANGE
+        //bitmask words are scanned whole, so large tables keep a multiple of SIZE_BIT buckets
+        uint64_t buckets = std::max(required_buckets, (uint64_t)_num_filled * _mlf >> 28);
+        if (buckets > _num_buckets && _num_buckets >= SIZE_BIT)
+            buckets = std::max(buckets, _num_buckets + (uint64_t)_num_buckets * EMH_FAST_RANGE / 100);
+        if (buckets > SIZE_BIT)
+            buckets = (buckets + SIZE_BIT - 1) / SIZE_BIT * SIZE_BIT;
+        else {
+            auto small = buckets;
+            for (buckets = 2; buckets < small; buckets *= 2) {}
+        }
+#else
         uint64_t buckets = _num_filled > (1u << 16) ? (1u << 16) : 2u;
         while (buckets < required_buckets) { buckets *= 2; }
+#endif
 
         // no need alloc large bucket for small key sizeof(KeyT) < sizeof(int).
         // set small a max_load_factor, insert/reserve() will fail and introduce rehash issiue TODO: dothing ?
@@ -1381,6 +1802,15 @@ public:
         auto old_pairs = _pairs;
         auto* obmask   = _bitmask;
 
+        const auto hook = rehash_hook();
+        RehashEvent event = {};
+        std::chrono::steady_clock::time_point start;
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            event = {this, false, _num_filled, _num_buckets, num_buckets, AllocSize(num_buckets), old_pairs ? AllocSize(_num_buckets) : 0, 0, 0};
+            hook(event);
+            start = std::chrono::steady_clock::now();
+        }
+
         _num_filled  = 0;
         _num_buckets = num_buckets;
         _mask        = num_buckets - 1;
@@ -1389,6 +1819,9 @@ public:
         memset((char*)(_pairs + _num_buckets), 0, sizeof(PairT) * EPACK_SIZE);
 
         _bitmask     = decltype(_bitmask)(_pairs + EPACK_SIZE + num_buckets);
+#if EMH_FINGERPRINT
+        _fprint      = (fprint_t*)(_bitmask + FprintOffset(num_buckets));
+#endif
 
         const auto mask_byte = (num_buckets + 7) / 8;
         memset(_bitmask, 0xFFFFFFFF, mask_byte);
@@ -1408,6 +1841,13 @@ public:
                 old_pairs[src_bucket].~PairT();
         }
 
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            event.finish     = true;
+            event.elapsed_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            event.collision  = _num_filled ? (float)(_num_filled - bucket_main()) / _num_filled : 0;
+            hook(event);
+        }
+
 #if EMH_REHASH_LOG
         if (_num_filled > EMH_REHASH_LOG) {
             auto mbucket = bucket_main();
@@ -1432,9 +1872,51 @@ private:
     // Can we fit another element?
     inline bool check_expand_need()
     {
+#if EMH_SAFE_HASH
+        if (EMH_UNLIKELY(_hash_inter == 1)) {
+            //chains are flooded, draw a fresh seed and rehash once
+            _hash_inter = 2;
+            _seed = make_seed(_seed);
+            rehash(_mask + 1);
+            return true;
+        }
+#endif
         return reserve(_num_filled);
     }
 
+    //move the entry at cit out to node and erase it, returns the next iterator as erase() does
+    iterator extract_to(const_iterator cit, node_type& node)
+    {
+        iterator it(cit);
+#ifndef EMH_ITER_SAFE
+        //a lazy iterator reads its bitmask word on ++, once the bucket is cleared that would skip the next entry
+        if (it._from == (size_type)-1) it.init();
+#endif
+        const auto bucket = it._bucket;
+        const auto ebucket = extract_bucket(bucket, node);
+        if (ebucket == bucket)
+            return ++it;
+        it.clear(ebucket);
+        return it;
+    }
+
+    /// Returns the bucket cleared, if it isn't bucket its entry was moved into bucket.
+    size_type extract_bucket(const size_type bucket, node_type& node)
+    {
+        auto ebucket = bucket;
+        if (is_copy_trivially()) {
+            //the moved from key is unchanged for erase_bucket to hash
+            node.fill(std::move(EMH_KEY(_pairs, bucket)), std::move(EMH_VAL(_pairs, bucket)));
+            ebucket = erase_bucket(bucket);
+        } else {
+            //erase_bucket swaps the entry into the bucket it frees
+            ebucket = erase_bucket(bucket);
+            node.fill(std::move(EMH_KEY(_pairs, ebucket)), std::move(EMH_VAL(_pairs, ebucket)));
+        }
+        clear_bucket(ebucket);
+        return ebucket;
+    }
+
     void clear_bucket(size_type bucket)
     {
         EMH_CLS(bucket);
@@ -1448,12 +1930,14 @@ private:
     template<typename UType>
     size_type erase_key(const UType& key)
     {
-        const auto bucket = hash_key(key) & _mask;
+        const auto key_hash = hash_key(key);
+        const auto bucket = key_bucket(key_hash);
         if (EMH_EMPTY(bucket))
             return INACTIVE;
 
+        const auto fp = fprint_of(key_hash);
         auto next_bucket = EMH_BUCKET(_pairs, bucket);
-        const auto eqkey = _eq(key, EMH_KEY(_pairs, bucket));
+        const auto eqkey = EMH_FPEQ(bucket, fp) && _eq(key, EMH_KEY(_pairs, bucket));
         if (eqkey) {
             if (next_bucket == bucket)
                 return bucket;
@@ -1463,19 +1947,20 @@ private:
                 EMH_PKV(_pairs, bucket) = EMH_PKV(_pairs, next_bucket);
             else
                 EMH_PKV(_pairs, bucket).swap(EMH_PKV(_pairs, next_bucket));
+            EMH_FPMOV(bucket, next_bucket);
 
             EMH_BUCKET(_pairs, bucket) = (nbucket == next_bucket) ? bucket : nbucket;
             return next_bucket;
         } else if (next_bucket == bucket)
             return INACTIVE;
-        /* else if (EMH_UNLIKELY(bucket != hash_key(EMH_KEY(_pairs, bucket)) & _mask))
+        /* else if (EMH_UNLIKELY(bucket != key_bucket(hash_key(EMH_KEY(_pairs, bucket)))))
             return INACTIVE;
         */
 
         auto prev_bucket = bucket;
         while (true) {
             const auto nbucket = EMH_BUCKET(_pairs, next_bucket);
-            if (_eq(key, EMH_KEY(_pairs, next_bucket))) {
+            if (EMH_FPEQ(next_bucket, fp) && _eq(key, EMH_KEY(_pairs, next_bucket))) {
                 EMH_BUCKET(_pairs, prev_bucket) = (nbucket == next_bucket) ? prev_bucket : nbucket;
                 return next_bucket;
             }
@@ -1492,7 +1977,7 @@ private:
     template<typename UType, typename std::enable_if<!std::is_integral<UType>::value, size_type>::type = 0>
     size_type erase_key(const UType& key)
     {
-        const auto bucket = hash_key(key) & _mask;
+        const auto bucket = key_bucket(hash_key(key));
         if (EMH_EMPTY(bucket))
             return INACTIVE;
 
@@ -1534,7 +2019,7 @@ private:
     size_type erase_bucket(const size_type bucket)
     {
         const auto next_bucket = EMH_BUCKET(_pairs, bucket);
-        const auto main_bucket = hash_key(EMH_KEY(_pairs, bucket)) & _mask;
+        const auto main_bucket = key_bucket(hash_key(EMH_KEY(_pairs, bucket)));
         if (bucket == main_bucket) {
             if (bucket != next_bucket) {
                 const auto nbucket = EMH_BUCKET(_pairs, next_bucket);
@@ -1542,6 +2027,7 @@ private:
                     EMH_PKV(_pairs, bucket) = EMH_PKV(_pairs, next_bucket);
                 else
                     EMH_PKV(_pairs, bucket).swap(EMH_PKV(_pairs, next_bucket));
+                EMH_FPMOV(bucket, next_bucket);
                 EMH_BUCKET(_pairs, bucket) = (nbucket == next_bucket) ? bucket : nbucket;
             }
             return next_bucket;
@@ -1556,13 +2042,14 @@ private:
     template<typename K = KeyT>
     size_type find_filled_hash(const K& key, const size_t key_hash) const
     {
-        const auto bucket = key_hash & _mask;
+        const auto bucket = key_bucket((size_type)key_hash);
         if (EMH_EMPTY(bucket))
             return _num_buckets;
 
+        const auto fp = fprint_of((size_type)key_hash);
         auto next_bucket = bucket;
         while (true) {
-            if (_eq(key, EMH_KEY(_pairs, next_bucket)))
+            if (EMH_FPEQ(next_bucket, fp) && _eq(key, EMH_KEY(_pairs, next_bucket)))
                 return next_bucket;
 
             const auto nbucket = EMH_BUCKET(_pairs, next_bucket);
@@ -1578,16 +2065,18 @@ private:
     template<typename K = KeyT>
     size_type find_filled_bucket(const K& key) const
     {
-        const auto bucket = hash_key(key) & _mask;
+        const auto key_hash = hash_key(key);
+        const auto bucket = key_bucket(key_hash);
         if (EMH_EMPTY(bucket))
             return _num_buckets;
 
+        const auto fp = fprint_of(key_hash);
         auto next_bucket = bucket;
-//        else if (bucket != (hash_key(bucket_key) & _mask))
+//        else if (bucket != key_bucket(hash_key(bucket_key)))
 //            return _num_buckets;
 
         while (true) {
-            if (_eq(key, EMH_KEY(_pairs, next_bucket)))
+            if (EMH_FPEQ(next_bucket, fp) && _eq(key, EMH_KEY(_pairs, next_bucket)))
                 return next_bucket;
 
             const auto nbucket = EMH_BUCKET(_pairs, next_bucket);
@@ -1611,6 +2100,7 @@ private:
         new(_pairs + new_bucket) PairT(std::move(_pairs[kbucket]));
         if (is_triviall_destructable())
             _pairs[kbucket].~PairT();
+        EMH_FPMOV(new_bucket, kbucket);
 
         if (next_bucket == kbucket)
             EMH_BUCKET(_pairs, new_bucket) = new_bucket;
@@ -1630,13 +2120,27 @@ private:
     template<typename K=KeyT>
     size_type find_or_allocate(const K& key, bool& isempty)
     {
-        const auto bucket = hash_key(key) & _mask;
+        const auto key_hash = hash_key(key);
+        const auto bucket = find_or_allocate(key, key_hash, isempty);
+#if EMH_FINGERPRINT
+        if (isempty)
+            _fprint[bucket] = fprint_of(key_hash);
+#endif
+        return bucket;
+    }
+
+    template<typename K=KeyT>
+    size_type find_or_allocate(const K& key, const size_type key_hash, bool& isempty)
+    {
+        const auto bucket = key_bucket(key_hash);
         const auto& bucket_key = EMH_KEY(_pairs, bucket);
         if (EMH_EMPTY(bucket)) {
             isempty = true;
             return bucket;
         }
-        else if (_eq(key, bucket_key)) {
+
+        const auto fp = fprint_of(key_hash);
+        if (EMH_FPEQ(bucket, fp) && _eq(key, bucket_key)) {
             isempty = false;
             return bucket;
         }
@@ -1644,7 +2148,7 @@ private:
         isempty = true;
         auto next_bucket = EMH_BUCKET(_pairs, bucket);
         //check current bucket_key is in main bucket or not
-        const auto kmain_bucket = hash_key(bucket_key) & _mask;
+        const auto kmain_bucket = key_bucket(hash_key(bucket_key));
         if (kmain_bucket != bucket)
             return kickout_bucket(kmain_bucket, bucket);
         else if (next_bucket == bucket)
@@ -1652,13 +2156,19 @@ private:
 
 #if EMH_LRU_SET
         auto prev_bucket = bucket;
+#endif
+#if EMH_SAFE_HASH
+        uint32_t csize = 1;
 #endif
         //find next linked bucket and check key, if lru is set then swap current key with prev_bucket
         while (true) {
-            if (EMH_UNLIKELY(_eq(key, EMH_KEY(_pairs, next_bucket)))) {
+            if (EMH_UNLIKELY(EMH_FPEQ(next_bucket, fp) && _eq(key, EMH_KEY(_pairs, next_bucket)))) {
                 isempty = false;
 #if EMH_LRU_SET
                 EMH_PKV(_pairs, next_bucket).swap(EMH_PKV(_pairs, prev_bucket));
+#if EMH_FINGERPRINT
+                std::swap(_fprint[next_bucket], _fprint[prev_bucket]);
+#endif
                 return prev_bucket;
 #else
                 return next_bucket;
@@ -1668,6 +2178,9 @@ private:
 #if EMH_LRU_SET
             prev_bucket = next_bucket;
 #endif
+#if EMH_SAFE_HASH
+            csize += 1;
+#endif
 
             const auto nbucket = EMH_BUCKET(_pairs, next_bucket);
             if (nbucket == next_bucket)
@@ -1675,11 +2188,39 @@ private:
             next_bucket = nbucket;
         }
 
+#if EMH_SAFE_HASH
+        if (EMH_UNLIKELY(csize > EMH_SAFE_CHAIN) && _hash_inter == 0)
+            _hash_inter = 1;
+#endif
+
         //find a new empty and link it to tail, TODO link after main bucket?
         const auto new_bucket = find_empty_bucket(next_bucket, bucket);// : find_empty_bucket(next_bucket);
         return EMH_BUCKET(_pairs, next_bucket) = new_bucket;
     }
 
+    //a multiply-shift of 32 random bits is much cheaper than the division by _num_buckets
+    template<typename RNG>
+    size_type random_bucket(RNG& rng) const
+    {
+        if (sizeof(size_type) <= 4 && (RNG::max)() - (RNG::min)() >= 0xFFFFFFFFu)
+            return (size_type)(((uint64_t)(uint32_t)(rng() - (RNG::min)()) * _num_buckets) >> 32);
+        return (size_type)(rng() % _num_buckets);
+    }
+
+    template<typename RNG>
+    size_type sample_bucket(RNG& rng) const
+    {
+        if (_num_filled == 0)
+            return _num_buckets;
+
+        auto bucket = random_bucket(rng);
+        for (int tries = 1; EMH_EMPTY(bucket) && tries < 32; tries++)
+            bucket = random_bucket(rng);
+        while (EMH_EMPTY(bucket))
+            bucket = bucket + 1 == _num_buckets ? 0 : bucket + 1;
+        return bucket;
+    }
+
     // key is not in this map. Find a place to put it.
     size_type find_empty_bucket(const size_type bucket_from, const size_type main_bucket)
     {
@@ -1697,6 +2238,9 @@ private:
             return bucket_from + CTZ(bmask);
 #endif
 
+        //the table always keeps an empty bucket, all-zero words would make the scans below
+        //spin or take CTZ(0)
+        assert(_num_filled < _num_buckets);
         const auto qmask = _mask / SIZE_BIT;
         if (0) {
             const size_type step = (main_bucket - SIZE_BIT / 4) & qmask;
@@ -1707,13 +2251,24 @@ private:
 
         //auto next_bucket = (bucket_from + 0 * SIZE_BIT) & qmask;
         auto& last = EMH_BUCKET(_pairs, _num_buckets);
+#if EMH_SIMD_SCAN
+        //go on from the word the last empty bucket was found in, then wrap around
+        const auto* words = (const size_t*)_bitmask;
+        const auto from = wrap_word(last, qmask);
+        if (EMH_LIKELY(words[from] != 0))
+            return (last = from) * SIZE_BIT + CTZ(words[from]);
+        last = (size_type)emhash::first_word(words, from + 1, qmask + 1);
+        if (last > qmask)
+            last = (size_type)emhash::first_word(words, 0, from);
+        return last * SIZE_BIT + CTZ(words[last]);
+#endif
         for (; ; ) {
-            last &= qmask;
+            last = wrap_word(last, qmask);
             const auto bmask2 = *((size_t*)_bitmask + last);
             if (bmask2 != 0)
                 return last * SIZE_BIT + CTZ(bmask2);
 #if 1
-            const auto next1 = (qmask / 2 + last) & qmask;
+            const auto next1 = wrap_word(qmask / 2 + last, qmask);
             const auto bmask1 = *((size_t*)_bitmask + next1);
             if (bmask1 != 0) {
                 last = next1;
@@ -1753,17 +2308,48 @@ private:
         if (EMH_LIKELY(bmask != 0))
             return bucket_from + CTZ(bmask);
 
+        assert(_num_filled < _num_buckets); //as in find_empty_bucket
         const auto qmask = _mask / SIZE_BIT;
-        for (auto last = (bucket_from + _mask) & qmask; ;) {
+#if EMH_SIMD_SCAN
+        const auto* words = (const size_t*)_bitmask;
+        const auto from = wrap_word(bucket_from + _mask, qmask);
+        if (EMH_LIKELY(words[from] != 0))
+            return from * SIZE_BIT + CTZ(words[from]);
+        auto word = (size_type)emhash::first_word(words, from + 1, qmask + 1);
+        if (word > qmask)
+            word = (size_type)emhash::first_word(words, 0, from);
+        return word * SIZE_BIT + CTZ(words[word]);
+#endif
+        for (auto last = wrap_word(bucket_from + _mask, qmask); ;) {
             const auto bmask2 = *((size_t*)_bitmask + last);// & 0xF0F0F0F0FF0FF0FFull;
             if (EMH_LIKELY(bmask2 != 0))
                 return last * SIZE_BIT + CTZ(bmask2);
-            last = (last + 1) & qmask;
+            last = wrap_word(last + 1, qmask);
         }
 
         return 0;
     }
 
+    //qmask is the last bitmask word, a power of two minus one unless EMH_FAST_RANGE
+    size_type wrap_word(const size_type word, const size_type qmask) const
+    {
+#if EMH_FAST_RANGE
+        return word <= qmask ? word : word % (qmask + 1);
+#else
+        return word & qmask;
+#endif
+    }
+
+    //main bucket of a hash, EMH_FAST_RANGE maps the mixed high 32 bits onto [0, _num_buckets)
+    size_type key_bucket(const size_type key_hash) const
+    {
+#if EMH_FAST_RANGE
+        return (size_type)((((uint64_t)key_hash * 0x9E3779B97F4A7C15ull) >> 32) * _num_buckets >> 32);
+#else
+        return key_hash & _mask;
+#endif
+    }
+
     size_type find_last_bucket(size_type main_bucket) const
     {
         auto next_bucket = EMH_BUCKET(_pairs, main_bucket);
@@ -1794,12 +2380,22 @@ private:
 
     size_type find_unique_bucket(const KeyT& key)
     {
-        const size_type bucket = hash_key(key) & _mask;
+        const auto key_hash = hash_key(key);
+        const auto bucket = find_unique_hash(key_hash);
+#if EMH_FINGERPRINT
+        _fprint[bucket] = fprint_of(key_hash);
+#endif
+        return bucket;
+    }
+
+    size_type find_unique_hash(const size_type key_hash)
+    {
+        const size_type bucket = key_bucket(key_hash);
         if (EMH_EMPTY(bucket))
             return bucket;
 
         //check current bucket_key is in main bucket or not
-        const auto kmain_bucket = hash_key(EMH_KEY(_pairs, bucket)) & _mask;
+        const auto kmain_bucket = key_bucket(hash_key(EMH_KEY(_pairs, bucket)));
         if (EMH_UNLIKELY(kmain_bucket != bucket))
             return kickout_bucket(kmain_bucket, bucket);
 
@@ -1851,36 +2447,110 @@ private:
     }
 #endif
 
+    //the hash_batch.hpp mixer equal to hash64, void if there is none
+#if !EMH_INT_HASH || !defined(EMH_BATCH_INLINE)
+    using int_batch = void;
+#elif (__SIZEOF_INT128__ || _WIN64) && EMH_INT_HASH == 1
+    using int_batch = emhash::fold_hash<false>;
+#elif EMH_INT_HASH == 2
+    using int_batch = emhash::mur3_hash;
+#elif EMH_INT_HASH == 3
+    using int_batch = emhash::mix_hash<false>;
+#elif EMH_INT_HASH != 1 && !EMH_WYHASH64
+    using int_batch = emhash::mix13_hash;
+#else
+    using int_batch = void;
+#endif
+
     template<typename UType, typename std::enable_if<std::is_integral<UType>::value, size_type>::type = 0>
-    inline size_type hash_key(const UType key) const
+    inline uint64_t hash_raw(const UType key) const
     {
 #if EMH_INT_HASH
         return hash64(key);
 #elif EMH_IDENTITY_HASH
         return key + (key >> 24);
 #else
-        return (size_type)_hasher(key);
+        return _hasher(key);
 #endif
     }
 
-    template<typename UType, typename std::enable_if<std::is_same<UType, std::string>::value, size_type>::type = 0>
-    inline size_type hash_key(const UType& key) const
+    template<typename UType, typename std::enable_if<is_string<UType>::value, size_type>::type = 0>
+    inline uint64_t hash_raw(const UType& key) const
     {
-#if EMH_WY_HASH
+#if EMH_AES_HASH
+        return emhash::aes_hash(key.data(), key.size());
+#elif EMH_WY_HASH
         return wyhash(key.data(), key.size(), 0);
 #else
-        return (size_type)_hasher(key);
+        return _hasher(key);
+#endif
+    }
+
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !is_string<UType>::value, size_type>::type = 0>
+    inline uint64_t hash_raw(const UType& key) const
+    {
+        return _hasher(key);
+    }
+
+#ifdef EMH_BATCH_INLINE
+    template<typename UType, typename std::enable_if<std::is_integral<UType>::value && !std::is_void<int_batch>::value, size_type>::type = 0>
+    void hash_batch_raw(const UType* keys, uint64_t* out, size_t n) const
+    {
+        emhash::hash_batch<int_batch>(keys, out, n);
+    }
 #endif
+
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value || std::is_void<int_batch>::value, size_type>::type = 0>
+    void hash_batch_raw(const UType* keys, uint64_t* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = hash_raw(keys[i]);
+    }
+
+#if EMH_SAFE_HASH
+    static uint64_t mix_seed(uint64_t h)
+    {
+        h ^= h >> 33; h *= UINT64_C(0xff51afd7ed558ccd);
+        h ^= h >> 33; h *= UINT64_C(0xc4ceb9fe1a85ec53);
+        return h ^ (h >> 33);
     }
 
-    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !std::is_same<UType, std::string>::value, size_type>::type = 0>
+    //the seed comes from the map address and steady_clock, it is cheap but guessable by anyone who can
+    //observe those, and keys whose full 64-bit hashes collide still collide under every seed
+    static uint64_t make_seed(uint64_t salt)
+    {
+        return mix_seed(salt ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    //a xor alone would only relabel buckets, the mixer spreads keys colliding in the low bits
+    inline uint64_t hash_seed(uint64_t h) const
+    {
+        return mix_seed(h ^ _seed);
+    }
+#endif
+
+    template<typename UType>
     inline size_type hash_key(const UType& key) const
     {
-        return (size_type)_hasher(key);
+#if EMH_SAFE_HASH
+        return (size_type)hash_seed(hash_raw(key));
+#else
+        return (size_type)hash_raw(key);
+#endif
+    }
+
+    //keys of a chain share the bits key_bucket takes from their hash, the multiply spreads all of them
+    //to the top (by another constant than EMH_FAST_RANGE)
+    static inline fprint_t fprint_of(size_type key_hash)
+    {
+        return (fprint_t)(((uint64_t)key_hash * UINT64_C(0xff51afd7ed558ccd)) >> (64 - 8 * sizeof(fprint_t)));
     }
 
 private:
     uint8_t* _bitmask;
+#if EMH_FINGERPRINT
+    fprint_t* _fprint;
+#endif
     PairT*    _pairs;
     HashT     _hasher;
     EqT       _eq;
@@ -1889,6 +2559,10 @@ private:
 
     size_type _num_filled;
     uint32_t  _mlf;
+#if EMH_SAFE_HASH
+    uint64_t  _seed;
+    uint32_t  _hash_inter; //0 seeded, 1 flooding detected, 2 reseeded
+#endif
 
 private:
     static constexpr uint32_t BIT_PACK = sizeof(uint64_t);
@@ -36,10 +36,38 @@
 #include <functional>
 #include <iterator>
 #include <algorithm>
+#include <chrono>
 #include <memory>
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+#include <string_view>
+#endif
+
+#include "hash_stats.hpp"
+#include "hash_event.hpp"
+
+#if EMH_AES_HASH
+    #include "hash_aes.hpp"
+#endif
+
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
+//EMH_INT_HASH: hash_batch() runs the hash64 mixer over 4 or 8 integer keys at once with the
+//AVX2/AVX-512 kernels of hash_batch.hpp if it is found next to this header
+#if EMH_INT_HASH && defined(__has_include)
+    #if __has_include("hash_batch.hpp")
+    #include "hash_batch.hpp"
+    #endif
+#endif
 
 #undef  EMH_NEW
+#undef  EMH_NEW_ARGS
 #undef  EMH_EMPTY
+#undef  EMH_EQHASH
 
 // likely/unlikely
 #if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
@@ -50,13 +78,44 @@
 #    define EMH_UNLIKELY(condition) condition
 #endif
 
+//EMH_SAFE_HASH: hash_key runs through a 64-bit mixer keyed by a per-instance seed, an insert walking
+//a chain longer than EMH_SAFE_CHAIN draws a new seed with a one-time rehash
+#if EMH_SAFE_HASH && !defined(EMH_SAFE_CHAIN)
+#    define EMH_SAFE_CHAIN 32
+#endif
+
+//EMH_FAST_RANGE: the bucket count is not rounded up to a power of two, the main bucket is picked by
+//a multiply-shift range reduction and the table grows by EMH_FAST_RANGE percent (25-50) instead of doubling
+
+//EMH_CACHE_HASH: the full hash of every slot is kept in _hashes, rehash and erase never call
+//the hasher again and a chain walk compares the full hash before calling EqT
+#if EMH_CACHE_HASH && EMH_SORT
+    #error "EMH_CACHE_HASH does not keep _hashes sorted with EMH_SORT"
+#endif
+
+//EMH_SPARSE_CLEAR: clear() walks the used chains instead of resetting the whole index below
+//1/EMH_SPARSE_CLEAR load, the divisor must be at least 1
+#if defined(EMH_SPARSE_CLEAR) && EMH_SPARSE_CLEAR < 1
+    #error "EMH_SPARSE_CLEAR must be 1 or more"
+#endif
+
 #define EMH_EMPTY(n) (0 > (int)(_index[n].next))
+#if EMH_CACHE_HASH
+#define EMH_EQHASH(n, key_hash) (((size_type)(key_hash) & ~_mask) == (_index[n].slot & ~_mask) && _hashes[_index[n].slot & _mask] == key_hash)
+#define EMH_NEW_ARGS(bucket, key_hash, ...) \
+    new(_pairs + _num_filled) value_type(__VA_ARGS__); \
+    _hashes[_num_filled] = key_hash; \
+    _etail = bucket; \
+    _index[bucket] = {bucket, _num_filled++ | ((size_type)(key_hash) & ~_mask)}
+#else
 #define EMH_EQHASH(n, key_hash) (((size_type)(key_hash) & ~_mask) == (_index[n].slot & ~_mask))
 //#define EMH_EQHASH(n, key_hash) ((size_type)(key_hash - _index[n].slot) & ~_mask) == 0
-#define EMH_NEW(key, val, bucket, key_hash) \
-    new(_pairs + _num_filled) value_type(key, val); \
+#define EMH_NEW_ARGS(bucket, key_hash, ...) \
+    new(_pairs + _num_filled) value_type(__VA_ARGS__); \
     _etail = bucket; \
     _index[bucket] = {bucket, _num_filled++ | ((size_type)(key_hash) & ~_mask)}
+#endif
+#define EMH_NEW(key, val, bucket, key_hash) EMH_NEW_ARGS(bucket, key_hash, key, val)
 
 namespace emhash8 {
 
@@ -66,8 +125,81 @@ struct DefaultPolicy {
     static constexpr size_t cacheline_size = 64U;
 };
 
+#ifndef EMH8_KEY_TRAITS //shared with hash_set8.hpp
+#define EMH8_KEY_TRAITS
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
+/// True if T declares is_transparent, like std::equal_to<> or a string hasher taking string_view.
+template<typename T, typename = void> struct is_transparent : std::false_type {};
+template<typename T> struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type> : std::true_type {};
+
+/// std::string and string_view share the EMH_WYHASH_HASH and EMH_AES_HASH paths, so a transparent lookup hashes alike.
+template<typename T> struct is_string : std::is_same<T, std::string> {};
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<> struct is_string<std::string_view> : std::true_type {};
+#endif
+
+/// The type a lookup key K is hashed and compared as: KeyT if K converts to it and a functor isn't transparent,
+/// a string_view for anything a std::string table can view, so that char arrays take the string hash path.
+template<typename KeyT, typename K, bool transparent> struct lookup_key
+{
+    using type = typename std::conditional<std::is_convertible<const K&, KeyT>::value, KeyT, K>::type;
+};
+template<typename KeyT, typename K> struct lookup_key<KeyT, K, true> { using type = K; };
+#if __cplusplus >= 201703L || _MSVC_LANG >= 201703L
+template<typename K> struct lookup_key<std::string, K, true>
+{
+    using type = typename std::conditional<!is_string<K>::value && std::is_convertible<const K&, std::string_view>::value, std::string_view, K>::type;
+};
+#endif
+#endif
+
+/// Table health returned by stats(), shared with the other emhash tables.
+using HashStats = emhash::HashStats;
+
+/// Passed to the rehash hook, shared with the other emhash tables.
+using RehashEvent = emhash::RehashEvent;
+using RehashHook  = emhash::RehashHook;
+
+//count the trailing zero bits, n != 0. Shared with GroupMap and OrderedMap
+static inline uint32_t CTZ(uint64_t n)
+{
+#if _WIN32
+    unsigned long index;
+    _BitScanForward64(&index, n);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctzll(n);
+#endif
+}
+
+//count the set bits, used by OrderedMap to rank its slots
+static inline uint32_t POPCOUNT(uint64_t n)
+{
+#if _WIN32
+    return (uint32_t)__popcnt64(n);
+#else
+    return (uint32_t)__builtin_popcountll(n);
+#endif
+}
+
+//std::hash of an integer is the identity, GroupMap and OrderedMap take their probe start and
+//fingerprint from this mix of it
+static inline uint64_t mix_hash(uint64_t hash)
+{
+#if __SIZEOF_INT128__
+    __uint128_t r = hash; r *= UINT64_C(11400714819323198485);
+    return (uint64_t)(r >> 64) + (uint64_t)r;
+#else
+    uint64_t x = hash;
+    x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+#endif
+}
+
 template<typename KeyT, typename ValueT,
-         typename HashT = std::hash<KeyT>,
+         typename HashT = default_hash<KeyT>,
          typename EqT = std::equal_to<KeyT>,
          typename Allocator = std::allocator<std::pair<KeyT, ValueT>>, //never used
          typename Policy = DefaultPolicy> //never used
@@ -77,6 +209,9 @@ class HashMap
     constexpr static float EMH_DEFAULT_LOAD_FACTOR = 0.80f;
 #endif
     constexpr static float EMH_MIN_LOAD_FACTOR     = 0.25f; //< 0.5
+#ifndef EMH_SPARSE_CLEAR
+    constexpr static uint32_t EMH_SPARSE_CLEAR     = 64; //clear() walks the chains below 1/64 load
+#endif
     constexpr static uint32_t EMH_CACHE_LINE_SIZE  = 64; //debug only
 
 public:
@@ -100,6 +235,11 @@ public:
     constexpr static size_type INACTIVE = 0-1u;
     //constexpr uint32_t END      = 0-0x1u;
     constexpr static size_type EAD      = 2;
+#if EMH_CACHE_HASH
+    constexpr static size_t SLOT_BYTES  = sizeof(value_type) + sizeof(uint64_t);
+#else
+    constexpr static size_t SLOT_BYTES  = sizeof(value_type);
+#endif
 
     struct Index
     {
@@ -218,12 +358,92 @@ public:
         const value_type* kv_;
     };
 
+    /// Owns a key and value moved out by extract(), insert(node_type&&) moves them into a map.
+    /// Unlike std::unordered_map::node_type nothing is allocated, the pair lives in the handle.
+    class node_type
+    {
+    public:
+        using key_type    = KeyT;
+        using mapped_type = ValueT;
+
+        node_type() noexcept : _filled(false) {}
+        node_type(node_type&& rhs) : _filled(false) { *this = std::move(rhs); }
+        ~node_type() { reset(); }
+
+        node_type& operator=(node_type&& rhs)
+        {
+            if (this != &rhs) {
+                reset();
+                if (rhs._filled) {
+                    fill(std::move(rhs._kv.first), std::move(rhs._kv.second));
+                    rhs.reset();
+                }
+            }
+            return *this;
+        }
+
+        bool empty() const noexcept { return !_filled; }
+        explicit operator bool() const noexcept { return _filled; }
+        KeyT& key() { return _kv.first; }
+        const KeyT& key() const { return _kv.first; }
+        ValueT& mapped() { return _kv.second; }
+        const ValueT& mapped() const { return _kv.second; }
+
+    private:
+        friend class HashMap;
+
+        template<typename K, typename V>
+        void fill(K&& key, V&& val)
+        {
+            new(&_kv) value_type(std::forward<K>(key), std::forward<V>(val));
+            _filled = true;
+        }
+
+        void reset()
+        {
+            if (_filled)
+                _kv.~value_type();
+            _filled = false;
+        }
+
+        union { value_type _kv; };
+        bool _filled;
+    };
+
+    struct insert_return_type
+    {
+        iterator  position;
+        bool      inserted;
+        node_type node;
+    };
+
+    /// Enables the K overloads that insert or erase when both HashT and EqT are transparent,
+    /// a K which is a KeyT or an iterator keeps the plain overloads.
+    template<typename K>
+    using if_transparent = typename std::enable_if<is_transparent<HashT>::value && is_transparent<EqT>::value
+        && !std::is_same<typename std::decay<K>::type, KeyT>::value
+        && !std::is_convertible<K, iterator>::value && !std::is_convertible<K, const_iterator>::value, int>::type;
+
+    /// A lookup argument K as hashed and compared, a temporary KeyT if HashT or EqT isn't transparent.
+    template<typename K>
+    using key_arg = const typename lookup_key<KeyT, typename std::decay<K>::type, is_transparent<HashT>::value && is_transparent<EqT>::value>::type&;
+
     void init(size_type bucket, float mlf = EMH_DEFAULT_LOAD_FACTOR)
     {
         _pairs = nullptr;
         _index = nullptr;
+#if EMH_CACHE_HASH
+        _hashes = nullptr;
+#endif
         _mask  = _num_buckets = 0;
         _num_filled = 0;
+#if EMH_FAST_RANGE
+        _num_main = 0;
+#endif
+#if EMH_SAFE_HASH
+        _seed = make_seed((uint64_t)this);
+        _hash_inter = 0;
+#endif
         _mlf = (uint32_t)((1 << 27) / EMH_DEFAULT_LOAD_FACTOR);
         max_load_factor(mlf);
         rehash(bucket);
@@ -239,6 +459,9 @@ public:
         if (rhs.load_factor() > EMH_MIN_LOAD_FACTOR) {
             _pairs = alloc_bucket((size_type)(rhs._num_buckets * rhs.max_load_factor()) + 4);
             _index = alloc_index(rhs._num_buckets);
+#if EMH_CACHE_HASH
+            _hashes = (uint64_t*)malloc(((uint64_t)(rhs._num_buckets * rhs.max_load_factor()) + 4) * sizeof(uint64_t));
+#endif
             clone(rhs);
         } else {
             init(rhs._num_filled + 2, rhs.max_load_factor());
@@ -287,6 +510,10 @@ public:
             free(_pairs); free(_index);
             _index = alloc_index(rhs._num_buckets);
             _pairs = alloc_bucket((size_type)(rhs._num_buckets * rhs.max_load_factor()) + 4);
+#if EMH_CACHE_HASH
+            free(_hashes);
+            _hashes = (uint64_t*)malloc(((uint64_t)(rhs._num_buckets * rhs.max_load_factor()) + 4) * sizeof(uint64_t));
+#endif
         }
 
         clone(rhs);
@@ -324,6 +551,10 @@ public:
         clearkv();
         free(_pairs);
         free(_index);
+#if EMH_CACHE_HASH
+        free(_hashes);
+        _hashes = nullptr;
+#endif
         _index = nullptr;
         _pairs = nullptr;
     }
@@ -337,13 +568,23 @@ public:
         _mlf         = rhs._mlf;
         _last        = rhs._last;
         _mask        = rhs._mask;
+#if EMH_FAST_RANGE
+        _num_main    = rhs._num_main;
+#endif
 #if EMH_HIGH_LOAD
         _ehead       = rhs._ehead;
 #endif
         _etail       = rhs._etail;
+#if EMH_SAFE_HASH
+        _seed        = rhs._seed;
+        _hash_inter  = rhs._hash_inter;
+#endif
 
         auto opairs  = rhs._pairs;
         memcpy((char*)_index, (char*)rhs._index, (_num_buckets + EAD) * sizeof(Index));
+#if EMH_CACHE_HASH
+        memcpy((char*)_hashes, (char*)rhs._hashes, _num_filled * sizeof(uint64_t));
+#endif
 
         if (is_copy_trivially()) {
             memcpy((char*)_pairs, (char*)opairs, _num_filled * sizeof(value_type));
@@ -359,15 +600,25 @@ public:
         std::swap(_hasher, rhs._hasher);
         std::swap(_pairs, rhs._pairs);
         std::swap(_index, rhs._index);
+#if EMH_CACHE_HASH
+        std::swap(_hashes, rhs._hashes);
+#endif
         std::swap(_num_buckets, rhs._num_buckets);
         std::swap(_num_filled, rhs._num_filled);
         std::swap(_mask, rhs._mask);
+#if EMH_FAST_RANGE
+        std::swap(_num_main, rhs._num_main);
+#endif
         std::swap(_mlf, rhs._mlf);
         std::swap(_last, rhs._last);
 #if EMH_HIGH_LOAD
         std::swap(_ehead, rhs._ehead);
 #endif
         std::swap(_etail, rhs._etail);
+#if EMH_SAFE_HASH
+        std::swap(_seed, rhs._seed);
+        std::swap(_hash_inter, rhs._hash_inter);
+#endif
     }
 
     // -------------------------------------------------------------
@@ -393,16 +644,50 @@ public:
     const value_type* values() const { return _pairs; }
     const Index* index() const { return _index; }
 
+    /// Uniform random element in O(1) as the pairs are dense, end() if empty.
+    /// rng is a uniform random bit generator such as std::mt19937_64.
+    template<typename RNG>
+    iterator sample(RNG& rng)
+    {
+        return {this, _num_filled == 0 ? 0 : random_slot(rng)};
+    }
+
+    template<typename RNG>
+    const_iterator sample(RNG& rng) const
+    {
+        return {this, _num_filled == 0 ? 0 : random_slot(rng)};
+    }
+
+    /// Writes k iterators to uniform random elements to out (with replacement), none if empty.
+    template<typename RNG, typename OutIt>
+    OutIt sample_n(RNG& rng, size_type k, OutIt out)
+    {
+        for (size_type i = 0; _num_filled > 0 && i < k; i++)
+            *out++ = iterator(this, random_slot(rng));
+        return out;
+    }
+
     size_type size() const { return _num_filled; }
     bool empty() const { return _num_filled == 0; }
     size_type bucket_count() const { return _num_buckets; }
 
     /// Returns average number of elements per bucket.
-    float load_factor() const { return static_cast<float>(_num_filled) / (_mask + 1); }
+    float load_factor() const { return static_cast<float>(_num_filled) / (main_mask() + 1); }
 
     HashT& hash_function() const { return _hasher; }
     EqT& key_eq() const { return _eq; }
 
+    /// Writes hash_key(keys[i]) to out[i], integer keys take the SIMD kernels of hash_batch.hpp
+    /// with EMH_INT_HASH, other keys are hashed one at a time.
+    void hash_batch(const KeyT* keys, uint64_t* out, size_t n) const
+    {
+        hash_batch_raw(keys, out, n);
+#if EMH_SAFE_HASH
+        for (size_t i = 0; i < n; i++)
+            out[i] = hash_seed(out[i]);
+#endif
+    }
+
     void max_load_factor(float mlf)
     {
         if (mlf < 0.992 && mlf > EMH_MIN_LOAD_FACTOR) {
@@ -415,6 +700,60 @@ public:
     constexpr size_type max_size() const { return (1ull << (sizeof(size_type) * 8 - 1)); }
     constexpr size_type max_bucket_count() const { return max_size(); }
 
+    /// Always available unlike dump_statics(), only every 1/sample_ratio-th bucket is walked
+    HashStats stats(float sample_ratio = 1.0f) const
+    {
+        HashStats st = {};
+        st.size        = _num_filled;
+        st.buckets     = _num_buckets;
+        st.load_factor = load_factor();
+        if (_num_buckets > 0)
+            st.bytes = (uint64_t)(EAD + _num_buckets) * sizeof(Index) + (uint64_t)((size_type)(_num_buckets * max_load_factor()) + 4) * SLOT_BYTES;
+        if (_num_filled == 0)
+            return st;
+
+        const size_type step = sample_ratio >= 1.0f || sample_ratio <= 0 ? 1 : (size_type)(1 / sample_ratio);
+        size_t occupied = 0, mains = 0, hits = 0, hit_lines = 0, miss_lines = 0;
+        for (size_type bucket = 0; bucket < _num_buckets; bucket += step) {
+            st.sampled ++;
+            auto next_bucket = _index[bucket].next;
+            if ((int)next_bucket < 0) {
+                st.chains[0] ++;
+                miss_lines ++;
+                continue;
+            }
+
+            //a miss stops at once on a bucket held by another chain
+            occupied ++;
+            if (hash_main(bucket) != bucket) {
+                miss_lines ++;
+                continue;
+            }
+
+            //walk the index chain from here, a hit also reads its slot in _pairs
+            size_t lines = 1, chain_size = 1, chain_hit = 2;
+            for (auto cur_bucket = bucket; next_bucket != cur_bucket; ) {
+                if ((uint64_t)(_index + next_bucket) / EMH_CACHE_LINE_SIZE != (uint64_t)(_index + cur_bucket) / EMH_CACHE_LINE_SIZE)
+                    lines ++;
+                chain_size ++;
+                chain_hit += lines + 1;
+                cur_bucket  = next_bucket;
+                next_bucket = _index[cur_bucket].next;
+            }
+
+            miss_lines += lines;
+            mains ++;
+            hits += chain_size;
+            hit_lines += chain_hit;
+            st.chains[chain_size < 16 ? chain_size : 16] ++;
+        }
+
+        st.main_ratio = occupied ? (float)mains / occupied : 0;
+        st.hit_lines  = hits ? (float)hit_lines / hits : 0;
+        st.miss_lines = (float)miss_lines / st.sampled;
+        return st;
+    }
+
 #if EMH_STATIS
     //Returns the bucket number where the element with key k is located.
     size_type bucket(const KeyT& key) const
@@ -549,19 +888,19 @@ public:
     template<typename K=KeyT>
     iterator find(const K& key) noexcept
     {
-        return {this, find_filled_slot(key)};
+        return {this, find_filled_slot(static_cast<key_arg<K>>(key))};
     }
 
     template<typename K=KeyT>
     const_iterator find(const K& key) const noexcept
     {
-        return {this, find_filled_slot(key)};
+        return {this, find_filled_slot(static_cast<key_arg<K>>(key))};
     }
 
     template<typename K=KeyT>
     ValueT& at(const K& key)
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         //throw
         return _pairs[slot].second;
     }
@@ -569,7 +908,7 @@ public:
     template<typename K=KeyT>
     const ValueT& at(const K& key) const
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         //throw
         return _pairs[slot].second;
     }
@@ -587,15 +926,15 @@ public:
     template<typename K=KeyT>
     bool contains(const K& key) const noexcept
     {
-        return find_filled_slot(key) != _num_filled;
+        return find_filled_slot(static_cast<key_arg<K>>(key)) != _num_filled;
     }
 
     template<typename K=KeyT>
     size_type count(const K& key) const noexcept
     {
-        return find_filled_slot(key) == _num_filled ? 0 : 1;
+        return find_filled_slot(static_cast<key_arg<K>>(key)) == _num_filled ? 0 : 1;
         //return find_sorted_bucket(key) == END ? 0 : 1;
-        //return find_hash_bucket(key) == END ? 0 : 1;
+        //return find_hash_bucket(static_cast<key_arg<K>>(key)) == END ? 0 : 1;
     }
 
     template<typename K=KeyT>
@@ -626,10 +965,73 @@ public:
         }
     }
 
+    /// Move the entry out of the map, KeyT and ValueT are moved and never copied.
+    node_type extract(const_iterator cit)
+    {
+        node_type node;
+        extract_to(cit, node);
+        return node;
+    }
+
+    /// An empty node_type if key isn't found.
+    node_type extract(const KeyT& key)
+    {
+        node_type node;
+        const auto it = find(key);
+        if (it != end())
+            extract_to(it, node);
+        return node;
+    }
+
+    /// Move the key and value of node into the map, node keeps them if the key is found.
+    insert_return_type insert(node_type&& node)
+    {
+        if (node.empty())
+            return {end(), false, node_type()};
+
+        const auto result = try_emplace(std::move(node._kv.first), std::move(node._kv.second));
+        if (result.second)
+            node.reset();
+        return {result.first, result.second, std::move(node)};
+    }
+
+    /// Move the entries pred accepts, and whose key dst doesn't have, into dst. pred is called
+    /// once per entry: the first pass marks the slots to move, so that dst is reserved once.
+    template<typename Pred>
+    size_type transfer_if(HashMap& dst, Pred pred)
+    {
+        if (&dst == this)
+            return 0;
+
+        auto* marks = (uint64_t*)calloc(_num_filled / 64 + 1, sizeof(uint64_t));
+        size_type matched = 0;
+        for (size_type slot = 0; slot < _num_filled; slot++) {
+            if (pred(_pairs[slot]) && !dst.contains(_pairs[slot].first)) {
+                marks[slot / 64] |= 1ull << (slot % 64);
+                matched ++;
+            }
+        }
+
+        if (matched > 0)
+            dst.reserve(dst.size() + matched, false);
+        //extract_to moves the last pair into the slot, going down it has been visited already
+        node_type node;
+        for (auto slot = _num_filled; slot-- > 0; ) {
+            if ((marks[slot / 64] >> (slot % 64)) & 1) {
+                extract_to(const_iterator(this, slot), node);
+                dst.insert_unique(std::move(node._kv.first), std::move(node._kv.second));
+                node.reset();
+            }
+        }
+        free(marks);
+        return matched;
+    }
+
     /// Returns the matching ValueT or nullptr if k isn't found.
-    bool try_get(const KeyT& key, ValueT& val) const noexcept
+    template<typename K=KeyT>
+    bool try_get(const K& key, ValueT& val) const noexcept
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         const auto found = slot != _num_filled;
         if (found) {
             val = _pairs[slot].second;
@@ -638,23 +1040,26 @@ public:
     }
 
     /// Returns the matching ValueT or nullptr if k isn't found.
-    ValueT* try_get(const KeyT& key) noexcept
+    template<typename K=KeyT>
+    ValueT* try_get(const K& key) noexcept
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         return slot != _num_filled ? &_pairs[slot].second : nullptr;
     }
 
     /// Const version of the above
-    ValueT* try_get(const KeyT& key) const noexcept
+    template<typename K=KeyT>
+    ValueT* try_get(const K& key) const noexcept
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         return slot != _num_filled ? &_pairs[slot].second : nullptr;
     }
 
     /// set value if key exist
-    bool try_set(const KeyT& key, const ValueT& val) noexcept
+    template<typename K=KeyT>
+    bool try_set(const K& key, const ValueT& val) noexcept
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         if (slot == _num_filled)
             return false;
 
@@ -663,9 +1068,10 @@ public:
     }
 
     /// set value if key exist
-    bool try_set(const KeyT& key, ValueT&& val) noexcept
+    template<typename K=KeyT>
+    bool try_set(const K& key, ValueT&& val) noexcept
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         if (slot == _num_filled)
             return false;
 
@@ -674,9 +1080,10 @@ public:
     }
 
     /// Convenience function.
-    ValueT get_or_return_default(const KeyT& key) const noexcept
+    template<typename K=KeyT>
+    ValueT get_or_return_default(const K& key) const noexcept
     {
-        const auto slot = find_filled_slot(key);
+        const auto slot = find_filled_slot(static_cast<key_arg<K>>(key));
         return slot == _num_filled ? ValueT() : _pairs[slot].second;
     }
 
@@ -710,7 +1117,7 @@ public:
     template<typename K, typename V>
     std::pair<iterator, bool> do_insert(K&& key, V&& val) noexcept
     {
-        const auto key_hash = hash_key(key);
+        const auto key_hash = hash_key(static_cast<key_arg<K>>(key));
         const auto bucket = find_or_allocate(key, key_hash);
         const auto bempty = EMH_EMPTY(bucket);
         if (bempty) {
@@ -721,11 +1128,27 @@ public:
         return { {this, slot}, bempty };
     }
 
+    /// The value is built from args in place, and only once the key is known to be missing
+    template<typename K, typename... Args>
+    std::pair<iterator, bool> do_try_emplace(K&& key, Args&&... args) noexcept
+    {
+        const auto key_hash = hash_key(static_cast<key_arg<K>>(key));
+        const auto bucket = find_or_allocate(key, key_hash);
+        const auto bempty = EMH_EMPTY(bucket);
+        if (bempty) {
+            EMH_NEW_ARGS(bucket, key_hash, std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        const auto slot = _index[bucket].slot & _mask;
+        return { {this, slot}, bempty };
+    }
+
     template<typename K, typename V>
     std::pair<iterator, bool> do_assign(K&& key, V&& val) noexcept
     {
         check_expand_need();
-        const auto key_hash = hash_key(key);
+        const auto key_hash = hash_key(static_cast<key_arg<K>>(key));
         const auto bucket = find_or_allocate(key, key_hash);
         const auto bempty = EMH_EMPTY(bucket);
         if (bempty) {
@@ -816,14 +1239,22 @@ public:
     std::pair<iterator, bool> try_emplace(const KeyT& k, Args&&... args)
     {
         check_expand_need();
-        return do_insert(k, std::forward<Args>(args)...);
+        return do_try_emplace(k, std::forward<Args>(args)...);
     }
 
     template<class... Args>
     std::pair<iterator, bool> try_emplace(KeyT&& k, Args&&... args)
     {
         check_expand_need();
-        return do_insert(std::move(k), std::forward<Args>(args)...);
+        return do_try_emplace(std::move(k), std::forward<Args>(args)...);
+    }
+
+    /// The KeyT is built from k only if it isn't found
+    template<typename K, class... Args, if_transparent<K> = 0>
+    std::pair<iterator, bool> try_emplace(K&& k, Args&&... args)
+    {
+        check_expand_need();
+        return do_try_emplace(std::forward<K>(k), std::forward<Args>(args)...);
     }
 
     template <class... Args>
@@ -834,6 +1265,8 @@ public:
 
     std::pair<iterator, bool> insert_or_assign(const KeyT& key, ValueT&& val) { return do_assign(key, std::forward<ValueT>(val)); }
     std::pair<iterator, bool> insert_or_assign(KeyT&& key, ValueT&& val) { return do_assign(std::move(key), std::forward<ValueT>(val)); }
+    template<typename K, if_transparent<K> = 0>
+    std::pair<iterator, bool> insert_or_assign(K&& key, ValueT&& val) { return do_assign(std::forward<K>(key), std::forward<ValueT>(val)); }
 
     /// Return the old value or ValueT() if it didn't exist.
     ValueT set_get(const KeyT& key, const ValueT& val)
@@ -880,18 +1313,31 @@ public:
         return _pairs[slot].second;
     }
 
+    template<typename K, if_transparent<K> = 0>
+    ValueT& operator[](K&& key) noexcept
+    {
+        check_expand_need();
+        const auto key_hash = hash_key(static_cast<key_arg<K>>(key));
+        const auto bucket = find_or_allocate(key, key_hash);
+        if (EMH_EMPTY(bucket)) {
+            EMH_NEW(KeyT(std::forward<K>(key)), std::move(ValueT()), bucket, key_hash);
+        }
+
+        const auto slot = _index[bucket].slot & _mask;
+        return _pairs[slot].second;
+    }
+
     /// Erase an element from the hash table.
     /// return 0 if element was not found
     size_type erase(const KeyT& key) noexcept
     {
-        const auto key_hash = hash_key(key);
-        const auto sbucket = find_filled_bucket(key, key_hash);
-        if (sbucket == INACTIVE)
-            return 0;
+        return erase_key(key);
+    }
 
-        const auto main_bucket = key_hash & _mask;
-        erase_slot(sbucket, (size_type)main_bucket);
-        return 1;
+    template<typename K, if_transparent<K> = 0>
+    size_type erase(const K& key) noexcept
+    {
+        return erase_key(static_cast<key_arg<K>>(key));
     }
 
     //iterator erase(const_iterator begin_it, const_iterator end_it)
@@ -937,6 +1383,29 @@ public:
         return old_size - size();
     }
 
+    /// Erase keys[0, n), returns the number of erased elements.
+    /// The keys are looked up in groups with their main buckets prefetched and unlinked from
+    /// _index at once, then the holes in _pairs are filled from the tail in one pass.
+    /// Integer keys are cheap to rehash when erase moves the last pair, small batches of them
+    /// are erased one by one.
+    size_type erase_batch(const KeyT* keys, size_t n)
+    {
+#if EMH_HIGH_LOAD == 0
+        if (!std::is_integral<KeyT>::value || n >= _num_filled / 2)
+            return erase_compact(keys, n);
+#endif
+        size_type erased = 0;
+        for (size_t i = 0; i < n; i++)
+            erased += erase_key(keys[i]);
+        return erased;
+    }
+
+    template<typename Keys>
+    size_type erase_batch(const Keys& keys)
+    {
+        return erase_batch(keys.data(), keys.size());
+    }
+
     static constexpr bool is_triviall_destructable()
     {
 #if __cplusplus >= 201402L || _MSC_VER > 1600
@@ -955,6 +1424,22 @@ public:
 #endif
     }
 
+    //every filled bucket is on the chain of its key's main bucket, so walking the chain from
+    //the main bucket of each key empties them all, reading _num_filled keys instead of the index
+    void clear_chains() noexcept
+    {
+        for (size_type slot = 0; slot < _num_filled; ++slot) {
+            auto bucket = key_bucket(slot_hash(slot));
+            while (!EMH_EMPTY(bucket)) {
+                const auto next_bucket = _index[bucket].next;
+                memset((char*)(_index + bucket), INACTIVE, sizeof(_index[0]));
+                if (next_bucket == bucket)
+                    break;
+                bucket = next_bucket;
+            }
+        }
+    }
+
     void clearkv()
     {
         if (is_triviall_destructable()) {
@@ -964,13 +1449,19 @@ public:
     }
 
     /// Remove all elements, keeping full capacity.
+    /// A table holding few keys for its size only resets the index chains of those keys.
     void clear() noexcept
     {
-        clearkv();
-
-        if (_num_filled > 0)
+        if (_num_filled > 0) {
+#if EMH_HIGH_LOAD == 0
+            if (_num_filled < _num_buckets / EMH_SPARSE_CLEAR)
+                clear_chains();
+            else
+#endif
             memset((char*)_index, INACTIVE, sizeof(_index[0]) * _num_buckets);
+        }
 
+        clearkv();
         _last = _num_filled = 0;
         _etail = INACTIVE;
 
@@ -1052,12 +1543,12 @@ public:
         (void)force;
 #if EMH_HIGH_LOAD == 0
         const auto required_buckets = num_elems * _mlf >> 27;
-        if (EMH_LIKELY(required_buckets < _mask)) // && !force
+        if (EMH_LIKELY(required_buckets < main_mask())) // && !force
             return false;
 
 #elif EMH_HIGH_LOAD
         const auto required_buckets = num_elems + num_elems * 1 / 9;
-        if (EMH_LIKELY(required_buckets < _mask))
+        if (EMH_LIKELY(required_buckets < main_mask()))
             return false;
 
         else if (_num_buckets < 16 && _num_filled < _num_buckets)
@@ -1109,7 +1600,7 @@ public:
 
 #if EMH_SORT
         std::sort(_pairs, _pairs + _num_filled, [this](const value_type & l, const value_type & r) {
-            const auto hashl = (size_type)hash_key(l.first) & _mask, hashr = (size_type)hash_key(r.first) & _mask;
+            const auto hashl = hash_bucket(l.first), hashr = hash_bucket(r.first);
             return hashl < hashr;
             //return l.first < r.first;
         });
@@ -1117,9 +1608,8 @@ public:
 
         memset((char*)_index, INACTIVE, sizeof(_index[0]) * _num_buckets);
         for (size_type slot = 0; slot < _num_filled; slot++) {
-            const auto& key = _pairs[slot].first;
-            const auto key_hash = hash_key(key);
-            const auto bucket = size_type(key_hash & _mask);
+            const auto key_hash = slot_hash(slot);
+            const auto bucket = key_bucket(key_hash);
             auto& next_bucket = _index[bucket].next;
             if ((int)next_bucket < 0)
                 _index[bucket] = {1, slot | ((size_type)(key_hash) & ~_mask)};
@@ -1131,36 +1621,80 @@ public:
         return true;
     }
 
-    void rebuild(size_type num_buckets) noexcept
+    //grows the arrays before the index is dropped, a failed realloc leaves the map as it was
+    void rebuild(size_type num_buckets)
     {
-        free(_index);
-        auto new_pairs = (value_type*)alloc_bucket((size_type)(num_buckets * max_load_factor()) + 4);
+        const auto num_pairs = (size_type)(num_buckets * max_load_factor()) + 4;
+#ifndef EMH_ALLOC
         if (is_copy_trivially()) {
-            if (_pairs)
-            memcpy((char*)new_pairs, (char*)_pairs, _num_filled * sizeof(value_type));
-        } else {
-            for (size_type slot = 0; slot < _num_filled; slot++) {
-                new(new_pairs + slot) value_type(std::move(_pairs[slot]));
-                if (is_triviall_destructable())
-                    _pairs[slot].~value_type();
+            //pairs are dense and keep their slots, so extend them in place. glibc moves
+            //large (mmap backed) blocks by mremap without copying or doubling the footprint
+            auto new_pairs = (value_type*)realloc((void*)_pairs, (uint64_t)num_pairs * sizeof(value_type));
+#if EMH_EXCEPTION
+            if (EMH_UNLIKELY(!new_pairs))
+                throw std::bad_alloc();
+#else
+            assert(!!new_pairs);
+#endif
+            _pairs = new_pairs;
+        } else
+#endif
+        {
+            auto new_pairs = (value_type*)alloc_bucket(num_pairs);
+            if (is_copy_trivially()) {
+                if (_pairs)
+                memcpy((char*)new_pairs, (char*)_pairs, _num_filled * sizeof(value_type));
+            } else {
+                for (size_type slot = 0; slot < _num_filled; slot++) {
+                    new(new_pairs + slot) value_type(std::move(_pairs[slot]));
+                    if (is_triviall_destructable())
+                        _pairs[slot].~value_type();
+                }
             }
-        }
-        free(_pairs);
-        _pairs = new_pairs;
+            free(_pairs);
+            _pairs = new_pairs;
+        }
+#if EMH_CACHE_HASH
+        auto new_hashes = (uint64_t*)realloc((void*)_hashes, (uint64_t)num_pairs * sizeof(uint64_t));
+#if EMH_EXCEPTION
+        if (EMH_UNLIKELY(!new_hashes))
+            throw std::bad_alloc();
+#else
+        assert(!!new_hashes);
+#endif
+        _hashes = new_hashes;
+#endif
+        free(_index);
         _index = (Index*)alloc_index (num_buckets);
 
         memset((char*)_index, INACTIVE, sizeof(_index[0]) * num_buckets);
         memset((char*)(_index + num_buckets), 0, sizeof(_index[0]) * EAD);
     }
 
+    /// Hook called by rehash() of every map of this type, nullptr (the default) costs a branch per rehash.
+    static RehashHook& rehash_hook() noexcept
+    {
+        static RehashHook hook = nullptr;
+        return hook;
+    }
+
     void rehash(uint64_t required_buckets)
     {
         if (required_buckets < _num_filled)
             return;
 
         assert(required_buckets < max_size());
+#if EMH_FAST_RANGE
+        auto num_buckets = (size_type)std::max(std::max(required_buckets, (uint64_t)_num_filled * _mlf >> 27), (uint64_t)4u);
+        if (num_buckets > _num_main && _num_main > 0)
+            num_buckets = (size_type)std::max((uint64_t)num_buckets, _num_main + (uint64_t)_num_main * EMH_FAST_RANGE / 100);
+        num_buckets = (num_buckets + 7) / 8 * 8;
+#else
+        //the pairs array holds num_buckets * max_load_factor() elements, shrink_to_fit must fit them all
+        required_buckets = std::max(required_buckets, (uint64_t)_num_filled * _mlf >> 27);
         auto num_buckets = _num_filled > (1u << 16) ? (1u << 16) : 4u;
         while (num_buckets < required_buckets) { num_buckets *= 2; }
+#endif
 #if EMH_SAVE_MEM
         if (sizeof(KeyT) < sizeof(size_type) && num_buckets >= (1ul << (2 * 8)))
             num_buckets = 2ul << (sizeof(KeyT) * 8);
@@ -1168,27 +1702,54 @@ public:
 
 #if EMH_REHASH_LOG
         auto last = _last;
-        size_type collision = 0;
 #endif
+        size_type collision = 0;
+        const auto old_buckets = _num_buckets;
 
-#if EMH_HIGH_LOAD
-        _ehead = 0;
+        auto new_mask       = num_buckets - 1;
+        size_type new_last  = 0;
+#if EMH_FAST_RANGE
+        const auto new_main = num_buckets;
 #endif
-        _last = 0;
-
-        _mask        = num_buckets - 1;
 #if EMH_PACK_TAIL > 1
-        _last = _mask;
+        new_last = new_mask;
         num_buckets += num_buckets * EMH_PACK_TAIL / 100; //add more 5-10%
 #endif
-        _num_buckets = num_buckets;
+#if EMH_FAST_RANGE
+        //slot and EQHASH bits share one index word, split them at a power of two
+        for (new_mask = 1; new_mask < num_buckets; new_mask *= 2) {}
+        new_mask -= 1;
+#endif
+
+        //the hook sees the map as it was before the rehash
+        const auto hook = rehash_hook();
+        RehashEvent event = {};
+        std::chrono::steady_clock::time_point start;
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            const auto mlf = max_load_factor();
+            event = {this, false, _num_filled, old_buckets, num_buckets,
+                (EAD + num_buckets) * sizeof(Index) + ((size_type)(num_buckets * mlf) + 4) * SLOT_BYTES,
+                old_buckets ? (EAD + old_buckets) * sizeof(Index) + ((size_type)(old_buckets * mlf) + 4) * SLOT_BYTES : 0, 0, 0};
+            hook(event);
+            start = std::chrono::steady_clock::now();
+        }
 
         rebuild(num_buckets);
 
+#if EMH_HIGH_LOAD
+        _ehead = 0;
+#endif
+        _last        = new_last;
+        _mask        = new_mask;
+#if EMH_FAST_RANGE
+        _num_main    = new_main;
+#endif
+        _num_buckets = num_buckets;
+
 #ifdef EMH_SORT
         std::sort(_pairs, _pairs + _num_filled, [this](const value_type & l, const value_type & r) {
             const auto hashl = hash_key(l.first), hashr = hash_key(r.first);
-            auto diff = int64_t((hashl & _mask) - (hashr & _mask));
+            auto diff = int64_t(key_bucket(hashl)) - int64_t(key_bucket(hashr));
             if (diff != 0)
                 return diff < 0;
             return hashl < hashr;
@@ -1198,15 +1759,23 @@ public:
 
         _etail = INACTIVE;
         for (size_type slot = 0; slot < _num_filled; ++slot) {
-            const auto& key = _pairs[slot].first;
-            const auto key_hash = hash_key(key);
+            const auto key_hash = slot_hash(slot);
             const auto bucket = find_unique_bucket(key_hash);
             _index[bucket] = { bucket, slot | ((size_type)(key_hash) & ~_mask) };
 
 #if EMH_REHASH_LOG
             if (bucket != hash_main(bucket))
-                collision ++;
+#else
+            if (EMH_UNLIKELY(hook != nullptr) && bucket != hash_main(bucket))
 #endif
+                collision ++;
+        }
+
+        if (EMH_UNLIKELY(hook != nullptr)) {
+            event.finish     = true;
+            event.elapsed_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            event.collision  = _num_filled ? (float)collision / _num_filled : 0;
+            hook(event);
         }
 
 #if EMH_REHASH_LOG
@@ -1228,6 +1797,19 @@ private:
     // Can we fit another element?
     bool check_expand_need()
     {
+#if EMH_SAFE_HASH
+        if (EMH_UNLIKELY(_hash_inter == 1)) {
+            //chains are flooded, draw a fresh seed and rehash once
+            _hash_inter = 2;
+            _seed = make_seed(_seed);
+#if EMH_CACHE_HASH
+            for (size_type slot = 0; slot < _num_filled; slot++)
+                _hashes[slot] = hash_key(_pairs[slot].first);
+#endif
+            rehash(main_mask() + 1);
+            return true;
+        }
+#endif
         return reserve(_num_filled, false);
     }
 
@@ -1242,12 +1824,130 @@ private:
 #endif
     }
 
+    //a multiply-shift of 32 random bits is much cheaper than the division by _num_filled
+    template<typename RNG>
+    size_type random_slot(RNG& rng) const
+    {
+        if (sizeof(size_type) <= 4 && (RNG::max)() - (RNG::min)() >= 0xFFFFFFFFu)
+            return (size_type)(((uint64_t)(uint32_t)(rng() - (RNG::min)()) * _num_filled) >> 32);
+        return (size_type)(rng() % _num_filled);
+    }
+
     size_type slot_to_bucket(const size_type slot) const noexcept
     {
         size_type main_bucket;
         return find_slot_bucket(slot, main_bucket); //TODO
     }
 
+    //move the entry at cit out to node and erase it, returns the next iterator as erase() does
+    iterator extract_to(const_iterator cit, node_type& node) noexcept
+    {
+        //the chain is found by the key hash before the key is moved out
+        const auto slot = (size_type)(cit.kv_ - _pairs);
+        size_type main_bucket;
+        const auto sbucket = find_slot_bucket(slot, main_bucket);
+        node.fill(std::move(_pairs[slot].first), std::move(_pairs[slot].second));
+        erase_slot(sbucket, main_bucket);
+        return {this, slot};
+    }
+
+    //erase_batch() without moving a pair per key, every hit is marked in dead and compact_slots
+    //moves each live pair of the tail once
+    size_type erase_compact(const KeyT* keys, size_t n) noexcept
+    {
+        if (_num_filled == 0 || n == 0)
+            return 0;
+
+        const auto old_size = _num_filled;
+        auto dead = (uint64_t*)calloc(old_size / 64 + 1, sizeof(uint64_t));
+        size_type erased = 0;
+
+        constexpr size_t group = 16;
+        uint64_t hashes[group];
+        for (size_t i = 0; i < n; i += group) {
+            const auto m = std::min(group, n - i);
+            hash_batch(keys + i, hashes, m);
+            for (size_t j = 0; j < m; j++)
+                prefetch_heap_block((char*)(_index + key_bucket(hashes[j])));
+
+            for (size_t j = 0; j < m; j++) {
+                const auto bucket = find_filled_bucket(keys[i + j], hashes[j]);
+                if (bucket == INACTIVE)
+                    continue;
+
+                const auto slot = _index[bucket].slot & _mask;
+                dead[slot / 64] |= 1ull << (slot % 64);
+                const auto ebucket = erase_bucket(bucket, key_bucket(hashes[j]));
+                _index[ebucket] = {INACTIVE, 0};
+                erased ++;
+            }
+        }
+
+        if (erased > 0)
+            compact_slots(dead, erased);
+        free(dead);
+        return erased;
+    }
+
+    //the erased slots are marked in dead and already unlinked from _index. the k-th live pair
+    //of the tail [new size, old size) fills the k-th dead slot below the new size, so the pairs
+    //are read and written in address order. then the moved slots are renamed in _index by one
+    //linear scan, or by walking the chain of each moved key if only a few were moved.
+    void compact_slots(const uint64_t* dead, const size_type erased) noexcept
+    {
+        const auto old_size = _num_filled;
+        const auto new_size = old_size - erased;
+        const auto is_dead = [dead](size_type slot) { return (dead[slot / 64] >> (slot % 64)) & 1; };
+
+        auto dest = (size_type*)malloc(erased * sizeof(size_type));
+        size_type moves = 0, word = 0;
+        uint64_t holes = dead[0];
+        for (auto src = new_size; src < old_size; src++) {
+            if (is_dead(src))
+                continue;
+            while (holes == 0)
+                holes = dead[++word];
+
+            const auto hole = word * 64 + CTZ(holes);
+            holes &= holes - 1;
+            dest[src - new_size] = hole;
+            _pairs[hole] = std::move(_pairs[src]);
+#if EMH_CACHE_HASH
+            _hashes[hole] = _hashes[src];
+#endif
+            moves++;
+        }
+
+        if (moves > _num_buckets / 32) {
+            const auto index = _index, index_end = _index + _num_buckets;
+            const auto mask = _mask;
+            for (auto it = index; it < index_end; it++) {
+                //tail is out of range for empty buckets, one well predicted branch per bucket
+                const auto tail = ((it->slot & mask) - new_size) | (size_type)((int)it->next >> 31);
+                if (tail < erased)
+                    it->slot = dest[tail] | (it->slot & ~mask);
+            }
+        } else {
+            for (auto src = new_size; src < old_size; src++) {
+                if (is_dead(src))
+                    continue;
+                const auto slot = dest[src - new_size];
+                auto bucket = key_bucket(slot_hash(slot));
+                while ((_index[bucket].slot & _mask) != src)
+                    bucket = _index[bucket].next;
+                _index[bucket].slot = slot | (_index[bucket].slot & ~_mask);
+            }
+        }
+        free(dest);
+
+        if (is_triviall_destructable()) {
+            for (auto slot = new_size; slot < old_size; slot++)
+                _pairs[slot].~value_type();
+        }
+        _num_filled = new_size;
+        _etail = INACTIVE;
+    }
+
     //very slow
     void erase_slot(const size_type sbucket, const size_type main_bucket) noexcept
     {
@@ -1259,6 +1959,9 @@ private:
                 ? slot_to_bucket(last_slot) : _etail;
 
             _pairs[slot] = std::move(_pairs[last_slot]);
+#if EMH_CACHE_HASH
+            _hashes[slot] = _hashes[last_slot];
+#endif
             _index[last_bucket].slot = slot | (_index[last_bucket].slot & ~_mask);
         }
 
@@ -1299,8 +2002,8 @@ private:
     // Find the slot with this key, or return bucket size
     size_type find_slot_bucket(const size_type slot, size_type& main_bucket) const
     {
-        const auto key_hash = hash_key(_pairs[slot].first);
-        const auto bucket = main_bucket = size_type(key_hash & _mask);
+        const auto key_hash = slot_hash(slot);
+        const auto bucket = main_bucket = key_bucket(key_hash);
         if (slot == (_index[bucket].slot & _mask))
             return bucket;
 
@@ -1314,10 +2017,24 @@ private:
         return INACTIVE;
     }
 
+    template<typename K>
+    size_type erase_key(const K& key) noexcept
+    {
+        const auto key_hash = hash_key(key);
+        const auto sbucket = find_filled_bucket(key, key_hash);
+        if (sbucket == INACTIVE)
+            return 0;
+
+        const auto main_bucket = key_bucket(key_hash);
+        erase_slot(sbucket, (size_type)main_bucket);
+        return 1;
+    }
+
     // Find the slot with this key, or return bucket size
-    size_type find_filled_bucket(const KeyT& key, uint64_t key_hash) const noexcept
+    template<typename K=KeyT>
+    size_type find_filled_bucket(const K& key, uint64_t key_hash) const noexcept
     {
-        const auto bucket = size_type(key_hash & _mask);
+        const auto bucket = key_bucket(key_hash);
         auto next_bucket  = _index[bucket].next;
         if (EMH_UNLIKELY((int)next_bucket < 0))
             return INACTIVE;
@@ -1352,7 +2069,7 @@ private:
     size_type find_filled_slot(const K& key) const noexcept
     {
         const auto key_hash = hash_key(key);
-        const auto bucket = size_type(key_hash & _mask);
+        const auto bucket = key_bucket(key_hash);
         auto next_bucket = _index[bucket].next;
         if ((int)next_bucket < 0)
             return _num_filled;
@@ -1386,7 +2103,7 @@ private:
     size_type find_hash_bucket(const KeyT& key) const noexcept
     {
         const auto key_hash = hash_key(key);
-        const auto bucket = size_type(key_hash & _mask);
+        const auto bucket = key_bucket(key_hash);
         const auto next_bucket = _index[bucket].next;
         if ((int)next_bucket < 0)
             return END;
@@ -1403,7 +2120,7 @@ private:
                 return slot;
 
             const auto hasho = hash_key(okey);
-            if ((hasho & _mask) != bucket)
+            if (key_bucket(hasho) != bucket)
                 break;
             else if (hasho > key_hash)
                 break;
@@ -1418,7 +2135,7 @@ private:
     size_type find_sorted_bucket(const KeyT& key) const noexcept
     {
         const auto key_hash = hash_key(key);
-        const auto bucket = size_type(key_hash & _mask);
+        const auto bucket = key_bucket(key_hash);
         const auto slots = (int)(_index[bucket].next); //TODO
         if (slots < 0 /**|| key < _pairs[slot].first*/)
             return END;
@@ -1480,7 +2197,7 @@ private:
     template<typename K=KeyT>
     size_type find_or_allocate(const K& key, uint64_t key_hash) noexcept
     {
-        const auto bucket = size_type(key_hash & _mask);
+        const auto bucket = key_bucket(key_hash);
         auto next_bucket = _index[bucket].next;
         prefetch_heap_block((char*)&_pairs[bucket]);
         if ((int)next_bucket < 0) {
@@ -1497,7 +2214,7 @@ private:
                 return bucket;
 
         //check current bucket_key is in main bucket or not
-        const auto kmain = hash_bucket(_pairs[slot].first);
+        const auto kmain = key_bucket(slot_hash(slot));
         if (kmain != bucket)
             return kickout_bucket(kmain, bucket);
         else if (next_bucket == bucket)
@@ -1519,6 +2236,11 @@ private:
             next_bucket = nbucket;
         }
 
+#if EMH_SAFE_HASH
+        if (EMH_UNLIKELY(csize > EMH_SAFE_CHAIN) && _hash_inter == 0)
+            _hash_inter = 1;
+#endif
+
         //find a empty and link it to tail
         const auto new_bucket = find_empty_bucket(next_bucket, csize);
         prefetch_heap_block((char*)&_pairs[new_bucket]);
@@ -1527,7 +2249,7 @@ private:
 
     size_type find_unique_bucket(uint64_t key_hash) noexcept
     {
-        const auto bucket = size_type(key_hash & _mask);
+        const auto bucket = key_bucket(key_hash);
         auto next_bucket = _index[bucket].next;
         if ((int)next_bucket < 0) {
 #if EMH_HIGH_LOAD
@@ -1576,7 +2298,7 @@ private:
 #ifdef EMH_QUADRATIC
         constexpr size_type linear_probe_length = 2 * EMH_CACHE_LINE_SIZE / sizeof(Index);//16
         for (size_type offset = csize + 2, step = 4; offset <= linear_probe_length; ) {
-            bucket = (bucket_from + offset) & _mask;
+            bucket = wrap_bucket(bucket_from + offset);
             if (EMH_EMPTY(bucket) || EMH_EMPTY(++bucket))
                 return bucket;
             offset += step; //7/8. 12. 16
@@ -1584,7 +2306,7 @@ private:
 #else
         constexpr size_type quadratic_probe_length = 6u;
         for (size_type offset = 4u, step = 3u; step < quadratic_probe_length; ) {
-            bucket = (bucket_from + offset) & _mask;
+            bucket = wrap_bucket(bucket_from + offset);
             if (EMH_EMPTY(bucket) || EMH_EMPTY(++bucket))
                 return bucket;
             offset += step++;
@@ -1604,15 +2326,15 @@ private:
             if (EMH_UNLIKELY(_last >= _num_buckets))
                 _last = 0;
 
-            auto medium = (_mask / 4 + _last++) & _mask;
+            auto medium = wrap_bucket(_mask / 4 + _last++);
             if (EMH_EMPTY(medium))
                 return medium;
 #else
-            _last &= _mask;
+            _last = wrap_bucket(_last);
             if (EMH_EMPTY(++_last))// || EMH_EMPTY(++_last))
                 return _last;
 
-            auto medium = (_num_buckets / 2 + _last) & _mask;
+            auto medium = wrap_bucket(_num_buckets / 2 + _last);
             if (EMH_EMPTY(medium))// || EMH_EMPTY(++medium))
                 return medium;
 #endif
@@ -1649,15 +2371,52 @@ private:
         }
     }
 
+    //main bucket of a hash, EMH_FAST_RANGE maps the mixed high 32 bits onto [0, _num_main)
+    size_type key_bucket(const uint64_t key_hash) const noexcept
+    {
+#if EMH_FAST_RANGE
+        return (size_type)((((key_hash * 0x9E3779B97F4A7C15ull) >> 32) * _num_main) >> 32);
+#else
+        return (size_type)key_hash & _mask;
+#endif
+    }
+
+    size_type wrap_bucket(const size_type bucket) const noexcept
+    {
+#if EMH_FAST_RANGE
+        return bucket < _num_buckets ? bucket : bucket % _num_buckets;
+#else
+        return bucket & _mask;
+#endif
+    }
+
+    size_type main_mask() const noexcept
+    {
+#if EMH_FAST_RANGE
+        return _num_main - 1;
+#else
+        return _mask;
+#endif
+    }
+
     size_type hash_bucket(const KeyT& key) const noexcept
     {
-        return (size_type)hash_key(key) & _mask;
+        return key_bucket(hash_key(key));
     }
 
     size_type hash_main(const size_type bucket) const noexcept
     {
         const auto slot = _index[bucket].slot & _mask;
-        return (size_type)hash_key(_pairs[slot].first) & _mask;
+        return key_bucket(slot_hash(slot));
+    }
+
+    uint64_t slot_hash(const size_type slot) const noexcept
+    {
+#if EMH_CACHE_HASH
+        return _hashes[slot];
+#else
+        return hash_key(_pairs[slot].first);
+#endif
     }
 
 #if EMH_INT_HASH
@@ -1700,6 +2459,21 @@ private:
     }
 #endif
 
+    //the hash_batch.hpp mixer equal to hash64, void if there is none
+#if !EMH_INT_HASH || !defined(EMH_BATCH_INLINE)
+    using int_batch = void;
+#elif (__SIZEOF_INT128__ || _WIN64) && EMH_INT_HASH == 1
+    using int_batch = emhash::fold_hash<true>;
+#elif EMH_INT_HASH == 2
+    using int_batch = emhash::mur3_hash;
+#elif EMH_INT_HASH == 3
+    using int_batch = emhash::mix_hash<false>;
+#elif EMH_INT_HASH != 1 && !EMH_WYHASH64
+    using int_batch = emhash::mix13_hash;
+#else
+    using int_batch = void;
+#endif
+
 #if EMH_WYHASH_HASH
     //#define WYHASH_CONDOM 1
     static uint64_t wymix(uint64_t A, uint64_t B)
@@ -1783,7 +2557,7 @@ public:
 
 private:
     template<typename UType, typename std::enable_if<std::is_integral<UType>::value, uint32_t>::type = 0>
-        inline uint64_t hash_key(const UType key) const
+        inline uint64_t hash_raw(const UType key) const
         {
 #if EMH_INT_HASH
             return hash64(key);
@@ -1794,30 +2568,85 @@ private:
 #endif
         }
 
-    template<typename UType, typename std::enable_if<std::is_same<UType, std::string>::value, uint32_t>::type = 0>
-        inline uint64_t hash_key(const UType& key) const
+    template<typename UType, typename std::enable_if<is_string<UType>::value, uint32_t>::type = 0>
+        inline uint64_t hash_raw(const UType& key) const
         {
-#if EMH_WYHASH_HASH
+#if EMH_AES_HASH
+            return emhash::aes_hash(key.data(), key.size());
+#elif EMH_WYHASH_HASH
             return wyhashstr(key.data(), key.size());
 #else
             return _hasher(key);
 #endif
         }
 
-    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !std::is_same<UType, std::string>::value, uint32_t>::type = 0>
-        inline uint64_t hash_key(const UType& key) const
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value && !is_string<UType>::value, uint32_t>::type = 0>
+        inline uint64_t hash_raw(const UType& key) const
         {
             return _hasher(key);
         }
 
+#ifdef EMH_BATCH_INLINE
+    template<typename UType, typename std::enable_if<std::is_integral<UType>::value && !std::is_void<int_batch>::value, uint32_t>::type = 0>
+    void hash_batch_raw(const UType* keys, uint64_t* out, size_t n) const
+    {
+        emhash::hash_batch<int_batch>(keys, out, n);
+    }
+#endif
+
+    template<typename UType, typename std::enable_if<!std::is_integral<UType>::value || std::is_void<int_batch>::value, uint32_t>::type = 0>
+    void hash_batch_raw(const UType* keys, uint64_t* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = hash_raw(keys[i]);
+    }
+
+#if EMH_SAFE_HASH
+    static uint64_t mix_seed(uint64_t h)
+    {
+        h ^= h >> 33; h *= UINT64_C(0xff51afd7ed558ccd);
+        h ^= h >> 33; h *= UINT64_C(0xc4ceb9fe1a85ec53);
+        return h ^ (h >> 33);
+    }
+
+    //the seed comes from the map address and steady_clock, it is cheap but guessable by anyone who can
+    //observe those, and keys whose full 64-bit hashes collide still collide under every seed
+    static uint64_t make_seed(uint64_t salt)
+    {
+        return mix_seed(salt ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    //a xor alone would only relabel buckets, the mixer spreads keys colliding in the low bits
+    inline uint64_t hash_seed(uint64_t h) const
+    {
+        return mix_seed(h ^ _seed);
+    }
+#endif
+
+    template<typename UType>
+        inline uint64_t hash_key(const UType& key) const
+        {
+#if EMH_SAFE_HASH
+            return hash_seed(hash_raw(key));
+#else
+            return hash_raw(key);
+#endif
+        }
+
 private:
     Index*    _index;
     value_type*_pairs;
+#if EMH_CACHE_HASH
+    uint64_t* _hashes; //hash_key of the key in the same slot
+#endif
 
     HashT     _hasher;
     EqT       _eq;
     uint32_t  _mlf;
     size_type _mask;
+#if EMH_FAST_RANGE
+    size_type _num_main;
+#endif
     size_type _num_buckets;
     size_type _num_filled;
     size_type _last;
@@ -1825,6 +2654,10 @@ private:
     size_type _ehead;
 #endif
     size_type _etail;
+#if EMH_SAFE_HASH
+    uint64_t  _seed;
+    uint32_t  _hash_inter; //0 seeded, 1 flooding detected, 2 reseeded
+#endif
 };
 } // namespace emhash
 
@@ -0,0 +1,1114 @@
+// emhash9::DenseMap/DenseSet for C++17, dense open addressing over integer keys
+// version 1.0.0
+// https://github.com/ktprime/emhash/blob/master/hash_table9.hpp
+//
+// Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2021-2024 Huang Yuanbing & bailuzhou AT 163.com
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE
+
+// DenseMap and DenseSet reserve one key value as the empty marker (like set_empty_key of a
+// dense_hash_map), so a bucket needs no link and no bitmask: DenseMap<uint64_t, uint32_t>
+// costs 12 bytes per bucket (keys and values are kept in two arrays), DenseSet<uint64_t> 8 bytes.
+// Buckets are probed linearly without wrap around, a group of keys is compared with
+// the key and the empty marker at once by SSE2/AVX2, erase shifts the run back so no
+// tombstone is left. They share namespace emhash9 with the bitmask HashSet of hash_set4.hpp,
+// so both headers can be included in one program.
+
+#pragma once
+
+#include <cstring>
+#include <cstdlib>
+#include <type_traits>
+#include <cassert>
+#include <utility>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <algorithm>
+#include <limits>
+#include <new>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <immintrin.h>
+#endif
+#if _WIN32
+    #include <intrin.h>
+#endif
+
+// likely/unlikely
+#if defined(__GNUC__) || defined(__INTEL_COMPILER) || defined(__clang__)
+#    define EMH_LIKELY(condition)   __builtin_expect(condition, 1)
+#    define EMH_UNLIKELY(condition) __builtin_expect(condition, 0)
+#else
+#    define EMH_LIKELY(condition)   condition
+#    define EMH_UNLIKELY(condition) condition
+#endif
+
+namespace emhash9 {
+
+typedef uint32_t size_type;
+
+#if defined(__AVX2__)
+    static constexpr uint32_t GROUP_BYTES = 32;
+#else
+    static constexpr uint32_t GROUP_BYTES = 16;
+#endif
+
+//buckets kept after the last main bucket instead of wrapping around to bucket 0
+static constexpr size_type MAX_PAD = 64;
+
+static inline uint32_t CTZ(uint32_t n)
+{
+#if _WIN32
+    unsigned long index;
+    _BitScanForward(&index, n);
+    return (uint32_t)index;
+#else
+    return (uint32_t)__builtin_ctz(n);
+#endif
+}
+
+/// The empty marker used until set_empty_key(): the lowest signed or the highest unsigned value.
+template<typename KeyT>
+constexpr KeyT default_empty_key()
+{
+    return std::is_signed<KeyT>::value ? std::numeric_limits<KeyT>::min() : std::numeric_limits<KeyT>::max();
+}
+
+/// Bit i is set if keys[i] == key, for the GROUP_BYTES / sizeof(KeyT) keys starting at keys.
+template<typename KeyT>
+static inline uint32_t match_group(const KeyT* keys, const KeyT key)
+{
+#if defined(__AVX2__)
+    if constexpr (sizeof(KeyT) == 8) {
+        const auto eq = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)keys), _mm256_set1_epi64x((int64_t)key));
+        return (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(eq));
+    } else if constexpr (sizeof(KeyT) == 4) {
+        const auto eq = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)keys), _mm256_set1_epi32((int)key));
+        return (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+    }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    if constexpr (sizeof(KeyT) == 8) {
+        //sse2 has no 64 bit compare, both halves must be equal
+        const auto eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)keys), _mm_set1_epi64x((int64_t)key));
+        return (uint32_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)))));
+    } else if constexpr (sizeof(KeyT) == 4) {
+        const auto eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)keys), _mm_set1_epi32((int)key));
+        return (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(eq));
+    }
+#endif
+
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < GROUP_BYTES / sizeof(KeyT); i++)
+        mask |= uint32_t(keys[i] == key) << i;
+    return mask;
+}
+
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+class DenseMap
+{
+    static_assert(std::is_integral<KeyT>::value && sizeof(KeyT) > 1, "DenseMap needs an integer key of 2 bytes or more");
+    static_assert(std::is_same<EqT, std::equal_to<KeyT>>::value, "DenseMap compares keys bitwise");
+
+    constexpr static float EMH_DEFAULT_LOAD_FACTOR = 0.80f;
+    constexpr static float EMH_MIN_LOAD_FACTOR     = 0.25f;
+    constexpr static float EMH_MAX_LOAD_FACTOR     = 0.95f; //linear probing degrades fast above
+    constexpr static uint32_t GROUP = GROUP_BYTES / sizeof(KeyT);
+
+public:
+    typedef DenseMap<KeyT, ValueT, HashT, EqT> htype;
+    typedef std::pair<KeyT, ValueT>           value_type;
+    typedef KeyT   key_type;
+    typedef ValueT val_type;
+    typedef ValueT mapped_type;
+    typedef HashT  hasher;
+    typedef EqT    key_equal;
+
+    /// Keys and values live in two arrays, iterators hand out a pair of references by value.
+    struct value_ref
+    {
+        const KeyT& first;
+        ValueT&     second;
+        operator value_type() const { return {first, second}; }
+    };
+
+    struct const_value_ref
+    {
+        const KeyT&   first;
+        const ValueT& second;
+        operator value_type() const { return {first, second}; }
+    };
+
+    /// operator-> of the iterators returns this, it keeps the value_ref alive for the member access.
+    template<typename Ref>
+    struct arrow_proxy
+    {
+        Ref ref;
+        const Ref* operator->() const { return &ref; }
+    };
+
+    class const_iterator;
+    class iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::ptrdiff_t            difference_type;
+        typedef value_ref                 value_type;
+        typedef arrow_proxy<value_ref>    pointer;
+        typedef value_ref                 reference;
+
+        iterator() : _map(nullptr), _bucket(0) {}
+        iterator(const htype* hash_map, size_type bucket) : _map(hash_map), _bucket(bucket) {}
+        iterator(const iterator& it) : _map(it._map), _bucket(it._bucket) {}
+        iterator& operator=(const iterator& it) { _map = it._map; _bucket = it._bucket; return *this; }
+
+        iterator& operator++()
+        {
+            _bucket = _map->next_bucket(_bucket + 1);
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto old = *this;
+            _bucket = _map->next_bucket(_bucket + 1);
+            return old;
+        }
+
+        reference operator*() const { return {_map->_keys[_bucket], _map->_vals[_bucket]}; }
+        pointer operator->() const { return {**this}; }
+
+        bool operator==(const iterator& rhs) const { return _bucket == rhs._bucket; }
+        bool operator!=(const iterator& rhs) const { return _bucket != rhs._bucket; }
+        size_type bucket() const { return _bucket; }
+
+    private:
+        friend class const_iterator;
+        const htype*  _map;
+        size_type     _bucket;
+    };
+
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::ptrdiff_t            difference_type;
+        typedef const_value_ref           value_type;
+        typedef arrow_proxy<const_value_ref> pointer;
+        typedef const_value_ref           reference;
+
+        const_iterator() : _map(nullptr), _bucket(0) {}
+        const_iterator(const htype* hash_map, size_type bucket) : _map(hash_map), _bucket(bucket) {}
+        const_iterator(const iterator& it) : _map(it._map), _bucket(it.bucket()) {}
+        const_iterator(const const_iterator& it) : _map(it._map), _bucket(it._bucket) {}
+        const_iterator& operator=(const const_iterator& it) { _map = it._map; _bucket = it._bucket; return *this; }
+
+        const_iterator& operator++()
+        {
+            _bucket = _map->next_bucket(_bucket + 1);
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto old = *this;
+            _bucket = _map->next_bucket(_bucket + 1);
+            return old;
+        }
+
+        reference operator*() const { return {_map->_keys[_bucket], _map->_vals[_bucket]}; }
+        pointer operator->() const { return {**this}; }
+
+        bool operator==(const const_iterator& rhs) const { return _bucket == rhs._bucket; }
+        bool operator!=(const const_iterator& rhs) const { return _bucket != rhs._bucket; }
+        size_type bucket() const { return _bucket; }
+
+    private:
+        const htype*  _map;
+        size_type     _bucket;
+    };
+
+    void init(size_type bucket, float mlf = EMH_DEFAULT_LOAD_FACTOR)
+    {
+        _keys = nullptr;
+        _vals = nullptr;
+        _empty = default_empty_key<KeyT>();
+        _num_buckets = _num_slots = _num_filled = 0;
+        _mlf = (uint32_t)((1 << 27) / EMH_DEFAULT_LOAD_FACTOR);
+        max_load_factor(mlf);
+        rehash(bucket);
+    }
+
+    DenseMap(size_type bucket = 4, float mlf = EMH_DEFAULT_LOAD_FACTOR)
+    {
+        init(bucket, mlf);
+    }
+
+    DenseMap(const DenseMap& rhs)
+    {
+        _keys = nullptr;
+        clone(rhs);
+    }
+
+    DenseMap(DenseMap&& rhs) noexcept
+    {
+        init(4);
+        swap(rhs);
+    }
+
+    DenseMap(std::initializer_list<value_type> ilist)
+    {
+        init((size_type)ilist.size());
+        for (auto it = ilist.begin(); it != ilist.end(); ++it)
+            insert(*it);
+    }
+
+    DenseMap& operator=(const DenseMap& rhs)
+    {
+        if (this != &rhs) {
+            clear_values();
+            free(_keys);
+            clone(rhs);
+        }
+        return *this;
+    }
+
+    DenseMap& operator=(DenseMap&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            swap(rhs);
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    ~DenseMap() noexcept
+    {
+        clear_values();
+        free(_keys);
+        _keys = nullptr;
+    }
+
+    void swap(DenseMap& rhs) noexcept
+    {
+        std::swap(_keys, rhs._keys);
+        std::swap(_vals, rhs._vals);
+        std::swap(_hasher, rhs._hasher);
+        std::swap(_empty, rhs._empty);
+        std::swap(_mlf, rhs._mlf);
+        std::swap(_shift, rhs._shift);
+        std::swap(_num_buckets, rhs._num_buckets);
+        std::swap(_num_slots, rhs._num_slots);
+        std::swap(_num_filled, rhs._num_filled);
+    }
+
+    /// Reserves key as the empty marker, only allowed while the map is empty. key can not be inserted.
+    void set_empty_key(const KeyT& key)
+    {
+        assert(_num_filled == 0);
+        _empty = key;
+        std::fill(_keys, _keys + _num_slots + GROUP, _empty);
+    }
+
+    KeyT empty_key() const { return _empty; }
+
+    // -------------------------------------------------------------
+    iterator begin() { return {this, next_bucket(0)}; }
+    const_iterator begin() const { return {this, next_bucket(0)}; }
+    const_iterator cbegin() const { return {this, next_bucket(0)}; }
+
+    iterator end() { return {this, _num_slots}; }
+    const_iterator end() const { return {this, _num_slots}; }
+    const_iterator cend() const { return {this, _num_slots}; }
+
+    size_type size() const { return _num_filled; }
+    bool empty() const { return _num_filled == 0; }
+    size_type bucket_count() const { return _num_buckets; }
+    float load_factor() const { return static_cast<float>(_num_filled) / (float)_num_buckets; }
+
+    /// Bytes held by the table, keys and values of every bucket.
+    size_t memory_size() const { return alloc_size(_num_slots); }
+
+    HashT hash_function() const { return _hasher; }
+    EqT key_eq() const { return EqT(); }
+
+    constexpr float max_load_factor() const { return (1 << 27) / (float)_mlf; }
+    void max_load_factor(float mlf)
+    {
+        if (mlf > EMH_MAX_LOAD_FACTOR)
+            mlf = EMH_MAX_LOAD_FACTOR;
+        if (mlf > EMH_MIN_LOAD_FACTOR) {
+            _mlf = (uint32_t)((1 << 27) / mlf);
+            if (_num_buckets > 0) rehash(_num_buckets);
+        }
+    }
+
+    constexpr size_type max_size() const { return (1ull << (sizeof(size_type) * 8 - 1)) - MAX_PAD; }
+    constexpr size_type max_bucket_count() const { return max_size(); }
+
+    // ------------------------------------------------------------
+    template<typename K = KeyT>
+    iterator find(const K& key) noexcept { return {this, find_filled_bucket(key)}; }
+
+    template<typename K = KeyT>
+    const_iterator find(const K& key) const noexcept { return {this, find_filled_bucket(key)}; }
+
+    template<typename K = KeyT>
+    ValueT& at(const K& key)
+    {
+        const auto bucket = find_filled_bucket(key);
+        //throw
+        return _vals[bucket];
+    }
+
+    template<typename K = KeyT>
+    const ValueT& at(const K& key) const
+    {
+        const auto bucket = find_filled_bucket(key);
+        //throw
+        return _vals[bucket];
+    }
+
+    template<typename K = KeyT>
+    bool contains(const K& key) const noexcept { return find_filled_bucket(key) != _num_slots; }
+
+    template<typename K = KeyT>
+    size_type count(const K& key) const noexcept { return find_filled_bucket(key) != _num_slots ? 1 : 0; }
+
+    ValueT* try_get(const KeyT& key) noexcept
+    {
+        const auto bucket = find_filled_bucket(key);
+        return bucket == _num_slots ? nullptr : _vals + bucket;
+    }
+
+    const ValueT* try_get(const KeyT& key) const noexcept
+    {
+        const auto bucket = find_filled_bucket(key);
+        return bucket == _num_slots ? nullptr : _vals + bucket;
+    }
+
+    // -----------------------------------------------------
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+    std::pair<iterator, bool> insert(const KeyT& key, const ValueT& val) { return try_emplace(key, val); }
+
+    template <typename Iter>
+    void insert(Iter first, Iter last)
+    {
+        reserve(_num_filled + (size_type)std::distance(first, last));
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const KeyT& key, Args&&... args) { return try_emplace(key, std::forward<Args>(args)...); }
+
+    std::pair<iterator, bool> emplace(const value_type& value) { return insert(value); }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const KeyT& key, Args&&... args)
+    {
+        check_expand_need();
+        bool isempty;
+        const auto bucket = find_or_allocate(key, isempty);
+        if (isempty)
+            new_value(bucket, key, std::forward<Args>(args)...);
+        return { {this, bucket}, isempty };
+    }
+
+    template<typename V>
+    std::pair<iterator, bool> insert_or_assign(const KeyT& key, V&& val)
+    {
+        check_expand_need();
+        bool isempty;
+        const auto bucket = find_or_allocate(key, isempty);
+        if (isempty)
+            new_value(bucket, key, std::forward<V>(val));
+        else
+            _vals[bucket] = std::forward<V>(val);
+        return { {this, bucket}, isempty };
+    }
+
+    /// The key must not be in the map.
+    template<typename V>
+    size_type insert_unique(const KeyT& key, V&& val)
+    {
+        check_expand_need();
+        const auto bucket = find_unique_bucket(key);
+        new_value(bucket, key, std::forward<V>(val));
+        return bucket;
+    }
+
+    ValueT& operator[](const KeyT& key)
+    {
+        check_expand_need();
+        bool isempty;
+        const auto bucket = find_or_allocate(key, isempty);
+        if (isempty)
+            new_value(bucket, key);
+        return _vals[bucket];
+    }
+
+    // -------------------------------------------------------
+    size_type erase(const KeyT& key) noexcept
+    {
+        const auto bucket = find_filled_bucket(key);
+        if (bucket == _num_slots)
+            return 0;
+
+        erase_bucket(bucket);
+        return 1;
+    }
+
+    /// A later element may be shifted back into the erased bucket, it is returned next.
+    iterator erase(const const_iterator& cit) noexcept
+    {
+        erase_bucket(cit.bucket());
+        return {this, next_bucket(cit.bucket())};
+    }
+
+    iterator erase(const iterator& it) noexcept { return erase(const_iterator(it)); }
+
+    void clear() noexcept
+    {
+        clear_values();
+        std::fill(_keys, _keys + _num_slots, _empty);
+        _num_filled = 0;
+    }
+
+    void shrink_to_fit(const float min_factor = EMH_DEFAULT_LOAD_FACTOR / 4)
+    {
+        if (load_factor() < min_factor && bucket_count() > 10)
+            rehash(_num_filled + 1);
+    }
+
+    bool reserve(uint64_t num_elems)
+    {
+        const auto required_buckets = num_elems * _mlf >> 27;
+        if (EMH_LIKELY(required_buckets < _num_buckets))
+            return false;
+
+        rehash(required_buckets + 2);
+        return true;
+    }
+
+    void rehash(uint64_t required_buckets)
+    {
+        if (required_buckets < _num_filled)
+            return;
+
+        uint64_t buckets = 8;
+        while (buckets < required_buckets || buckets * max_load_factor() <= _num_filled) { buckets *= 2; }
+        assert(buckets < max_size());
+
+        //a run spilling over the padding is very unlikely, it is handled by growing
+        while (!rebuild((size_type)buckets))
+            buckets *= 2;
+    }
+
+private:
+    static size_type pad_size(size_type num_buckets) { return num_buckets < MAX_PAD ? num_buckets : MAX_PAD; }
+
+    static size_t keys_size(size_type num_slots)
+    {
+        const auto bytes = (size_t)(num_slots + GROUP) * sizeof(KeyT);
+        return (bytes + alignof(ValueT) - 1) / alignof(ValueT) * alignof(ValueT);
+    }
+
+    static size_t alloc_size(size_type num_slots) { return keys_size(num_slots) + (size_t)num_slots * sizeof(ValueT); }
+
+    bool rebuild(size_type num_buckets)
+    {
+        const auto num_slots = num_buckets + pad_size(num_buckets);
+        auto* new_keys = (KeyT*)malloc(alloc_size(num_slots));
+        auto* new_vals = (ValueT*)((char*)new_keys + keys_size(num_slots));
+        std::fill(new_keys, new_keys + num_slots + GROUP, _empty);
+
+        const auto shift = 64 - (uint32_t)CTZ(num_buckets);
+        auto* moved = (!std::is_empty<ValueT>::value && _num_filled) ? (size_type*)malloc(_num_slots * sizeof(size_type)) : nullptr;
+        for (size_type bucket = 0, left = _num_filled; left > 0; bucket++) {
+            const auto key = _keys[bucket];
+            if (key == _empty)
+                continue;
+
+            left --;
+            const auto new_bucket = find_empty_bucket(new_keys, hash_bucket(key, shift));
+            if (EMH_UNLIKELY(new_bucket >= num_slots)) {
+                free(moved);
+                free(new_keys);
+                return false;
+            }
+            new_keys[new_bucket] = key;
+            if (moved)
+                moved[bucket] = new_bucket;
+        }
+
+        for (size_type bucket = 0, left = _num_filled; left > 0; bucket++) {
+            if (_keys[bucket] == _empty)
+                continue;
+
+            left --;
+            auto& val = _vals[bucket];
+            new(new_vals + (moved ? moved[bucket] : 0)) ValueT(std::move(val));
+            val.~ValueT();
+        }
+
+        free(moved);
+        free(_keys);
+        _keys        = new_keys;
+        _vals        = new_vals;
+        _shift       = shift;
+        _num_buckets = num_buckets;
+        _num_slots   = num_slots;
+        return true;
+    }
+
+    void clone(const DenseMap& rhs)
+    {
+        _hasher      = rhs._hasher;
+        _empty       = rhs._empty;
+        _mlf         = rhs._mlf;
+        _shift       = rhs._shift;
+        _num_buckets = rhs._num_buckets;
+        _num_slots   = rhs._num_slots;
+        _num_filled  = rhs._num_filled;
+
+        _keys = (KeyT*)malloc(alloc_size(_num_slots));
+        _vals = (ValueT*)((char*)_keys + keys_size(_num_slots));
+        memcpy((char*)_keys, (char*)rhs._keys, (size_t)(_num_slots + GROUP) * sizeof(KeyT));
+        if (std::is_trivially_copyable<ValueT>::value) {
+            memcpy((char*)_vals, (char*)rhs._vals, (size_t)_num_slots * sizeof(ValueT));
+            return;
+        }
+
+        for (size_type bucket = 0, left = _num_filled; left > 0; bucket++) {
+            if (_keys[bucket] != _empty) {
+                new(_vals + bucket) ValueT(rhs._vals[bucket]);
+                left --;
+            }
+        }
+    }
+
+    void clear_values() noexcept
+    {
+        if (!std::is_trivially_destructible<ValueT>::value) {
+            for (size_type bucket = 0, left = _num_filled; left > 0; bucket++) {
+                if (_keys[bucket] != _empty) {
+                    _vals[bucket].~ValueT();
+                    left --;
+                }
+            }
+        }
+    }
+
+    template<typename... Args>
+    void new_value(size_type bucket, const KeyT& key, Args&&... args)
+    {
+        assert(key != _empty);
+        new(_vals + bucket) ValueT(std::forward<Args>(args)...);
+        _keys[bucket] = key;
+        _num_filled ++;
+    }
+
+    bool check_expand_need()
+    {
+        return reserve(_num_filled);
+    }
+
+    //fibonacci hashing on top of HashT, the high bits pick the bucket
+    inline size_type hash_bucket(const KeyT& key, uint32_t shift) const
+    {
+        return (size_type)(((uint64_t)_hasher(key) * UINT64_C(11400714819323198485)) >> shift);
+    }
+
+    inline size_type hash_bucket(const KeyT& key) const { return hash_bucket(key, _shift); }
+
+    size_type next_bucket(size_type bucket) const
+    {
+        if (_keys[bucket] != _empty)
+            return bucket;
+
+        while (bucket < _num_slots) {
+            const auto filled = ~match_group(_keys + bucket, _empty) & ((1u << GROUP) - 1);
+            if (filled)
+                return std::min(bucket + CTZ(filled), _num_slots);
+            bucket += GROUP;
+        }
+        return _num_slots;
+    }
+
+    size_type find_empty_bucket(const KeyT* keys, size_type bucket) const
+    {
+        while (true) {
+            const auto empty = match_group(keys + bucket, _empty);
+            if (empty)
+                return bucket + CTZ(empty);
+            bucket += GROUP;
+        }
+    }
+
+    //runs have no hole so a key can not sit after an empty bucket of its run,
+    //the padding keys after the last slot are empty and stop every probe
+    template<typename K = KeyT>
+    size_type find_filled_bucket(const K& key) const noexcept
+    {
+        if (EMH_UNLIKELY(key == _empty))
+            return _num_slots;
+
+        auto bucket = hash_bucket(key);
+        while (true) {
+            const auto hit = match_group(_keys + bucket, (KeyT)key);
+            if (hit)
+                return bucket + CTZ(hit);
+            else if (match_group(_keys + bucket, _empty))
+                return _num_slots;
+            bucket += GROUP;
+        }
+    }
+
+    size_type find_or_allocate(const KeyT& key, bool& isempty)
+    {
+        auto bucket = hash_bucket(key);
+        while (true) {
+            const auto hit = match_group(_keys + bucket, key);
+            if (hit) {
+                isempty = false;
+                return bucket + CTZ(hit);
+            }
+
+            const auto empty = match_group(_keys + bucket, _empty);
+            if (empty) {
+                isempty = true;
+                bucket += CTZ(empty);
+                if (EMH_LIKELY(bucket < _num_slots))
+                    return bucket;
+
+                rehash(_num_buckets * 2);
+                bucket = hash_bucket(key);
+                continue;
+            }
+            bucket += GROUP;
+        }
+    }
+
+    size_type find_unique_bucket(const KeyT& key)
+    {
+        auto bucket = find_empty_bucket(_keys, hash_bucket(key));
+        while (EMH_UNLIKELY(bucket >= _num_slots)) {
+            rehash(_num_buckets * 2);
+            bucket = find_empty_bucket(_keys, hash_bucket(key));
+        }
+        return bucket;
+    }
+
+    //backward shift: move later keys of the run whose main bucket is not after the hole
+    void erase_bucket(size_type bucket) noexcept
+    {
+        auto hole = bucket;
+        for (auto next = bucket + 1; _keys[next] != _empty; next++) {
+            if (hash_bucket(_keys[next]) <= hole) {
+                _keys[hole] = _keys[next];
+                _vals[hole] = std::move(_vals[next]);
+                hole = next;
+            }
+        }
+
+        _keys[hole] = _empty;
+        _vals[hole].~ValueT();
+        _num_filled --;
+    }
+
+private:
+    KeyT*     _keys;
+    ValueT*   _vals;
+    HashT     _hasher;
+    KeyT      _empty;
+    uint32_t  _mlf;
+    uint32_t  _shift;
+    size_type _num_buckets;
+    size_type _num_slots; //buckets plus padding
+    size_type _num_filled;
+};
+
+template <typename KeyT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+class DenseSet
+{
+    static_assert(std::is_integral<KeyT>::value && sizeof(KeyT) > 1, "DenseSet needs an integer key of 2 bytes or more");
+    static_assert(std::is_same<EqT, std::equal_to<KeyT>>::value, "DenseSet compares keys bitwise");
+
+    constexpr static float EMH_DEFAULT_LOAD_FACTOR = 0.80f;
+    constexpr static float EMH_MIN_LOAD_FACTOR     = 0.25f;
+    constexpr static float EMH_MAX_LOAD_FACTOR     = 0.95f;
+    constexpr static uint32_t GROUP = GROUP_BYTES / sizeof(KeyT);
+
+public:
+    typedef DenseSet<KeyT, HashT, EqT> htype;
+    typedef KeyT  value_type;
+    typedef KeyT  key_type;
+    typedef HashT hasher;
+    typedef EqT   key_equal;
+
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::ptrdiff_t            difference_type;
+        typedef KeyT                      value_type;
+        typedef const KeyT*               pointer;
+        typedef const KeyT&               reference;
+
+        const_iterator() : _set(nullptr), _bucket(0) {}
+        const_iterator(const htype* hash_set, size_type bucket) : _set(hash_set), _bucket(bucket) {}
+
+        const_iterator& operator++()
+        {
+            _bucket = _set->next_bucket(_bucket + 1);
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto old = *this;
+            _bucket = _set->next_bucket(_bucket + 1);
+            return old;
+        }
+
+        reference operator*() const { return _set->_keys[_bucket]; }
+        pointer operator->() const { return _set->_keys + _bucket; }
+
+        bool operator==(const const_iterator& rhs) const { return _bucket == rhs._bucket; }
+        bool operator!=(const const_iterator& rhs) const { return _bucket != rhs._bucket; }
+        size_type bucket() const { return _bucket; }
+
+    private:
+        const htype* _set;
+        size_type    _bucket;
+    };
+    typedef const_iterator iterator;
+
+    void init(size_type bucket, float mlf = EMH_DEFAULT_LOAD_FACTOR)
+    {
+        _keys = nullptr;
+        _empty = default_empty_key<KeyT>();
+        _num_buckets = _num_slots = _num_filled = 0;
+        _mlf = (uint32_t)((1 << 27) / EMH_DEFAULT_LOAD_FACTOR);
+        max_load_factor(mlf);
+        rehash(bucket);
+    }
+
+    DenseSet(size_type bucket = 4, float mlf = EMH_DEFAULT_LOAD_FACTOR)
+    {
+        init(bucket, mlf);
+    }
+
+    DenseSet(const DenseSet& rhs)
+    {
+        _keys = nullptr;
+        clone(rhs);
+    }
+
+    DenseSet(DenseSet&& rhs) noexcept
+    {
+        init(4);
+        swap(rhs);
+    }
+
+    DenseSet(std::initializer_list<value_type> ilist)
+    {
+        init((size_type)ilist.size());
+        for (auto it = ilist.begin(); it != ilist.end(); ++it)
+            insert(*it);
+    }
+
+    DenseSet& operator=(const DenseSet& rhs)
+    {
+        if (this != &rhs) {
+            free(_keys);
+            clone(rhs);
+        }
+        return *this;
+    }
+
+    DenseSet& operator=(DenseSet&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            swap(rhs);
+            rhs.clear();
+        }
+        return *this;
+    }
+
+    ~DenseSet() noexcept
+    {
+        free(_keys);
+        _keys = nullptr;
+    }
+
+    void swap(DenseSet& rhs) noexcept
+    {
+        std::swap(_keys, rhs._keys);
+        std::swap(_hasher, rhs._hasher);
+        std::swap(_empty, rhs._empty);
+        std::swap(_mlf, rhs._mlf);
+        std::swap(_shift, rhs._shift);
+        std::swap(_num_buckets, rhs._num_buckets);
+        std::swap(_num_slots, rhs._num_slots);
+        std::swap(_num_filled, rhs._num_filled);
+    }
+
+    /// Reserves key as the empty marker, only allowed while the set is empty. key can not be inserted.
+    void set_empty_key(const KeyT& key)
+    {
+        assert(_num_filled == 0);
+        _empty = key;
+        std::fill(_keys, _keys + _num_slots + GROUP, _empty);
+    }
+
+    KeyT empty_key() const { return _empty; }
+
+    // -------------------------------------------------------------
+    const_iterator begin() const { return {this, next_bucket(0)}; }
+    const_iterator cbegin() const { return {this, next_bucket(0)}; }
+    const_iterator end() const { return {this, _num_slots}; }
+    const_iterator cend() const { return {this, _num_slots}; }
+
+    size_type size() const { return _num_filled; }
+    bool empty() const { return _num_filled == 0; }
+    size_type bucket_count() const { return _num_buckets; }
+    float load_factor() const { return static_cast<float>(_num_filled) / (float)_num_buckets; }
+    size_t memory_size() const { return (size_t)(_num_slots + GROUP) * sizeof(KeyT); }
+
+    constexpr float max_load_factor() const { return (1 << 27) / (float)_mlf; }
+    void max_load_factor(float mlf)
+    {
+        if (mlf > EMH_MAX_LOAD_FACTOR)
+            mlf = EMH_MAX_LOAD_FACTOR;
+        if (mlf > EMH_MIN_LOAD_FACTOR) {
+            _mlf = (uint32_t)((1 << 27) / mlf);
+            if (_num_buckets > 0) rehash(_num_buckets);
+        }
+    }
+
+    constexpr size_type max_size() const { return (1ull << (sizeof(size_type) * 8 - 1)) - MAX_PAD; }
+
+    // ------------------------------------------------------------
+    const_iterator find(const KeyT& key) const noexcept { return {this, find_filled_bucket(key)}; }
+    bool contains(const KeyT& key) const noexcept { return find_filled_bucket(key) != _num_slots; }
+    size_type count(const KeyT& key) const noexcept { return find_filled_bucket(key) != _num_slots ? 1 : 0; }
+
+    std::pair<iterator, bool> insert(const KeyT& key)
+    {
+        assert(key != _empty);
+        reserve(_num_filled);
+        auto bucket = hash_bucket(key);
+        while (true) {
+            const auto hit = match_group(_keys + bucket, key);
+            if (hit)
+                return { {this, bucket + CTZ(hit)}, false };
+
+            const auto empty = match_group(_keys + bucket, _empty);
+            if (empty) {
+                bucket += CTZ(empty);
+                if (EMH_UNLIKELY(bucket >= _num_slots)) {
+                    rehash(_num_buckets * 2);
+                    bucket = hash_bucket(key);
+                    continue;
+                }
+                _keys[bucket] = key;
+                _num_filled ++;
+                return { {this, bucket}, true };
+            }
+            bucket += GROUP;
+        }
+    }
+
+    std::pair<iterator, bool> emplace(const KeyT& key) { return insert(key); }
+
+    template <typename Iter>
+    void insert(Iter first, Iter last)
+    {
+        reserve(_num_filled + (size_type)std::distance(first, last));
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    size_type erase(const KeyT& key) noexcept
+    {
+        const auto bucket = find_filled_bucket(key);
+        if (bucket == _num_slots)
+            return 0;
+
+        erase_bucket(bucket);
+        return 1;
+    }
+
+    /// A later key may be shifted back into the erased bucket, it is returned next.
+    iterator erase(const const_iterator& cit) noexcept
+    {
+        erase_bucket(cit.bucket());
+        return {this, next_bucket(cit.bucket())};
+    }
+
+    void clear() noexcept
+    {
+        std::fill(_keys, _keys + _num_slots, _empty);
+        _num_filled = 0;
+    }
+
+    bool reserve(uint64_t num_elems)
+    {
+        const auto required_buckets = num_elems * _mlf >> 27;
+        if (EMH_LIKELY(required_buckets < _num_buckets))
+            return false;
+
+        rehash(required_buckets + 2);
+        return true;
+    }
+
+    void rehash(uint64_t required_buckets)
+    {
+        if (required_buckets < _num_filled)
+            return;
+
+        uint64_t buckets = 8;
+        while (buckets < required_buckets || buckets * max_load_factor() <= _num_filled) { buckets *= 2; }
+        assert(buckets < max_size());
+
+        while (!rebuild((size_type)buckets))
+            buckets *= 2;
+    }
+
+private:
+    bool rebuild(size_type num_buckets)
+    {
+        const auto num_slots = num_buckets + (num_buckets < MAX_PAD ? num_buckets : MAX_PAD);
+        auto* new_keys = (KeyT*)malloc((size_t)(num_slots + GROUP) * sizeof(KeyT));
+        std::fill(new_keys, new_keys + num_slots + GROUP, _empty);
+
+        const auto shift = 64 - (uint32_t)CTZ(num_buckets);
+        for (size_type bucket = 0, left = _num_filled; left > 0; bucket++) {
+            const auto key = _keys[bucket];
+            if (key == _empty)
+                continue;
+
+            left --;
+            const auto new_bucket = find_empty_bucket(new_keys, hash_bucket(key, shift));
+            if (EMH_UNLIKELY(new_bucket >= num_slots)) {
+                free(new_keys);
+                return false;
+            }
+            new_keys[new_bucket] = key;
+        }
+
+        free(_keys);
+        _keys        = new_keys;
+        _shift       = shift;
+        _num_buckets = num_buckets;
+        _num_slots   = num_slots;
+        return true;
+    }
+
+    void clone(const DenseSet& rhs)
+    {
+        _hasher      = rhs._hasher;
+        _empty       = rhs._empty;
+        _mlf         = rhs._mlf;
+        _shift       = rhs._shift;
+        _num_buckets = rhs._num_buckets;
+        _num_slots   = rhs._num_slots;
+        _num_filled  = rhs._num_filled;
+
+        _keys = (KeyT*)malloc((size_t)(_num_slots + GROUP) * sizeof(KeyT));
+        memcpy((char*)_keys, (char*)rhs._keys, (size_t)(_num_slots + GROUP) * sizeof(KeyT));
+    }
+
+    inline size_type hash_bucket(const KeyT& key, uint32_t shift) const
+    {
+        return (size_type)(((uint64_t)_hasher(key) * UINT64_C(11400714819323198485)) >> shift);
+    }
+
+    inline size_type hash_bucket(const KeyT& key) const { return hash_bucket(key, _shift); }
+
+    size_type next_bucket(size_type bucket) const
+    {
+        if (_keys[bucket] != _empty)
+            return bucket;
+
+        while (bucket < _num_slots) {
+            const auto filled = ~match_group(_keys + bucket, _empty) & ((1u << GROUP) - 1);
+            if (filled)
+                return std::min(bucket + CTZ(filled), _num_slots);
+            bucket += GROUP;
+        }
+        return _num_slots;
+    }
+
+    size_type find_empty_bucket(const KeyT* keys, size_type bucket) const
+    {
+        while (true) {
+            const auto empty = match_group(keys + bucket, _empty);
+            if (empty)
+                return bucket + CTZ(empty);
+            bucket += GROUP;
+        }
+    }
+
+    size_type find_filled_bucket(const KeyT& key) const noexcept
+    {
+        if (EMH_UNLIKELY(key == _empty))
+            return _num_slots;
+
+        auto bucket = hash_bucket(key);
+        while (true) {
+            const auto hit = match_group(_keys + bucket, key);
+            if (hit)
+                return bucket + CTZ(hit);
+            else if (match_group(_keys + bucket, _empty))
+                return _num_slots;
+            bucket += GROUP;
+        }
+    }
+
+    void erase_bucket(size_type bucket) noexcept
+    {
+        auto hole = bucket;
+        for (auto next = bucket + 1; _keys[next] != _empty; next++) {
+            if (hash_bucket(_keys[next]) <= hole) {
+                _keys[hole] = _keys[next];
+                hole = next;
+            }
+        }
+
+        _keys[hole] = _empty;
+        _num_filled --;
+    }
+
+private:
+    KeyT*     _keys;
+    HashT     _hasher;
+    KeyT      _empty;
+    uint32_t  _mlf;
+    uint32_t  _shift;
+    size_type _num_buckets;
+    size_type _num_slots;
+    size_type _num_filled;
+};
+} // namespace emhash9
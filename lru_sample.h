@@ -0,0 +1,156 @@
+// By Huang Yuanbing 2019-2024
+// bailuzhou@163.com
+// version 1.0.0
+
+// LICENSE:
+//   This software is dual-licensed to the public domain and under the following
+//   license: you are granted a perpetual, irrevocable license to copy, modify,
+//   publish, and distribute this file as you see fit.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "hash_table8.hpp"
+
+namespace emlru_sample {
+
+/// An approximate lru cache in the way of Redis. Every entry keeps the logical time of its
+/// last access and a full cache evicts the oldest of a few entries drawn by
+/// emhash8::HashMap::sample(), there is no list linking the entries and nothing is scanned.
+/// With 5 samples the victim is on average older than 5/6 of the cache, 10 samples come close
+/// to an exact lru at twice the eviction cost.
+template <typename KeyT, typename ValueT, typename HashT = emhash8::default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+class lru_cache
+{
+    struct slot
+    {
+        ValueT   value;
+        uint32_t stamp;
+    };
+
+    typedef emhash8::HashMap<KeyT, slot, HashT, EqT> map_type;
+
+    //xorshift64*, the cache only needs cheap and well spread draws
+    struct xorshift
+    {
+        typedef uint64_t result_type;
+        static constexpr uint64_t (min)() { return 0; }
+        static constexpr uint64_t (max)() { return UINT64_MAX; }
+
+        uint64_t state;
+        uint64_t operator()()
+        {
+            state ^= state >> 12; state ^= state << 25; state ^= state >> 27;
+            return state * UINT64_C(2685821657736338717);
+        }
+    };
+
+public:
+    typedef KeyT   key_type;
+    typedef ValueT mapped_type;
+    typedef size_t size_type;
+
+    lru_cache(size_type capacity, uint32_t samples = 5, uint64_t seed = 0x9E3779B97F4A7C15ull)
+        :_capacity(capacity > 0 ? capacity : 1), _samples(samples > 0 ? samples : 1), _clock(0), _evictions(0)
+    {
+        _rng.state = seed | 1;
+        _map.reserve(_capacity + 1);
+    }
+
+    /// Returns the matching value or nullptr, a hit makes the entry the most recently used.
+    ValueT* try_get(const KeyT& key) noexcept
+    {
+        const auto it = _map.find(key);
+        if (it == _map.end())
+            return nullptr;
+
+        it->second.stamp = ++_clock;
+        return &it->second.value;
+    }
+
+    /// Returns false if key isn't found.
+    bool try_get(const KeyT& key, ValueT& val) noexcept
+    {
+        const auto pval = try_get(key);
+        if (pval)
+            val = *pval;
+        return pval != nullptr;
+    }
+
+    /// Inserts key if it is missing, evicting one entry from a full cache.
+    /// An existing entry keeps its value and only becomes the most recently used.
+    std::pair<ValueT*, bool> insert(const KeyT& key, const ValueT& value)
+    {
+        const auto it = _map.find(key);
+        if (it != _map.end()) {
+            it->second.stamp = ++_clock;
+            return { &it->second.value, false };
+        }
+
+        if (_map.size() >= _capacity)
+            evict();
+        _map.insert_unique(key, slot{value, ++_clock});
+        return { &_map.back().second.value, true };
+    }
+
+    void insert_or_assign(const KeyT& key, ValueT value)
+    {
+        const auto result = insert(key, value);
+        if (!result.second)
+            *result.first = std::move(value);
+    }
+
+    size_type erase(const KeyT& key)
+    {
+        return _map.erase(key);
+    }
+
+    bool contains(const KeyT& key) const
+    {
+        return _map.contains(key);
+    }
+
+    void clear()
+    {
+        _map.clear();
+    }
+
+    size_type size() const { return _map.size(); }
+    bool empty() const { return _map.empty(); }
+    size_type capacity() const { return _capacity; }
+
+    /// Entries evicted so far to make room for an insert.
+    size_t evictions() const { return _evictions; }
+
+    /// Number of entries drawn per eviction, more is closer to an exact lru.
+    void samples(uint32_t value) { _samples = value > 0 ? value : 1; }
+
+private:
+    void evict()
+    {
+        auto victim = _map.sample(_rng);
+        for (uint32_t i = 1; i < _samples; i++) {
+            const auto it = _map.sample(_rng);
+            //the stamp difference stays right when the 32-bit clock wraps around
+            if ((int32_t)(it->second.stamp - victim->second.stamp) < 0)
+                victim = it;
+        }
+
+        _map.erase(victim);
+        _evictions ++;
+    }
+
+protected:
+    //a derived test cache may start _clock just below the 32-bit wrap
+    map_type _map;
+    size_type _capacity;
+    uint32_t _samples;
+    uint32_t _clock;
+    size_t   _evictions;
+    xorshift _rng;
+};
+
+}
@@ -33,6 +33,8 @@
 #include <ctime>
 #include <algorithm>
 
+#include "hash_stats.hpp"
+
 #ifdef __has_include
     #if __has_include("wyhash.h")
     #include "wyhash.h"
@@ -49,6 +51,13 @@
     #undef  NEW_KVALUE
 #endif
 
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 // likely/unlikely
 #if (__GNUC__ >= 4 || __clang__)
 #    define EMHASH_LIKELY(condition) __builtin_expect(condition, 1)
@@ -63,7 +72,7 @@
 #define NEXT_BUCKET(p,n) p[n].bucket
 #define EMH_PKV(p,n)     p[n]
 #define NEW_KVALUE(key, value, bucket) new(_pairs + bucket) PairT(key, value, bucket);  _num_filled ++;\
-                                           update_sum_orderid(_pairs[bucket].orderid)
+                                           update_sum_orderid(_pairs[bucket].orderid); add_weight(bucket)
 
 namespace emlru_size {
 
@@ -164,12 +173,24 @@ struct entry {
     uint32_t orderid;
 };// __attribute__ ((packed));
 
+/// Cache health returned by stats(), the same figures as emhash7/8 stats().
+using cache_stats = emhash::HashStats;
+
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
+/// Default weigher, every entry weighs 1 and the cache is only bounded by entry count.
+struct unit_weight
+{
+    template <typename K, typename V>
+    constexpr size_t operator()(const K&, const V&) const { return 1; }
+};
+
 /// A cache-friendly hash table with open addressing, linear/qua probing and power-of-two capacity
-template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>, typename WeightT = unit_weight>
 class lru_cache
 {
 private:
-    typedef lru_cache<KeyT, ValueT, HashT, EqT> htype;
+    typedef lru_cache<KeyT, ValueT, HashT, EqT, WeightT> htype;
     typedef entry<KeyT, ValueT>             PairT;
     typedef entry<KeyT, ValueT>             value_pair;
 
@@ -311,6 +332,8 @@ public:
         _pairs = nullptr;
         _num_filled = 0;
         _max_buckets = max_bucket;
+        _sum_weight = 0;
+        _max_weight = 0;
         max_load_factor(0.85f);
     }
 
@@ -385,6 +408,9 @@ public:
         _loadlf      = other._loadlf;
         _max_buckets = other._max_buckets;
         _sum_orderid = other._sum_orderid;
+        _weigher     = other._weigher;
+        _sum_weight  = other._sum_weight;
+        _max_weight  = other._max_weight;
         auto opairs  = other._pairs;
 
         if (std::is_pod<KeyT>::value && std::is_pod<ValueT>::value) {
@@ -409,6 +435,9 @@ public:
         std::swap(_loadlf, other._loadlf);
         std::swap(_max_buckets, other._max_buckets);
         std::swap(_sum_orderid, other._sum_orderid);
+        std::swap(_weigher, other._weigher);
+        std::swap(_sum_weight, other._sum_weight);
+        std::swap(_max_weight, other._max_weight);
     }
 
     // -------------------------------------------------------------
@@ -503,6 +532,56 @@ public:
         return (1 << 30);
     }
 
+    /// Always available unlike dump_statis(), only every 1/sample_ratio-th bucket is walked
+    cache_stats stats(float sample_ratio = 1.0f) const
+    {
+        constexpr uintptr_t cache_line_size = 64;
+        cache_stats st = {};
+        st.size        = _num_filled;
+        st.buckets     = _num_buckets;
+        st.load_factor = load_factor();
+        st.bytes       = _pairs ? (2 + _num_buckets) * sizeof(PairT) : 0;
+        if (_num_filled == 0)
+            return st;
+
+        const uint32_t step = sample_ratio >= 1.0f || sample_ratio <= 0 ? 1 : (uint32_t)(1 / sample_ratio);
+        size_t occupied = 0, mains = 0, hits = 0, hit_lines = 0, miss_lines = 0;
+        for (uint32_t bucket = 0; bucket < _num_buckets; bucket += step) {
+            st.sampled ++;
+            auto next_bucket = NEXT_BUCKET(_pairs, bucket);
+            if (next_bucket == INACTIVE) {
+                st.chains[0] ++;
+                miss_lines ++;
+                continue;
+            }
+
+            const bool is_main = hash_bucket(EMH_KEY(_pairs, bucket)) == bucket;
+            size_t lines = 1, chain_size = 1, chain_hit = 1;
+            for (auto cur_bucket = bucket; next_bucket != cur_bucket; ) {
+                if ((uintptr_t)(_pairs + next_bucket) / cache_line_size != (uintptr_t)(_pairs + cur_bucket) / cache_line_size)
+                    lines ++;
+                chain_size ++;
+                chain_hit += lines;
+                cur_bucket  = next_bucket;
+                next_bucket = NEXT_BUCKET(_pairs, cur_bucket);
+            }
+
+            occupied ++;
+            miss_lines += lines;
+            if (is_main) {
+                mains ++;
+                hits += chain_size;
+                hit_lines += chain_hit;
+                st.chains[chain_size < 16 ? chain_size : 16] ++;
+            }
+        }
+
+        st.main_ratio = occupied ? (float)mains / occupied : 0;
+        st.hit_lines  = hits ? (float)hit_lines / hits : 0;
+        st.miss_lines = (float)miss_lines / st.sampled;
+        return st;
+    }
+
 #ifdef EMHASH_STATIS
     //Returns the bucket number where the element with key k is located.
     size_type bucket(const KeyT& key) const
@@ -701,6 +780,7 @@ public:
     /// and a bool denoting whether the insertion took place.
     std::pair<iterator, bool> insert(const KeyT& key, const ValueT& value)
     {
+        check_weight_need(key, value);
         check_expand_need();
         const auto bucket = find_or_allocate(key);
         const auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
@@ -714,6 +794,7 @@ public:
 
     std::pair<iterator, bool> insert(KeyT&& key, ValueT&& value)
     {
+        check_weight_need(key, value);
         check_expand_need();
         const auto bucket = find_or_allocate(key);
         const auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
@@ -793,6 +874,7 @@ public:
     /// Same as above, but contains(key) MUST be false
     uint32_t insert_unique(const KeyT& key, const ValueT& value)
     {
+        check_weight_need(key, value);
         check_expand_need();
         auto bucket = find_unique_bucket(key);
         NEW_KVALUE(key, value, bucket);
@@ -801,6 +883,7 @@ public:
 
     uint32_t insert_unique(KeyT&& key, ValueT&& value)
     {
+        check_weight_need(key, value);
         check_expand_need();
         auto bucket = find_unique_bucket(key);
         NEW_KVALUE(std::move(key), std::move(value), bucket);
@@ -851,17 +934,37 @@ public:
 
     std::pair<iterator, bool> insert_or_assign(const KeyT& key, ValueT&& value)
     {
-        return insert(key, std::move(value));
+        check_weight_need(key, value);
+        check_expand_need();
+        const auto bucket = find_or_allocate(key);
+        const auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
+        if (found) {
+            NEW_KVALUE(key, std::move(value), bucket);
+        } else {
+            assign_value(bucket, std::move(value));
+        }
+        return { {this, bucket}, found };
     }
 
     std::pair<iterator, bool> insert_or_assign(KeyT&& key, ValueT&& value)
     {
-        return insert(std::move(key), std::move(value));
+        check_weight_need(key, value);
+        check_expand_need();
+        const auto bucket = find_or_allocate(key);
+        const auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
+        if (found) {
+            NEW_KVALUE(std::move(key), std::move(value), bucket);
+        } else {
+            assign_value(bucket, std::move(value));
+        }
+        return { {this, bucket}, found };
     }
 
     /// Like std::map<KeyT,ValueT>::operator[].
     ValueT& operator[](const KeyT& key)
     {
+        if (is_weighted())
+            check_weight_need(key, ValueT());
         check_expand_need();
         auto bucket = find_or_allocate(key);
         /* Check if inserting a new value rather than overwriting an old entry */
@@ -875,6 +978,8 @@ public:
 
     ValueT& operator[](KeyT&& key)
     {
+        if (is_weighted())
+            check_weight_need(key, ValueT());
         check_expand_need();
         auto bucket = find_or_allocate(key);
         /* Check if inserting a new value rather than overwriting an old entry */
@@ -895,6 +1000,7 @@ public:
         if (bucket == INACTIVE)
             return 0;
 
+        sub_weight(bucket);
         clear_bucket(bucket);
         return 1;
     }
@@ -905,6 +1011,7 @@ public:
         iterator it(this, cit._bucket);
 
         const auto bucket = erase_bucket(it._bucket);
+        sub_weight(bucket);
         clear_bucket(bucket);
         //erase from main bucket, return main bucket as next
         return (bucket == it._bucket) ? ++it : it;
@@ -913,6 +1020,7 @@ public:
     void _erase(const_iterator it)
     {
         const auto bucket = erase_bucket(it._bucket);
+        sub_weight(bucket);
         clear_bucket(bucket);
     }
 
@@ -943,6 +1051,29 @@ public:
 
         _num_filled = 0;
         _sum_orderid = 0;
+        _sum_weight = 0;
+    }
+
+    /// Total weight of all entries as summed by the weigher.
+    uint64_t total_weight() const
+    {
+        return is_weighted() ? _sum_weight : _num_filled;
+    }
+
+    uint64_t max_weight() const
+    {
+        return _max_weight;
+    }
+
+    /// Bound the cache by the total weight of its entries (e.g. bytes) besides max_bucket,
+    /// older entries are evicted before an insert would exceed it. 0 means no budget.
+    /// Values changed in place through operator[] or try_get are not reweighed,
+    /// replace them with insert_or_assign to keep the total exact.
+    void max_weight(uint64_t value)
+    {
+        _max_weight = value;
+        if (is_weighted() && _max_weight && _sum_weight > _max_weight)
+            remove_weight(_max_weight - _max_weight / 4);
     }
 
     inline void update_sum_orderid(int32_t incr)
@@ -992,7 +1123,16 @@ public:
         return true;
     }
 
-    bool remove_half()
+    //evict entries older than the average until the total weight fits max_weight
+    void remove_weight(uint64_t max_weight)
+    {
+        while (_num_filled > 0 && _sum_weight > max_weight) {
+            if (!remove_half(max_weight))
+                break;
+        }
+    }
+
+    bool remove_half(uint64_t max_weight = 0)
     {
         const auto old_nums = _num_filled;
         const auto ts = clock();
@@ -1023,9 +1163,12 @@ public:
             }
 
             const auto bucket = erase_bucket(src_bucket);
+            sub_weight(bucket);
             clear_bucket(bucket);
             if (bucket != src_bucket)
                 src_bucket --;
+            if (max_weight && _sum_weight <= max_weight)
+                break;
         }
 
 #if EMHASH_REHASH_LOG || EMHASH_USE_LOG
@@ -1075,7 +1218,7 @@ public:
         _pairs       = new_pairs;
         for (uint32_t src_bucket = 0; _num_filled < old_num_filled; src_bucket++) {
             if (NEXT_BUCKET(old_pairs, src_bucket) == INACTIVE) {
-                assert(old_pairs.orderid == 0);
+                assert(old_pairs[src_bucket].orderid == 0);
                 continue;
             }
 
@@ -1115,6 +1258,38 @@ private:
         return reserve(_num_filled);
     }
 
+    static constexpr bool is_weighted() noexcept
+    {
+        return !std::is_same<WeightT, unit_weight>::value;
+    }
+
+    // Evict before the new entry would push the total weight over budget
+    inline void check_weight_need(const KeyT& key, const ValueT& value)
+    {
+        if (is_weighted() && _max_weight && _sum_weight + _weigher(key, value) > _max_weight)
+            remove_weight(_max_weight - _max_weight / 4);
+    }
+
+    inline void add_weight(uint32_t bucket)
+    {
+        if (is_weighted())
+            _sum_weight += _weigher(EMH_KEY(_pairs, bucket), EMH_VAL(_pairs, bucket));
+    }
+
+    inline void sub_weight(uint32_t bucket)
+    {
+        if (is_weighted())
+            _sum_weight -= _weigher(EMH_KEY(_pairs, bucket), EMH_VAL(_pairs, bucket));
+    }
+
+    void assign_value(uint32_t bucket, ValueT&& value)
+    {
+        sub_weight(bucket);
+        EMH_VAL(_pairs, bucket) = std::move(value);
+        add_weight(bucket);
+        update_bucket_order(bucket);
+    }
+
     void clear_bucket(uint32_t bucket)
     {
         update_sum_orderid(0 - (int)_pairs[bucket].orderid);
@@ -1138,7 +1313,7 @@ private:
             return eqkey ? bucket : INACTIVE;
          } else if (eqkey) {
             const auto nbucket = NEXT_BUCKET(_pairs, next_bucket);
-            if (is_notrivially())
+            if (is_notrivially() || is_weighted())
                 EMH_PKV(_pairs, bucket).swap(EMH_PKV(_pairs, next_bucket));
             else {
                 const auto orderid = _pairs[bucket].orderid;
@@ -1179,7 +1354,7 @@ private:
                 return bucket;
 
             const auto nbucket = NEXT_BUCKET(_pairs, next_bucket);
-            if (is_notrivially())
+            if (is_notrivially() || is_weighted())
                 EMH_PKV(_pairs, bucket).swap(EMH_PKV(_pairs, next_bucket));
             else {
                 const auto orderid = _pairs[bucket].orderid;
@@ -1462,6 +1637,10 @@ private:
 
     uint32_t  _num_filled;
     uint64_t _sum_orderid;
+
+    WeightT   _weigher;
+    uint64_t  _sum_weight;
+    uint64_t  _max_weight;
 };
 } // namespace emhash
 #if __cplusplus > 199711
@@ -0,0 +1,122 @@
+// By Huang Yuanbing 2019-2024
+// bailuzhou@163.com
+// version 1.0.0
+
+// LICENSE:
+//   This software is dual-licensed to the public domain and under the following
+//   license: you are granted a perpetual, irrevocable license to copy, modify,
+//   publish, and distribute this file as you see fit.
+
+#pragma once
+
+#include <mutex>
+#include <future>
+#include <exception>
+
+#include "hash_table8.hpp"
+#include "lru_time.h"
+
+namespace emlru_time {
+
+/// A mutex guarded lru_cache for concurrent use.
+/// get_or_load() runs at most one loader per key at a time: concurrent callers missing the
+/// same key wait for and share its result instead of recomputing it (no cache stampede).
+/// With a stale window an expired entry is still served during that many seconds while
+/// the first caller reloads it (stale-while-revalidate).
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+class sync_cache
+{
+    typedef std::shared_future<ValueT> flight;
+
+public:
+    sync_cache(uint32_t bucket = 4, uint32_t max_bucket = 1 << 24, int timeout = 3600 * 24 * 365, uint32_t stale = 0)
+        :_cache(bucket, max_bucket, timeout), _stale(stale)
+    {
+    }
+
+    /// Returns the cached value of key, or the result of loader(key) which is then cached.
+    /// If the loader throws, the exception reaches every caller waiting on it.
+    template <typename Loader>
+    ValueT get_or_load(const KeyT& key, Loader&& loader)
+    {
+        std::promise<ValueT> promise;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            const auto now_ts = nowts();
+            const auto pentry = _cache.try_get_entry(key);
+            if (pentry && pentry->timeout >= now_ts)
+                return pentry->second;
+
+            const auto stale = pentry && (uint64_t)pentry->timeout + _stale >= now_ts;
+            const auto it = _loading.find(key);
+            if (it != _loading.end()) {
+                //another caller revalidates, this one keeps the stale value
+                if (stale)
+                    return pentry->second;
+
+                const auto result = it->second;
+                lock.unlock();
+                return result.get();
+            }
+
+            _loading.emplace(key, promise.get_future().share());
+        }
+
+        return load(key, loader, promise);
+    }
+
+    bool try_get(const KeyT& key, ValueT& val)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache.try_get(key, val);
+    }
+
+    void insert_or_assign(const KeyT& key, ValueT value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache.insert_or_assign(key, std::move(value));
+    }
+
+    size_t erase(const KeyT& key)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache.erase(key);
+    }
+
+    void clear_timeout()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cache.clear_timeout();
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _cache.size();
+    }
+
+private:
+    template <typename Loader>
+    ValueT load(const KeyT& key, Loader& loader, std::promise<ValueT>& promise)
+    {
+        try {
+            ValueT value = loader(key);
+            std::lock_guard<std::mutex> lock(_mutex);
+            _cache.insert_or_assign(key, ValueT(value));
+            _loading.erase(key);
+            promise.set_value(value);
+            return value;
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _loading.erase(key);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+    }
+
+    std::mutex _mutex;
+    lru_cache<KeyT, ValueT, HashT, EqT> _cache;
+    emhash8::HashMap<KeyT, flight, HashT, EqT> _loading;
+    uint32_t _stale;
+};
+} // namespace emlru_time
@@ -30,8 +30,16 @@
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#include <vector>
 #include <ctime>
 
+//EMH_COMPOSITE_HASH: see hash_composite.hpp
+#if EMH_COMPOSITE_HASH
+    #include "hash_composite.hpp"
+#elif !defined(EMH_DEFAULT_HASH)
+    #define EMH_DEFAULT_HASH std::hash
+#endif
+
 // likely/unlikely
 #if (__GNUC__ >= 4 || __clang__)
 #    define EMHASH_LIKELY(condition) __builtin_expect(condition, 1)
@@ -46,7 +54,7 @@
 #endif
 
 #define IS_TIMEOUT(p,b)  (p[b].timeout < nowts())
-#define SET_TIMEOUT(b,t) _pairs[b].timeout = nowts() + t
+#define SET_TIMEOUT(b,t) set_timeout(b, t)
 
 #undef NEW_KVALUE
 
@@ -54,7 +62,7 @@
 #define EMH_VAL(p,n)     p[n].second
 #define NEXT_BUCKET(p,n) p[n].bucket
 #define EMH_PKV(p,n)     p[n]
-#define NEW_KVALUE(key, value, bucket) new(_pairs + bucket) PairT(key, value, bucket, _time_out), _num_filled ++
+#define NEW_KVALUE(key, value, bucket) new(_pairs + bucket) PairT(key, value, bucket, _time_out), _num_filled ++, add_weight(bucket), wheel_index(bucket)
 
 namespace emlru_time {
 
@@ -62,7 +70,9 @@ constexpr uint32_t INACTIVE = 0xFFFFFFFF;
 
 inline static uint32_t nowts()
 {
-#if EMHASH_LRU_TIME > 0
+#ifdef EMHASH_LRU_CLOCK
+    return EMHASH_LRU_CLOCK();
+#elif EMHASH_LRU_TIME > 0
     return EMHASH_LRU_TIME;
 #else
     return time(0);
@@ -145,12 +155,21 @@ struct entry {
     uint32_t timeout;
 };// __attribute__ ((packed));
 
+template<typename T> using default_hash = EMH_DEFAULT_HASH<T>;
+
+/// Default weigher, every entry weighs 1 and the cache is only bounded by entry count.
+struct unit_weight
+{
+    template <typename K, typename V>
+    constexpr size_t operator()(const K&, const V&) const { return 1; }
+};
+
 /// A cache-friendly hash table with open addressing, linear/qua probing and power-of-two capacity
-template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>, typename EqT = std::equal_to<KeyT>>
+template <typename KeyT, typename ValueT, typename HashT = default_hash<KeyT>, typename EqT = std::equal_to<KeyT>, typename WeightT = unit_weight>
 class lru_cache
 {
 private:
-    typedef lru_cache<KeyT, ValueT, HashT, EqT> htype;
+    typedef lru_cache<KeyT, ValueT, HashT, EqT, WeightT> htype;
     typedef entry<KeyT, ValueT>             PairT;
     typedef entry<KeyT, ValueT>             value_pair;
 
@@ -292,6 +311,12 @@ public:
         _pairs = nullptr;
         _num_filled = 0;
         _max_buckets = max_bucket;
+        _wheel_mask = 0;
+        _wheel_ts = 0;
+        _wheel_pos = 0;
+        _wheel_keys = 0;
+        _sum_weight = 0;
+        _max_weight = 0;
         max_load_factor(0.8f);
     }
 
@@ -368,6 +393,14 @@ public:
         _loadlf      = other._loadlf;
         _max_buckets = other._max_buckets;
         _time_out    = other._time_out;
+        _wheel       = other._wheel;
+        _wheel_mask  = other._wheel_mask;
+        _wheel_ts    = other._wheel_ts;
+        _wheel_pos   = other._wheel_pos;
+        _wheel_keys  = other._wheel_keys;
+        _weigher     = other._weigher;
+        _sum_weight  = other._sum_weight;
+        _max_weight  = other._max_weight;
         auto opairs  = other._pairs;
 
         if (std::is_pod<KeyT>::value && std::is_pod<ValueT>::value) {
@@ -393,6 +426,14 @@ public:
         std::swap(_loadlf, other._loadlf);
         std::swap(_time_out, other._time_out);
         std::swap(_max_buckets, other._max_buckets);
+        std::swap(_wheel, other._wheel);
+        std::swap(_wheel_mask, other._wheel_mask);
+        std::swap(_wheel_ts, other._wheel_ts);
+        std::swap(_wheel_pos, other._wheel_pos);
+        std::swap(_wheel_keys, other._wheel_keys);
+        std::swap(_weigher, other._weigher);
+        std::swap(_sum_weight, other._sum_weight);
+        std::swap(_max_weight, other._max_weight);
     }
 
     bool check_timeout(uint32_t bucket)
@@ -401,6 +442,7 @@ public:
         if (IS_TIMEOUT(_pairs, bucket) || hash_bucket(EMH_KEY(_pairs, bucket)) == bucket)
         {
             //_pairs[bucket].~PairT();
+            sub_weight(bucket);
             clear_bucket(bucket);
             return true;
         }
@@ -685,6 +727,13 @@ public:
         return bucket == _num_buckets ? nullptr : &EMH_VAL(_pairs, bucket);
     }
 
+    /// Returns the entry even if it is timeout (e.g. to serve a stale value), or nullptr if k isn't found.
+    value_pair* try_get_entry(const KeyT& key) noexcept
+    {
+        const auto bucket = find_indexed_bucket(key);
+        return bucket == _num_buckets ? nullptr : &EMH_PKV(_pairs, bucket);
+    }
+
     /// Convenience function.
     ValueT get_or_return_default(const KeyT& key) const noexcept
     {
@@ -699,6 +748,7 @@ public:
     /// and a bool denoting whether the insertion took place.
     std::pair<iterator, bool> insert(const KeyT& key, const ValueT& value)
     {
+        check_weight_need(key, value);
         check_expand_need();
         const auto bucket = find_or_allocate(key);
         auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
@@ -706,8 +756,10 @@ public:
             NEW_KVALUE(key, value, bucket);
         } else {
             if (IS_TIMEOUT(_pairs, bucket)) {
+                sub_weight(bucket);
                 EMH_KEY(_pairs, bucket) = key;
                 EMH_VAL(_pairs, bucket) = value;
+                add_weight(bucket);
                 found = true;
             }
             SET_TIMEOUT(bucket, _time_out);
@@ -717,15 +769,20 @@ public:
 
     std::pair<iterator, bool> insert(const KeyT& key, const ValueT& value, int timeout) noexcept
     {
+        check_weight_need(key, value);
         check_expand_need();
         const auto bucket = find_or_allocate(key);
         auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
         if (found) {
-            NEW_KVALUE(key, value, bucket);
+            new(_pairs + bucket) PairT(key, value, bucket, timeout); _num_filled ++;
+            add_weight(bucket);
+            wheel_index(bucket);
         } else {
             if (IS_TIMEOUT(_pairs, bucket)) {
+                sub_weight(bucket);
                 EMH_KEY(_pairs, bucket) = key;
                 EMH_VAL(_pairs, bucket) = value;
+                add_weight(bucket);
                 found = true;
             }
             SET_TIMEOUT(bucket, timeout);
@@ -736,6 +793,7 @@ public:
 //    std::pair<iterator, bool> insert(const value_pair& value) { return insert(value.first, value.second); }
     std::pair<iterator, bool> insert(KeyT&& key, ValueT&& value) noexcept
     {
+        check_weight_need(key, value);
         check_expand_need();
         const auto bucket = find_or_allocate(key);
         auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
@@ -743,8 +801,10 @@ public:
             NEW_KVALUE(std::move(key), std::move(value), bucket);
         } else {
             if (IS_TIMEOUT(_pairs, bucket)) {
+                sub_weight(bucket);
                 EMH_KEY(_pairs, bucket) = std::move(key);
                 EMH_VAL(_pairs, bucket) = std::move(value);
+                add_weight(bucket);
                 found = true;
             }
             SET_TIMEOUT(bucket, _time_out);
@@ -820,6 +880,7 @@ public:
     /// Same as above, but contains(key) MUST be false
     uint32_t insert_unique(const KeyT& key, const ValueT& value)
     {
+        check_weight_need(key, value);
         check_expand_need();
         auto bucket = find_unique_bucket(key);
         NEW_KVALUE(key, value, bucket);
@@ -828,6 +889,7 @@ public:
 
     uint32_t insert_unique(KeyT&& key, ValueT&& value)
     {
+        check_weight_need(key, value);
         check_expand_need();
         auto bucket = find_unique_bucket(key);
         NEW_KVALUE(std::move(key), std::move(value), bucket);
@@ -878,17 +940,51 @@ public:
 
     std::pair<iterator, bool> insert_or_assign(const KeyT& key, ValueT&& value)
     {
-        return insert(key, std::move(value));
+        check_weight_need(key, value);
+        check_expand_need();
+        const auto bucket = find_or_allocate(key);
+        auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
+        if (found) {
+            NEW_KVALUE(key, std::move(value), bucket);
+        } else {
+            sub_weight(bucket);
+            if (IS_TIMEOUT(_pairs, bucket)) {
+                EMH_KEY(_pairs, bucket) = key;
+                found = true;
+            }
+            EMH_VAL(_pairs, bucket) = std::move(value);
+            add_weight(bucket);
+            SET_TIMEOUT(bucket, _time_out);
+        }
+        return { {this, bucket}, found };
     }
 
     std::pair<iterator, bool> insert_or_assign(KeyT&& key, ValueT&& value)
     {
-        return insert(std::move(key), std::move(value));
+        check_weight_need(key, value);
+        check_expand_need();
+        const auto bucket = find_or_allocate(key);
+        auto found = NEXT_BUCKET(_pairs, bucket) == INACTIVE;
+        if (found) {
+            NEW_KVALUE(std::move(key), std::move(value), bucket);
+        } else {
+            sub_weight(bucket);
+            if (IS_TIMEOUT(_pairs, bucket)) {
+                EMH_KEY(_pairs, bucket) = std::move(key);
+                found = true;
+            }
+            EMH_VAL(_pairs, bucket) = std::move(value);
+            add_weight(bucket);
+            SET_TIMEOUT(bucket, _time_out);
+        }
+        return { {this, bucket}, found };
     }
 
     /// Like std::map<KeyT,ValueT>::operator[].
     ValueT& operator[](const KeyT& key)
     {
+        if (is_weighted())
+            check_weight_need(key, ValueT());
         EMHASH_UNLIKELY(check_expand_need());
         auto bucket = find_or_allocate(key);
         /* Check if inserting a new value rather than overwriting an old entry */
@@ -897,8 +993,10 @@ public:
         } else {
             //TODO:replace the key
             if (IS_TIMEOUT(_pairs, bucket)) {
+                sub_weight(bucket);
                 EMH_KEY(_pairs, bucket) = key;
                 EMH_VAL(_pairs, bucket) = ValueT();
+                add_weight(bucket);
             }
 
             SET_TIMEOUT(bucket, _time_out);
@@ -908,6 +1006,8 @@ public:
 
     ValueT& operator[](KeyT&& key)
     {
+        if (is_weighted())
+            check_weight_need(key, ValueT());
         EMHASH_UNLIKELY(check_expand_need());
         auto bucket = find_or_allocate(key);
         /* Check if inserting a new value rather than overwriting an old entry */
@@ -915,8 +1015,10 @@ public:
             NEW_KVALUE(std::move(key), std::move(ValueT()), bucket);
         } else {
             if (IS_TIMEOUT(_pairs, bucket)) {
+                sub_weight(bucket);
                 EMH_KEY(_pairs, bucket) = std::move(key);
                 EMH_VAL(_pairs, bucket) = std::move(ValueT());
+                add_weight(bucket);
             }
 
             SET_TIMEOUT(bucket, _time_out);
@@ -933,6 +1035,7 @@ public:
         if (bucket == INACTIVE)
             return 0;
 
+        sub_weight(bucket);
         clear_bucket(bucket);
         return 1;
     }
@@ -943,6 +1046,7 @@ public:
         iterator it(this, cit._bucket);
 
         const auto bucket = erase_bucket(it._bucket);
+        sub_weight(bucket);
         clear_bucket(bucket);
         //erase from main bucket, return main bucket as next
         return (bucket == it._bucket) ? ++it : it;
@@ -951,6 +1055,7 @@ public:
     void _erase(const_iterator it)
     {
         const auto bucket = erase_bucket(it._bucket);
+        sub_weight(bucket);
         clear_bucket(bucket);
     }
 
@@ -973,15 +1078,114 @@ public:
 
     void clear_timeout()
     {
+        if (!_wheel.empty()) {
+            expire_some();
+            return;
+        }
+
         auto now_ts = nowts();
         for (uint32_t bucket = 0; bucket < _num_buckets; ++bucket) {
-            if (NEXT_BUCKET(_pairs, bucket) != INACTIVE && _pairs[bucket].timeout < now_ts) {
-                erase_bucket(bucket);
-                clear_bucket(bucket);
+            //erasing a main bucket moves its next entry in, so check it again
+            while (NEXT_BUCKET(_pairs, bucket) != INACTIVE && _pairs[bucket].timeout < now_ts)
+                erase_clear(bucket);
+        }
+    }
+
+    /// Index every entry by its timeout second in a wheel of `slots` expiry lists, so that
+    /// expire_some()/clear_timeout() only visit the keys queued in elapsed seconds instead of
+    /// scanning all buckets. Keys timing out more than `slots` seconds ahead are re-queued once
+    /// per round. Entries that have already expired are erased first. slots = 0 drops the wheel.
+    void set_expire_wheel(uint32_t slots = 4096)
+    {
+        _wheel.clear();
+        _wheel.shrink_to_fit();
+        _wheel_mask = _wheel_pos = _wheel_keys = 0;
+        if (slots == 0)
+            return;
+
+        //the cursor starts at now, slots of the elapsed seconds would not come due for a round
+        clear_timeout();
+
+        uint32_t num_slots = 2;
+        while (num_slots < slots) { num_slots *= 2; }
+        _wheel.resize(num_slots);
+        _wheel_mask = num_slots - 1;
+        _wheel_ts   = nowts();
+
+        for (uint32_t bucket = 0, filled = 0; filled < _num_filled; ++bucket) {
+            if (NEXT_BUCKET(_pairs, bucket) != INACTIVE) {
+                wheel_index(bucket);
+                filled ++;
             }
         }
     }
 
+    /// Number of keys queued in the wheel, keys of erased entries included until they are visited.
+    size_type wheel_keys() const { return _wheel_keys; }
+
+    /// Erase entries whose timeout second has elapsed, examining at most `budget` queued keys
+    /// to bound the pause of a single call. Returns the number of erased entries.
+    /// A refreshed key moves to the slot of its new timeout once its old slot comes due, so every
+    /// entry stays queued once. Without a wheel it falls back to the full clear_timeout() scan.
+    size_type expire_some(size_type budget = ~size_type(0))
+    {
+        const auto old_filled = _num_filled;
+        if (_wheel.empty()) {
+            clear_timeout();
+            return old_filled - _num_filled;
+        }
+
+        //keys of erased entries stay queued until their slot comes due, and a key inserted again,
+        //refreshed after it expired or given an earlier timeout is queued twice. Rebuild the wheel
+        //once they outnumber the entries
+        if (_wheel_keys > 2 * (uint64_t)_num_filled + _wheel_mask + 1) {
+            set_expire_wheel(_wheel_mask + 1);
+            return old_filled - _num_filled;
+        }
+
+        const auto now_ts = nowts();
+        //a whole round visits every slot, older seconds share slots with newer ones
+        if (now_ts > _wheel_ts + _wheel_mask + 1) {
+            _wheel_ts  = now_ts - _wheel_mask - 1;
+            _wheel_pos = 0;
+        }
+
+        while (_wheel_ts < now_ts && budget > 0) {
+            const auto slot = _wheel_ts & _wheel_mask;
+            auto& keys = _wheel[slot];
+            while (_wheel_pos < keys.size() && budget > 0) {
+                budget --;
+                const auto bucket = find_indexed_bucket(keys[_wheel_pos]);
+                if (bucket != _num_buckets) {
+                    const auto timeout = _pairs[bucket].timeout;
+                    if (timeout < now_ts) {
+                        erase_clear(bucket);
+                    } else if ((timeout & _wheel_mask) == slot) {
+                        _wheel_pos ++; //expires in a later round
+                        continue;
+                    } else {
+                        //refreshed, follow its timeout
+                        _wheel[timeout & _wheel_mask].emplace_back(std::move(keys[_wheel_pos]));
+                        _wheel_keys ++;
+                    }
+                }
+
+                //erased, expired or moved to another slot
+                keys[_wheel_pos] = std::move(keys.back());
+                keys.pop_back();
+                _wheel_keys --;
+            }
+
+            if (_wheel_pos < keys.size())
+                break;
+
+            _wheel_pos = 0;
+            _wheel_ts ++;
+        }
+
+        return old_filled - _num_filled;
+    }
+
     /// Remove all elements, keeping full capacity.
     void clear()
     {
@@ -990,7 +1194,34 @@ public:
         else
             memset(_pairs, INACTIVE, sizeof(_pairs[0]) * _num_buckets);
 
+        for (auto& keys : _wheel)
+            keys.clear();
+        _wheel_pos  = 0;
+        _wheel_keys = 0;
         _num_filled = 0;
+        _sum_weight = 0;
+    }
+
+    /// Total weight of all entries as summed by the weigher.
+    uint64_t total_weight() const
+    {
+        return is_weighted() ? _sum_weight : _num_filled;
+    }
+
+    uint64_t max_weight() const
+    {
+        return _max_weight;
+    }
+
+    /// Bound the cache by the total weight of its entries (e.g. bytes) besides max_bucket,
+    /// expired and then soonest-to-expire entries are evicted before an insert would exceed it.
+    /// 0 means no budget. Values changed in place through operator[] or try_get are not
+    /// reweighed, replace them with insert_or_assign to keep the total exact.
+    void max_weight(uint64_t value)
+    {
+        _max_weight = value;
+        if (is_weighted() && _max_weight && _sum_weight > _max_weight)
+            remove_weight(_max_weight - _max_weight / 4);
     }
 
     void shrink_to_fit()
@@ -1039,11 +1270,14 @@ public:
                 continue;
 
             old_num_filled -- ;
-            if (old_pairs[src_bucket].timeout > now_ts && _num_filled < _max_buckets) {
+            if (old_pairs[src_bucket].timeout >= now_ts && _num_filled < _max_buckets) {
                 auto& key = EMH_KEY(old_pairs, src_bucket);
                 const auto bucket = find_unique_bucket(key);
-                NEW_KVALUE(std::move(key), std::move(EMH_VAL(old_pairs, src_bucket)), bucket);
+                //keys stay queued in the wheel, only the bucket moves
+                new(_pairs + bucket) PairT(std::move(key), std::move(EMH_VAL(old_pairs, src_bucket)), bucket, 0); _num_filled ++;
                 _pairs[bucket].timeout = old_pairs[src_bucket].timeout;
+            } else if (is_weighted()) {
+                _sum_weight -= _weigher(EMH_KEY(old_pairs, src_bucket), EMH_VAL(old_pairs, src_bucket));
             }
             old_pairs[src_bucket].~PairT();
         }
@@ -1074,6 +1308,79 @@ private:
         return reserve(_num_filled);
     }
 
+    static constexpr bool is_weighted() noexcept
+    {
+        return !std::is_same<WeightT, unit_weight>::value;
+    }
+
+    // Evict before the new entry would push the total weight over budget
+    inline void check_weight_need(const KeyT& key, const ValueT& value)
+    {
+        if (is_weighted() && _max_weight && _sum_weight + _weigher(key, value) > _max_weight)
+            remove_weight(_max_weight - _max_weight / 4);
+    }
+
+    //drop expired entries, then the ones closest to expiry until the total weight fits max_weight
+    void remove_weight(uint64_t max_weight)
+    {
+        clear_timeout();
+        while (_num_filled > 0 && _sum_weight > max_weight) {
+            uint64_t sum_timeout = 0;
+            for (uint32_t bucket = 0; bucket < _num_buckets; ++bucket) {
+                if (NEXT_BUCKET(_pairs, bucket) != INACTIVE)
+                    sum_timeout += _pairs[bucket].timeout;
+            }
+
+            const auto medium_ts = uint32_t(sum_timeout / _num_filled);
+            for (uint32_t bucket = 0; bucket < _num_buckets && _sum_weight > max_weight; ++bucket) {
+                while (NEXT_BUCKET(_pairs, bucket) != INACTIVE && _pairs[bucket].timeout <= medium_ts && _sum_weight > max_weight)
+                    erase_clear(bucket);
+            }
+        }
+    }
+
+    inline void add_weight(uint32_t bucket)
+    {
+        if (is_weighted())
+            _sum_weight += _weigher(EMH_KEY(_pairs, bucket), EMH_VAL(_pairs, bucket));
+    }
+
+    inline void sub_weight(uint32_t bucket)
+    {
+        if (is_weighted())
+            _sum_weight -= _weigher(EMH_KEY(_pairs, bucket), EMH_VAL(_pairs, bucket));
+    }
+
+    //unlink and clear an entry, erasing a main bucket moves its next entry in
+    inline void erase_clear(uint32_t bucket)
+    {
+        const auto ebucket = erase_bucket(bucket);
+        sub_weight(ebucket);
+        clear_bucket(ebucket);
+    }
+
+    //a later timeout keeps the key queued in its old slot, expire_some() moves it when that slot
+    //comes due. An earlier one must be visited sooner, and an expired entry may be replaced by
+    //another key, both queue the key again
+    inline void set_timeout(uint32_t bucket, uint32_t timeout)
+    {
+        const auto now_ts = nowts();
+        const auto old_timeout = _pairs[bucket].timeout;
+        _pairs[bucket].timeout = now_ts + timeout;
+        if (old_timeout < now_ts || _pairs[bucket].timeout < old_timeout)
+            wheel_index(bucket);
+    }
+
+    //queue the key of an entry in the slot of its timeout
+    inline void wheel_index(uint32_t bucket)
+    {
+        if (EMHASH_LIKELY(_wheel.empty()))
+            return;
+
+        _wheel[_pairs[bucket].timeout & _wheel_mask].emplace_back(EMH_KEY(_pairs, bucket));
+        _wheel_keys ++;
+    }
+
     void clear_bucket(uint32_t bucket)
     {
         if (is_notrivially())
@@ -1096,7 +1403,7 @@ private:
             return eqkey ? bucket : INACTIVE;
          } else if (eqkey) {
             const auto nbucket = NEXT_BUCKET(_pairs, next_bucket);
-            if (is_notrivially())
+            if (is_notrivially() || is_weighted())
                 EMH_PKV(_pairs, bucket).swap(EMH_PKV(_pairs, next_bucket));
             else {
                 const auto timeout = _pairs[bucket].timeout;
@@ -1135,7 +1442,7 @@ private:
                 return bucket;
 
             const auto nbucket = NEXT_BUCKET(_pairs, next_bucket);
-            if (is_notrivially())
+            if (is_notrivially() || is_weighted())
                 EMH_PKV(_pairs, bucket).swap(EMH_PKV(_pairs, next_bucket));
             else {
                 const auto timeout = _pairs[bucket].timeout;
@@ -1177,6 +1484,31 @@ private:
         return _num_buckets;
     }
 
+    // Find the bucket with this key whether it is timeout or not, or return bucket size
+    uint32_t find_indexed_bucket(const KeyT& key) const
+    {
+        const auto bucket = hash_bucket(key);
+        auto next_bucket = NEXT_BUCKET(_pairs, bucket);
+        if (next_bucket == INACTIVE)
+            return _num_buckets;
+        else if (_eq(key, EMH_KEY(_pairs, bucket)))
+            return bucket;
+        else if (next_bucket == bucket)
+            return _num_buckets;
+
+        while (true) {
+            if (_eq(key, EMH_KEY(_pairs, next_bucket)))
+                return next_bucket;
+
+            const auto nbucket = NEXT_BUCKET(_pairs, next_bucket);
+            if (nbucket == next_bucket)
+                break;
+            next_bucket = nbucket;
+        }
+
+        return _num_buckets;
+    }
+
     uint32_t kickout_bucket(const uint32_t main_bucket, const uint32_t bucket)
     {
         const auto next_bucket = NEXT_BUCKET(_pairs, bucket);
@@ -1395,6 +1727,16 @@ private:
 
     uint32_t  _num_filled;
     uint32_t  _time_out;
+
+    std::vector<std::vector<KeyT>> _wheel;
+    uint32_t  _wheel_mask;
+    uint32_t  _wheel_ts;
+    uint32_t  _wheel_pos;
+    uint32_t  _wheel_keys;  //queued keys, stale ones included
+
+    WeightT   _weigher;
+    uint64_t  _sum_weight;
+    uint64_t  _max_weight;
 };
 } // namespace emhash
 #if __cplusplus > 199711
@@ -0,0 +1,92 @@
+//emhash8 HashMap and HashSet reused after clear() of a large table holding few keys,
+//the sparse clear walks only the chains of those keys and must leave no stale index entry
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../hash_set8.hpp"
+#include "../hash_table8.hpp"
+#include "test_util.h"
+
+//few distinct hashes, so the keys of one round share long chains
+struct chain_hash { size_t operator()(uint64_t key) const { return (size_t)(key % 61); } };
+
+//sparse rounds stay below 1/EMH_SPARSE_CLEAR load to take the chain walk, dense ones the memset
+static size_t round_size(std::mt19937_64& rng, size_t buckets)
+{
+    return (rng() % 4) ? rng() % (buckets / 64) : rng() % (buckets / 8);
+}
+
+template<class Map>
+static void test_map(const char* name, int rounds)
+{
+    std::mt19937_64 rng(rounds);
+    Map map;
+    map.reserve(1u << 16);
+    const auto buckets = map.bucket_count();
+    std::unordered_map<uint64_t, int> ref;
+    for (int r = 0; r < rounds; r++) {
+        const size_t n = round_size(rng, buckets);
+        for (size_t i = 0; i < n; i++) {
+            const auto key = rng() % (n * 4 + 1);
+            map.emplace(key, (int)i);
+            ref.emplace(key, (int)i);
+        }
+        check_equal(map, ref);
+
+        map.clear();
+        assert(map.size() == 0 && map.bucket_count() == buckets);
+        assert(map.begin() == map.end());
+        for (const auto& kv : ref)
+            assert(!map.contains(kv.first) && map.find(kv.first) == map.end());
+        ref.clear();
+    }
+    printf("%s clear ok\n", name);
+}
+
+template<class Set>
+static void test_set(const char* name, int rounds)
+{
+    std::mt19937_64 rng(rounds);
+    Set set;
+    set.reserve(1u << 16, false);
+    const auto buckets = set.bucket_count();
+    std::unordered_set<uint64_t> ref;
+    for (int r = 0; r < rounds; r++) {
+        const size_t n = round_size(rng, buckets);
+        for (size_t i = 0; i < n; i++) {
+            const auto key = rng() % (n * 4 + 1);
+            assert(set.insert(key).second == ref.insert(key).second);
+        }
+        assert(set.size() == ref.size());
+        for (const auto key : ref)
+            assert(set.contains(key));
+        size_t found = 0;
+        for (const auto key : set)
+            found += ref.count(key);
+        assert(found == ref.size());
+
+        set.clear();
+        assert(set.size() == 0 && set.bucket_count() == buckets);
+        assert(set.begin() == set.end());
+        for (const auto key : ref)
+            assert(!set.contains(key) && set.find(key) == set.end());
+        ref.clear();
+    }
+    printf("%s clear ok\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 50;
+    test_map<emhash8::HashMap<uint64_t, int>>("emhash8 map", rounds);
+    test_map<emhash8::HashMap<uint64_t, int, chain_hash>>("emhash8 map chains", rounds);
+    test_set<emhash8::HashSet<uint64_t>>("emhash8 set", rounds);
+    test_set<emhash8::HashSet<uint64_t, chain_hash>>("emhash8 set chains", rounds);
+    return 0;
+}
@@ -0,0 +1,149 @@
+//emhash9 DenseMap and DenseSet checked against std::unordered_map and std::unordered_set
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../hash_table9.hpp"
+#include "test_util.h"
+
+template<class Map, class Ref>
+static void check_dense(const Map& map, const Ref& ref)
+{
+    check_equal(map, ref);
+    for (const auto& kv : ref)
+        assert(*map.try_get(kv.first) == kv.second);
+}
+
+template<class Set, class Ref>
+static void check_equal_set(const Set& set, const Ref& ref)
+{
+    assert(set.size() == ref.size());
+    size_t n = 0;
+    for (const auto& key : set) {
+        assert(ref.count(key) == 1);
+        n++;
+    }
+    assert(n == ref.size());
+    for (const auto& key : ref)
+        assert(set.contains(key) && *set.find(key) == key);
+}
+
+//keys from a small range collide in runs, keys from the full range spread, the marker is never inserted
+template<class KeyT, class ValueT, class MakeVal>
+static void test_map(const char* name, int rounds, MakeVal make_val)
+{
+    std::mt19937_64 rng(rounds);
+    for (int r = 0; r < rounds; r++) {
+        emhash9::DenseMap<KeyT, ValueT> map;
+        std::unordered_map<KeyT, ValueT> ref;
+        if (r % 3 == 0)
+            map.set_empty_key((KeyT)0);
+        const auto empty = map.empty_key();
+        const uint64_t range = (rng() % 2) ? 64 + rng() % 8192 : ~0ull;
+        const size_t ops = 10 + rng() % 20000;
+
+        for (size_t i = 0; i < ops; i++) {
+            const auto key = (KeyT)(rng() % range);
+            if (key == empty)
+                continue;
+            switch (rng() % 8) {
+            case 0: case 1: case 2:
+                assert(map.emplace(key, make_val(i)).second == ref.emplace(key, make_val(i)).second);
+                break;
+            case 3:
+                map.insert_or_assign(key, make_val(i));
+                ref[key] = make_val(i);
+                break;
+            case 4:
+                map[key] = make_val(i);
+                ref[key] = make_val(i);
+                break;
+            case 5: case 6:
+                assert(map.erase(key) == ref.erase(key));
+                break;
+            default: {
+                //a value written through the iterator must land in the map
+                auto it = map.find(key);
+                assert((it != map.end()) == (ref.count(key) == 1));
+                if (it != map.end()) {
+                    it->second = make_val(i + 1);
+                    ref[key] = make_val(i + 1);
+                }
+                break;
+            }
+            }
+        }
+        check_dense(map, ref);
+
+        //erase while iterating, a shifted back element is visited next
+        const auto copy = map;
+        for (auto it = map.begin(); it != map.end(); ) {
+            if (rng() % 2) {
+                ref.erase(it->first);
+                it = map.erase(it);
+            } else
+                ++it;
+        }
+        check_dense(map, ref);
+        assert(copy.size() >= map.size());
+
+        auto moved = std::move(map);
+        check_dense(moved, ref);
+        moved.clear();
+        assert(moved.size() == 0 && moved.begin() == moved.end());
+    }
+    printf("%s ok\n", name);
+}
+
+template<class KeyT>
+static void test_set(const char* name, int rounds)
+{
+    std::mt19937_64 rng(rounds + 1);
+    for (int r = 0; r < rounds; r++) {
+        emhash9::DenseSet<KeyT> set;
+        std::unordered_set<KeyT> ref;
+        if (r % 3 == 0)
+            set.set_empty_key((KeyT)0);
+        const auto empty = set.empty_key();
+        const uint64_t range = (rng() % 2) ? 64 + rng() % 8192 : ~0ull;
+        const size_t ops = 10 + rng() % 20000;
+
+        for (size_t i = 0; i < ops; i++) {
+            const auto key = (KeyT)(rng() % range);
+            if (key == empty)
+                continue;
+            if (rng() % 3)
+                assert(set.insert(key).second == ref.insert(key).second);
+            else
+                assert(set.erase(key) == ref.erase(key));
+        }
+        check_equal_set(set, ref);
+
+        for (auto it = set.begin(); it != set.end(); ) {
+            if (rng() % 2) {
+                ref.erase(*it);
+                it = set.erase(it);
+            } else
+                ++it;
+        }
+        check_equal_set(set, ref);
+    }
+    printf("%s ok\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 100;
+    test_map<uint64_t, uint32_t>("DenseMap<uint64_t, uint32_t>", rounds, [](size_t i) { return (uint32_t)i; });
+    test_map<int32_t, std::string>("DenseMap<int32_t, string>", rounds, [](size_t i) { return std::to_string(i); });
+    test_map<int16_t, int>("DenseMap<int16_t, int>", rounds, [](size_t i) { return (int)i; });
+    test_set<uint32_t>("DenseSet<uint32_t>", rounds);
+    test_set<int64_t>("DenseSet<int64_t>", rounds);
+    return 0;
+}
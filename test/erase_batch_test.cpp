@@ -0,0 +1,60 @@
+//emhash8 erase_batch checked against erase of the same keys one by one in std::unordered_map
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <random>
+#include <unordered_map>
+
+#include "../hash_table8.hpp"
+#include "test_util.h"
+
+//the batch mixes hits, misses and repeated keys, small batches take the one by one path for integers
+template<class KeyT, class MakeKey>
+static void test_erase_batch(const char* name, int rounds, MakeKey make_key)
+{
+    std::mt19937_64 rng(rounds);
+    for (int r = 0; r < rounds; r++) {
+        emhash8::HashMap<KeyT, int> map;
+        std::unordered_map<KeyT, int> ref;
+        const size_t n = 1 + rng() % 5000;
+        for (size_t i = 0; i < n; i++) {
+            const auto key = make_key(rng() % (n * 2));
+            map.emplace(key, (int)i);
+            ref.emplace(key, (int)i);
+        }
+
+        for (int batch = 0; batch < 4; batch++) {
+            const size_t m = (rng() % 2) ? rng() % 16 : rng() % (n * 2);
+            std::vector<KeyT> keys;
+            for (size_t i = 0; i < m; i++)
+                keys.push_back(make_key(rng() % (n * 2)));
+
+            size_t erased = 0;
+            for (const auto& key : keys)
+                erased += ref.erase(key);
+            assert(map.erase_batch(keys) == erased);
+            check_equal(map, ref);
+
+            //the pairs left must still be usable after the compaction
+            for (size_t i = 0; i < m / 2; i++) {
+                const auto key = make_key(rng() % (n * 2));
+                map.emplace(key, -(int)i);
+                ref.emplace(key, -(int)i);
+            }
+            check_equal(map, ref);
+        }
+    }
+    printf("%s erase_batch ok\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 100;
+    test_erase_batch<uint64_t>("int", rounds, [](uint64_t k) { return k; });
+    test_erase_batch<std::string>("string", rounds, [](uint64_t k) { return std::to_string(k * 11400714819323198485ull); });
+    return 0;
+}
@@ -0,0 +1,144 @@
+//emhash8::GroupMap checked against std::unordered_map, with hashes that fill groups so that
+//misses follow the overflow bits and erases leave dirty groups that force a rehash
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "../hash_group8.hpp"
+#include "test_util.h"
+
+//mix_hash of few distinct values: the keys crowd into a few groups with the same fingerprint
+template<int Shift>
+struct crowd_hash
+{
+    size_t operator()(uint64_t key) const { return (size_t)(key >> Shift); }
+};
+
+template<class Map, class Ref>
+static void check_groups(const Map& map, const Ref& ref, uint64_t range)
+{
+    check_equal(map, ref);
+    //misses, most of them start in a group that overflowed
+    for (uint64_t k = range; k < range + 64; k++)
+        assert(!map.contains(k) && map.find(k) == map.end());
+}
+
+template<int Shift>
+static void test_random(int rounds)
+{
+    std::mt19937_64 rng(rounds + Shift);
+    for (int r = 0; r < rounds; r++) {
+        emhash8::GroupMap<uint64_t, int, crowd_hash<Shift>> map(2, 0.5f + (rng() % 5) / 10.0f);
+        std::unordered_map<uint64_t, int> ref;
+        const size_t ops = 1 + rng() % 20000;
+        const uint64_t range = 16 + rng() % 5000;
+
+        for (size_t i = 0; i < ops; i++) {
+            const uint64_t k = rng() % range;
+            switch (rng() % 5) {
+            case 0: case 1:
+                assert(map.emplace(k, (int)i).second == ref.emplace(k, (int)i).second);
+                break;
+            case 2:
+                map[k] = (int)i;
+                ref[k] = (int)i;
+                break;
+            case 3:
+                assert(map.erase(k) == ref.erase(k));
+                break;
+            default: {
+                auto it = map.find(k);
+                assert((it == map.end()) == (ref.count(k) == 0));
+                if (it != map.end()) {
+                    map.erase(it);
+                    ref.erase(k);
+                }
+                break;
+            }
+            }
+        }
+        check_groups(map, ref, range);
+        assert(map.load_factor() <= map.max_load_factor());
+
+        const auto copy = map;
+        check_groups(copy, ref, range);
+    }
+    printf("GroupMap random, %d key bits per hash ok\n", 1 << Shift);
+}
+
+//insert and erase at a constant size: every erase from an overflowed group is dirty, the
+//dirty count must trigger a rehash of the same size before the probes stop finding a free slot
+static void test_churn(int rounds)
+{
+    std::mt19937_64 rng(rounds + 1);
+    for (int r = 0; r < rounds; r++) {
+        emhash8::GroupMap<uint64_t, int, crowd_hash<6>> map;
+        std::unordered_map<uint64_t, int> ref;
+
+        const size_t live = 100 + rng() % 2000;
+        map.reserve(live);
+        const auto buckets = map.bucket_count();
+        uint64_t next = 0;
+        for (; next < live; next++) {
+            map.emplace(next, (int)next);
+            ref.emplace(next, (int)next);
+        }
+        //a rehash allocates the pairs before it frees the old ones, so they always move
+        auto pairs = map.values();
+        size_t rehashes = 0;
+        for (size_t i = 0; i < live * 20; i++, next++) {
+            const uint64_t k = next - live + rng() % (live / 2);
+            if (ref.erase(k)) {
+                assert(map.erase(k) == 1);
+                map.emplace(next, (int)next);
+                ref.emplace(next, (int)next);
+            }
+            if (map.values() != pairs) {
+                pairs = map.values();
+                rehashes++;
+            }
+        }
+        assert(rehashes > 0 && map.bucket_count() == buckets);
+        check_groups(map, ref, next);
+    }
+    printf("GroupMap churn ok\n");
+}
+
+static void test_reserve()
+{
+    emhash8::GroupMap<uint64_t, std::string> map;
+    assert(map.reserve(10000));
+    const auto pairs = map.values();
+    const auto buckets = map.bucket_count();
+    for (uint64_t k = 0; k < 10000; k++)
+        map.emplace(k, std::to_string(k));
+    assert(map.values() == pairs && map.bucket_count() == buckets);
+    assert(!map.reserve(100));
+
+    //a count past size_type used to be truncated to a small reserve
+    bool thrown = false;
+    try {
+        map.reserve((1ull << 32) + 100);
+    } catch (const std::length_error&) {
+        thrown = true;
+    }
+    assert(thrown && map.size() == 10000 && map.bucket_count() == buckets);
+    printf("GroupMap reserve ok\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 100;
+    test_random<0>(rounds);
+    test_random<3>(rounds);
+    test_random<6>(rounds);
+    test_churn(rounds / 4 + 1);
+    test_reserve();
+    return 0;
+}
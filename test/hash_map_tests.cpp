@@ -270,6 +270,25 @@ BOOST_AUTO_TEST_CASE(test_try_emplace_2) {
   }
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_try_emplace_piecewise, HMap,
+                              (boost::mpl::list<emhash5::HashMap<int, std::string>,
+                                                emhash8::HashMap<int, std::string>>)) {
+  // The value is built from zero or several arguments, and not at all on a hit
+  HMap map;
+  auto r = map.try_emplace(1);
+  BOOST_CHECK(r.second);
+  BOOST_CHECK_EQUAL(r.first->second, "");
+
+  r = map.try_emplace(2, 3, 'x');
+  BOOST_CHECK(r.second);
+  BOOST_CHECK_EQUAL(r.first->second, "xxx");
+
+  r = map.try_emplace(2, 5, 'y');
+  BOOST_CHECK(!r.second);
+  BOOST_CHECK_EQUAL(r.first->second, "xxx");
+  BOOST_CHECK_EQUAL(map.size(), 2);
+}
+
 BOOST_AUTO_TEST_CASE(test_try_emplace_hint) {
   emhash5::HashMap<std::int64_t, move_only_test> map(0);
 
@@ -0,0 +1,329 @@
+//emlru_time, emlru_size and sync_cache checked on a virtual clock
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <stdexcept>
+#include <unordered_map>
+
+static std::atomic<uint32_t> test_now(1000);
+static uint32_t test_clock() { return test_now.load(std::memory_order_relaxed); }
+#define EMHASH_LRU_CLOCK test_clock
+
+#include "../lru_size.h"
+#include "../lru_time.h"
+#include "../lru_sync.h"
+
+//key -> {value, timeout} of every cached entry, read by iterating so that expired ones show too
+template<class Cache>
+static std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> cached(const Cache& cache)
+{
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> entries;
+    for (const auto& entry : cache)
+        entries[entry.first] = {entry.second, entry.timeout};
+    return entries;
+}
+
+//every live key of ref is cached with its value, and nothing else is
+template<class Cache>
+static void check_alive(Cache& cache, const std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>>& ref)
+{
+    const auto entries = cached(cache);
+    size_t alive = 0;
+    for (const auto& kv : ref) {
+        if (kv.second.second < test_now)
+            continue;
+        alive++;
+        auto it = entries.find(kv.first);
+        assert(it != entries.end() && it->second == kv.second);
+    }
+    assert(cache.size() == alive && entries.size() == alive);
+}
+
+//keys inserted and refreshed with timeouts of 0-40 seconds on a clock ticking one second a step,
+//the wheel of 16 slots makes the longer ones wait for a later round
+static void test_expire(bool wheel, uint32_t budget, unsigned seed)
+{
+    std::mt19937_64 rng(seed);
+    test_now = 1000;
+    emlru_time::lru_cache<uint64_t, uint32_t> cache(16, 1 << 20);
+    if (wheel)
+        cache.set_expire_wheel(16);
+
+    //key -> {value, timeout}, expired keys are dropped once the cache expired them
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> ref;
+    for (int step = 0; step < 300; step++) {
+        test_now++;
+        for (int i = 0; i < 200; i++) {
+            const uint64_t key = rng() % 3000;
+            const uint32_t value = (uint32_t)rng();
+            const int timeout = (int)(rng() % 41);
+            auto it = ref.find(key);
+            cache.insert(key, value, timeout);
+            //a live key keeps its value and only takes the new timeout
+            if (it != ref.end() && it->second.second >= test_now)
+                it->second.second = test_now + timeout;
+            else
+                ref[key] = {value, test_now + timeout};
+        }
+
+        //a bounded pass never drops a live key
+        if (budget) {
+            cache.expire_some(budget);
+            const auto entries = cached(cache);
+            for (const auto& kv : ref)
+                assert(kv.second.second < test_now || entries.count(kv.first));
+        }
+
+        const auto old_size = cache.size();
+        const auto erased = cache.expire_some();
+        assert(old_size - erased == cache.size());
+        for (auto it = ref.begin(); it != ref.end(); ) {
+            if (it->second.second < test_now) it = ref.erase(it);
+            else ++it;
+        }
+        check_alive(cache, ref);
+    }
+
+    //set_expire_wheel indexes the keys already cached
+    if (!wheel) {
+        cache.set_expire_wheel(64);
+        test_now += 20;
+        cache.clear_timeout();
+        for (auto it = ref.begin(); it != ref.end(); ) {
+            if (it->second.second < test_now) it = ref.erase(it);
+            else ++it;
+        }
+        check_alive(cache, ref);
+    }
+    printf("expire wheel = %d budget = %u ok\n", wheel, budget);
+}
+
+//a key refreshed every second stays queued once, keys erased and inserted again are bounded
+static void test_wheel_refresh()
+{
+    test_now = 1000;
+    emlru_time::lru_cache<std::string, int> cache(16, 1 << 20, 3600);
+    cache.set_expire_wheel(4096);
+    for (int i = 0; i < 1000; i++)
+        cache[std::to_string(i)] = i;
+
+    for (int step = 0; step < 600; step++) {
+        test_now++;
+        for (int i = 0; i < 1000; i++)
+            cache[std::to_string(i)] ++;
+        assert(cache.expire_some() == 0);
+        assert(cache.size() == 1000 && cache.wheel_keys() == 1000);
+    }
+
+    std::mt19937_64 rng(7);
+    for (int step = 0; step < 200; step++) {
+        test_now++;
+        for (int i = 0; i < 1000; i++) {
+            const auto key = std::to_string(rng() % 1000);
+            assert(cache.erase(key) == 1);
+            cache[key] = i;
+        }
+        cache.expire_some();
+        assert(cache.size() == 1000 && cache.wheel_keys() <= 2 * 1000 + 4096);
+    }
+    test_now += 3601;
+    assert(cache.expire_some() == 1000 && cache.size() == 0);
+    printf("expire wheel refresh ok\n");
+}
+
+//entries that expired before the wheel was set are reclaimed at once, not a round later
+static void test_wheel_late()
+{
+    test_now = 1000;
+    emlru_time::lru_cache<uint64_t, uint32_t> cache(16, 1 << 20);
+    for (uint64_t key = 0; key < 2000; key++)
+        cache.insert(key, (uint32_t)key, key < 1000 ? 10 : 1000);
+
+    test_now += 110;
+    cache.set_expire_wheel(4096);
+    assert(cache.size() == 1000 && cache.wheel_keys() == 1000);
+    for (uint64_t key = 0; key < 1000; key++)
+        assert(!cache.contains(key) && cache.contains(key + 1000));
+
+    test_now += 1000;
+    assert(cache.expire_some() == 1000 && cache.size() == 0);
+    printf("expire wheel late ok\n");
+}
+
+//bytes of a cached string
+struct string_weight
+{
+    size_t operator()(const uint64_t&, const std::string& value) const { return sizeof(uint64_t) + value.size(); }
+};
+
+//total_weight() is the sum of the weigher over the cached entries and stays within max_weight
+template<class Cache>
+static void check_weight(Cache& cache, uint64_t max_weight)
+{
+    uint64_t sum = 0;
+    size_t n = 0;
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        sum += string_weight()(it->first, it->second);
+        n++;
+    }
+    assert(n == cache.size());
+    assert(cache.total_weight() == sum);
+    assert(max_weight == 0 || sum <= max_weight);
+}
+
+//values of 0-4000 bytes under a budget of about 200 of them, inserts evict down to 3/4 of it
+template<class Cache>
+static void test_weight(const char* name, unsigned seed)
+{
+    std::mt19937_64 rng(seed);
+    Cache cache;
+    const uint64_t budget = 400000;
+    cache.max_weight(budget);
+    for (int i = 0; i < 100000; i++) {
+        const uint64_t key = rng() % 1000;
+        const auto op = rng() % 8;
+        if (op < 4)
+            cache.insert(key, std::string(rng() % 4000, 'v'));
+        else if (op < 7)
+            cache.insert_or_assign(key, std::string(rng() % 4000, 'a'));
+        else
+            cache.erase(key);
+        if (i % 101 == 0)
+            check_weight(cache, budget);
+    }
+    check_weight(cache, budget);
+
+    //a smaller budget evicts at once, 0 lifts it
+    cache.max_weight(budget / 10);
+    check_weight(cache, budget / 10);
+    cache.max_weight(0);
+    for (int i = 0; i < 1000; i++)
+        cache.insert_or_assign(i, std::string(100, 'b'));
+    check_weight(cache, 0);
+    cache.clear();
+    assert(cache.total_weight() == 0);
+    printf("%s weight ok\n", name);
+}
+
+//without a weigher every entry weighs 1
+template<class Cache>
+static void test_unit_weight(const char* name)
+{
+    Cache cache;
+    for (uint64_t i = 0; i < 1000; i++)
+        cache.insert(i, i);
+    for (uint64_t i = 0; i < 1000; i += 3)
+        cache.erase(i);
+    assert(cache.total_weight() == cache.size());
+    printf("%s unit weight ok\n", name);
+}
+
+//threads start together and call get_or_load on a few keys while the loader sleeps
+template<class Fn>
+static void run_threads(int threads, Fn fn)
+{
+    std::atomic<bool> go(false);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+        pool.emplace_back([&go, &fn, t]() { while (!go) std::this_thread::yield(); fn(t); });
+    go = true;
+    for (auto& th : pool)
+        th.join();
+}
+
+static void test_single_flight()
+{
+    test_now = 1000;
+    emlru_time::sync_cache<uint64_t, uint64_t> cache;
+    std::atomic<int> loads[8] = {};
+    const auto loader = [&loads](uint64_t key) {
+        loads[key]++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return key * 10;
+    };
+
+    //one load per key however many callers miss it at once
+    run_threads(16, [&](int t) {
+        for (int i = 0; i < 64; i++) {
+            const uint64_t key = (uint64_t)(t + i) % 8;
+            assert(cache.get_or_load(key, loader) == key * 10);
+        }
+    });
+    for (auto& n : loads)
+        assert(n == 1);
+    assert(cache.size() == 8);
+
+    //a throwing loader reaches every waiting caller and caches nothing, the next call loads again
+    std::atomic<int> throws(0), failed(0);
+    const auto bad_loader = [&throws](uint64_t) -> uint64_t {
+        throws++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        throw std::runtime_error("load failed");
+    };
+    run_threads(8, [&](int) {
+        try { cache.get_or_load(99, bad_loader); }
+        catch (const std::runtime_error&) { failed++; }
+    });
+    assert(failed == 8 && throws >= 1);
+    uint64_t val = 0;
+    assert(!cache.try_get(99, val));
+    assert(cache.get_or_load(99, [](uint64_t) { return (uint64_t)990; }) == 990);
+    printf("single flight ok, %d failed loads for 8 callers\n", throws.load());
+}
+
+//an expired entry within the stale window is served while one caller reloads it
+static void test_stale()
+{
+    test_now = 1000;
+    emlru_time::sync_cache<uint64_t, uint64_t> cache(4, 1 << 10, 1, 5);
+    std::atomic<int> loads(0);
+    std::atomic<uint64_t> version(1);
+    const auto loader = [&](uint64_t) {
+        loads++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return version.load();
+    };
+    assert(cache.get_or_load(7, loader) == 1);
+
+    test_now += 3;
+    version = 2;
+    std::atomic<int> stale(0);
+    run_threads(8, [&](int) {
+        const auto v = cache.get_or_load(7, loader);
+        assert(v == 1 || v == 2);
+        stale += v == 1;
+    });
+    assert(loads == 2);
+    assert(cache.get_or_load(7, loader) == 2);
+
+    //past the stale window callers wait for the reload
+    test_now += 10;
+    version = 3;
+    run_threads(8, [&](int) { assert(cache.get_or_load(7, loader) == 3); });
+    assert(loads == 3);
+    printf("stale ok, %d of 8 callers got the stale value\n", stale.load());
+}
+
+int main()
+{
+    test_expire(false, 0, 1);
+    test_expire(true, 0, 2);
+    test_expire(true, 50, 3);
+    test_wheel_refresh();
+    test_wheel_late();
+    test_weight<emlru_size::lru_cache<uint64_t, std::string, std::hash<uint64_t>, std::equal_to<uint64_t>, string_weight>>("lru_size", 4);
+    test_weight<emlru_time::lru_cache<uint64_t, std::string, std::hash<uint64_t>, std::equal_to<uint64_t>, string_weight>>("lru_time", 5);
+    test_unit_weight<emlru_size::lru_cache<uint64_t, uint64_t>>("lru_size");
+    test_unit_weight<emlru_time::lru_cache<uint64_t, uint64_t>>("lru_time");
+    test_single_flight();
+    test_stale();
+    return 0;
+}
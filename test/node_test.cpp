@@ -0,0 +1,154 @@
+//extract, insert(node_type&&), transfer_if and erase_if of emhash5-8 checked against std::unordered_map
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include <unordered_map>
+
+#include "../hash_table5.hpp"
+#include "../hash_table6.hpp"
+#include "../hash_table7.hpp"
+#include "../hash_table8.hpp"
+#include "test_util.h"
+
+//random keys, a third of them erased again so that chains have holes and moved entries
+template<class Map, class Ref>
+static void fill(Map& map, Ref& ref, std::mt19937_64& rng)
+{
+    const size_t n = 10 + rng() % 4991;
+    const uint64_t range = (rng() % 2) ? n * 4 : ~0ull;
+    for (size_t i = 0; i < n; i++) {
+        const uint64_t k = rng() % range;
+        map.emplace(k, (int)i);
+        ref.emplace(k, (int)i);
+    }
+    for (size_t i = 0; i < n / 3; i++) {
+        const uint64_t k = rng() % range;
+        assert(map.erase(k) == ref.erase(k));
+    }
+    check_equal(map, ref);
+}
+
+template<class Map>
+static void test_transfer_if(const char* name, int rounds)
+{
+    using Ref = std::unordered_map<uint64_t, int>;
+    std::mt19937_64 rng(rounds);
+    const auto pred = [](const auto& kv) { return (kv.second & 3) == 0; };
+    for (int r = 0; r < rounds; r++) {
+        Map src, dst; Ref rsrc, rdst;
+        fill(src, rsrc, rng);
+        //dst already has some keys of src, transfer_if leaves those in src
+        for (const auto& kv : rsrc) {
+            if (rng() % 8 == 0) { dst.emplace(kv.first, -1); rdst.emplace(kv.first, -1); }
+        }
+        size_t moved = 0;
+        for (auto it = rsrc.begin(); it != rsrc.end(); ) {
+            if (pred(*it) && rdst.emplace(it->first, it->second).second) {
+                it = rsrc.erase(it); moved++;
+            } else
+                ++it;
+        }
+        //pred is called once per entry, also for the ones that move
+        size_t calls = 0;
+        const auto src_size = src.size();
+        assert(src.transfer_if(dst, [&](const auto& kv) { calls++; return pred(kv); }) == moved);
+        assert(calls == src_size);
+        check_equal(src, rsrc);
+        check_equal(dst, rdst);
+    }
+    printf("%s transfer_if ok\n", name);
+}
+
+template<class Map>
+static void test_erase_if(const char* name, int rounds)
+{
+    using Ref = std::unordered_map<uint64_t, int>;
+    std::mt19937_64 rng(rounds + 1);
+    const auto pred = [](const auto& kv) { return (kv.second & 3) == 0; };
+    for (int r = 0; r < rounds; r++) {
+        Map map; Ref ref;
+        fill(map, ref, rng);
+        size_t erased = 0;
+        for (auto it = ref.begin(); it != ref.end(); ) {
+            if (pred(*it)) { it = ref.erase(it); erased++; }
+            else ++it;
+        }
+        assert(map.erase_if(pred) == erased);
+        check_equal(map, ref);
+    }
+    printf("%s erase_if ok\n", name);
+}
+
+template<class Map>
+static void test_node(const char* name, int rounds)
+{
+    std::unordered_map<std::string, std::string> ref;
+    std::mt19937_64 rng(rounds + 2);
+    Map map, other;
+    for (int r = 0; r < rounds * 20; r++) {
+        const auto key = std::to_string(rng() % 512);
+        switch (rng() % 4) {
+        case 0:
+            map.emplace(key, key + "v");
+            ref.emplace(key, key + "v");
+            break;
+        case 1: {
+            auto node = map.extract(key);
+            assert(!node == (ref.count(key) == 0));
+            if (node) {
+                const auto val = ref[key];
+                assert(node.key() == key && node.mapped() == val);
+                ref.erase(key);
+                //a key the map has again makes insert hand the node back
+                const bool again = rng() % 2;
+                if (again) { map.emplace(key, "x"); ref.emplace(key, "x"); }
+                auto res = map.insert(std::move(node));
+                assert(res.inserted == !again && res.position->first == key);
+                assert(res.node.empty() == !again);
+                if (!again) ref.emplace(key, val);
+            }
+            break;
+        }
+        case 2: {
+            auto it = map.find(key);
+            if (it != map.end()) {
+                auto node = map.extract(it);
+                assert(node && node.key() == key);
+                other.insert(std::move(node));
+                ref.erase(key);
+            }
+            break;
+        }
+        default:
+            assert(map.extract(std::string("none")).empty());
+            break;
+        }
+    }
+    check_equal(map, ref);
+    printf("%s node ok\n", name);
+}
+
+template<class Map>
+static void test_all(const char* name, int rounds)
+{
+    test_transfer_if<Map>(name, rounds);
+    test_erase_if<Map>(name, rounds);
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 300;
+    test_all<emhash5::HashMap<uint64_t, int>>("emhash5", rounds);
+    test_all<emhash6::HashMap<uint64_t, int>>("emhash6", rounds);
+    test_all<emhash7::HashMap<uint64_t, int>>("emhash7", rounds);
+    test_all<emhash8::HashMap<uint64_t, int>>("emhash8", rounds);
+    test_node<emhash5::HashMap<std::string, std::string>>("emhash5", rounds);
+    test_node<emhash6::HashMap<std::string, std::string>>("emhash6", rounds);
+    test_node<emhash7::HashMap<std::string, std::string>>("emhash7", rounds);
+    test_node<emhash8::HashMap<std::string, std::string>>("emhash8", rounds);
+    return 0;
+}
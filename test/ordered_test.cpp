@@ -0,0 +1,164 @@
+//emhash8::OrderedMap checked against a std::list of the pairs in insertion order
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <list>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+#include "../hash_ordered8.hpp"
+
+template<class K, class V, class MakeKey>
+static void test_order(const char* name, int ops, int range, unsigned seed, MakeKey mk)
+{
+    using List = std::list<std::pair<K, V>>;
+    emhash8::OrderedMap<K, V> map;
+    List order;
+    std::unordered_map<K, typename List::iterator> ref;
+    std::mt19937_64 rng(seed);
+
+    const auto check = [&]() {
+        assert(map.size() == ref.size());
+        auto it = map.begin();
+        for (const auto& kv : order) {
+            assert(it != map.end() && it->first == kv.first && it->second == kv.second);
+            ++it;
+        }
+        assert(it == map.end());
+        if (!map.empty())
+            assert(map.front().first == order.front().first && map.back().first == order.back().first);
+    };
+    const auto append = [&](const K& k, const V& v) {
+        order.emplace_back(k, v);
+        ref[k] = std::prev(order.end());
+    };
+    const auto remove = [&](const K& k) {
+        order.erase(ref[k]);
+        ref.erase(k);
+    };
+
+    for (int i = 0; i < ops; i++) {
+        const int op = rng() % 100;
+        const K k = mk(rng() % range);
+        if (op < 40) {
+            const V v = mk(rng());
+            const auto res = map.emplace(k, v);
+            assert(res.second == (ref.count(k) == 0) && res.first->first == k);
+            if (res.second)
+                append(k, v);
+        } else if (op < 50) {
+            const V v = mk(rng());
+            map.insert_or_assign(k, v);
+            if (ref.count(k))
+                ref[k]->second = v;
+            else
+                append(k, v);
+        } else if (op < 65) {
+            const auto n = map.erase(k);
+            assert(n == ref.count(k));
+            if (n)
+                remove(k);
+        } else if (op < 72) {
+            if (!map.empty()) {
+                const K front = map.front().first;
+                map.pop_front();
+                remove(front);
+            }
+        } else if (op < 75) {
+            if (!map.empty()) {
+                const K back = map.back().first;
+                map.pop_back();
+                remove(back);
+            }
+        } else if (op < 80) {
+            //erase(it) returns the next pair in insertion order
+            auto it = map.find(k);
+            assert((it != map.end()) == (ref.count(k) > 0));
+            if (it != map.end()) {
+                const auto next = std::next(ref[k]);
+                const auto mnext = map.erase(it);
+                remove(k);
+                if (next == order.end())
+                    assert(mnext == map.end());
+                else
+                    assert(mnext != map.end() && mnext->first == next->first);
+            }
+        } else if (op < 81) {
+            const size_t mod = 2 + rng() % 5;
+            const auto pred = [mod](const std::pair<K, V>& kv) { return std::hash<K>()(kv.first) % mod == 0; };
+            size_t erased = 0;
+            for (auto it = order.begin(); it != order.end(); ) {
+                if (pred(*it)) { ref.erase(it->first); it = order.erase(it); erased++; }
+                else ++it;
+            }
+            assert(map.erase_if(pred) == erased);
+        } else if (op < 82) {
+            if (rng() % 20 == 0) {
+                map.clear(); order.clear(); ref.clear();
+            } else if (rng() % 2) {
+                map.compact();
+                assert(map.tombstones() == 0);
+            } else
+                map.shrink_to_fit();
+        } else if (op < 83) {
+            auto copy = map; map = copy;
+            emhash8::OrderedMap<K, V> moved(std::move(copy));
+            map.swap(moved);
+        } else {
+            const auto* p = map.try_get(k);
+            assert((p != nullptr) == (ref.count(k) > 0));
+            assert(!p || *p == ref[k]->second);
+            assert(map.contains(k) == (ref.count(k) > 0));
+
+            //the const overloads find the same value without handing out a mutable one
+            const auto& cmap = map;
+            static_assert(std::is_same<decltype(cmap.try_get(k)), const V*>::value, "const try_get");
+            assert(cmap.try_get(k) == p);
+            bool thrown = false;
+            try { assert(&cmap.at(k) == p); } catch (const std::out_of_range&) { thrown = true; }
+            assert(thrown == (p == nullptr));
+        }
+        if (i % 97 == 0)
+            check();
+    }
+    check();
+    printf("%s order ok, size = %u tombstones = %u\n", name, (unsigned)map.size(), (unsigned)map.tombstones());
+}
+
+//a FIFO window: pop_front() the oldest after every insert once the window is full
+static void test_fifo()
+{
+    emhash8::OrderedMap<int, int> map;
+    for (int i = 0; i < 100000; i++) {
+        map.emplace(i, i);
+        if (map.size() > 1000) {
+            assert(map.front().first == i - 1000);
+            map.pop_front();
+        }
+        //the dead prefix is compacted away before it outgrows the live pairs
+        assert(map.tombstones() <= map.size() + 1);
+    }
+    int expect = 100000 - 1000;
+    for (const auto& kv : map)
+        assert(kv.first == expect++);
+    assert(expect == 100000);
+    printf("fifo ok\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const int ops = argc > 1 ? atoi(argv[1]) : 100000;
+    for (unsigned s = 1; s <= 3; s++) {
+        test_order<uint64_t, uint64_t>("int", ops, 50 + s * 500, s, [](uint64_t x) { return x; });
+        test_order<std::string, std::string>("string", ops / 3, 30 + s * 300, s,
+            [](uint64_t x) { return std::to_string(x) + "_long_string_to_avoid_sso"; });
+        test_order<uint32_t, uint32_t>("small", ops / 3, 8, s, [](uint64_t x) { return (uint32_t)x; });
+    }
+    test_fifo();
+    return 0;
+}
@@ -0,0 +1,174 @@
+//emhash7/8 sample() and sample_n(), and the approximate lru of lru_sample.h built on them
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <vector>
+#include <unordered_map>
+
+#include "../hash_table7.hpp"
+#include "../lru_sample.h"
+
+//forwards to mt19937_64 and counts the draws
+struct counting_rng
+{
+    typedef uint64_t result_type;
+    static constexpr uint64_t (min)() { return 0; }
+    static constexpr uint64_t (max)() { return UINT64_MAX; }
+
+    std::mt19937_64 rng;
+    int draws = 0;
+    uint64_t operator()() { draws++; return rng(); }
+};
+
+//always the same draw, pins the bucket of emhash7's rejection loop
+struct constant_rng
+{
+    typedef uint64_t result_type;
+    static constexpr uint64_t (min)() { return 0; }
+    static constexpr uint64_t (max)() { return UINT64_MAX; }
+
+    uint64_t value;
+    uint64_t operator()() { return value; }
+};
+
+template<class Map>
+static void test_empty(const char* name)
+{
+    std::mt19937_64 rng(1);
+    Map map;
+    assert(map.sample(rng) == map.end());
+    const auto& cmap = map;
+    assert(cmap.sample(rng) == cmap.end());
+    std::vector<typename Map::iterator> out;
+    map.sample_n(rng, 8, std::back_inserter(out));
+    assert(out.empty());
+
+    map.emplace(1, 1);
+    map.erase(1);
+    assert(map.sample(rng) == map.end());
+    printf("%s sample empty ok\n", name);
+}
+
+//every element is drawn about as often as the others
+template<class Map>
+static void test_uniform(const char* name, int rounds)
+{
+    std::mt19937_64 rng(rounds);
+    Map map;
+    for (int i = 0; i < 1000; i++)
+        map.emplace(rng(), i);
+    for (int i = 0; i < 200; i++)
+        map.erase(map.begin()->first);
+
+    std::unordered_map<int, int> hits;
+    const int draws = (int)map.size() * rounds;
+    for (int i = 0; i < draws; i++) {
+        const auto it = map.sample(rng);
+        assert(it != map.end() && map.find(it->first) == it);
+        hits[it->second]++;
+    }
+    assert(hits.size() == map.size());
+    for (const auto& kv : hits)
+        assert(kv.second > rounds / 3 && kv.second < rounds * 3);
+
+    std::vector<typename Map::iterator> out;
+    map.sample_n(rng, 16, std::back_inserter(out));
+    assert(out.size() == 16);
+    for (const auto it : out)
+        assert(it != map.end() && map.find(it->first) == it);
+    printf("%s sample uniform ok\n", name);
+}
+
+//a table of 2^16 buckets with one element misses all 32 draws and walks to the element
+static void test_fallback()
+{
+    emhash7::HashMap<uint64_t, int> map;
+    map.reserve(1u << 16);
+    map.emplace(42, 1);
+
+    counting_rng rng;
+    int fallbacks = 0;
+    for (int i = 0; i < 100; i++) {
+        rng.draws = 0;
+        assert(map.sample(rng)->first == 42);
+        assert(rng.draws <= 32);
+        fallbacks += rng.draws == 32;
+    }
+    assert(fallbacks > 90);
+
+    //draw 0 walks from bucket 0 to the first filled one, the largest draw from the
+    //last bucket around the end of the table
+    constant_rng low = {0}, high = {UINT64_MAX};
+    assert(map.sample(low) == map.begin() && map.sample(high) == map.begin());
+    map.emplace(7, 2);
+    assert(map.sample(low) == map.begin());
+    const auto it = map.sample(high);
+    assert(it != map.end() && (it->first == 42 || it->first == 7));
+    printf("emhash7 sample fallback ok\n");
+}
+
+typedef emlru_sample::lru_cache<int, int> cache_type;
+
+//starts the logical clock just before it wraps to 0
+struct wrap_cache : cache_type
+{
+    wrap_cache(size_t capacity, uint32_t samples) : cache_type(capacity, samples) { _clock = UINT32_MAX - 2; }
+};
+
+//with many samples of a small cache the oldest entry is all but sure to be drawn
+template<class Cache>
+static void test_evict_order(const char* name)
+{
+    Cache cache(4, 64);
+    for (int i = 1; i <= 4; i++)
+        assert(cache.insert(i, i).second);
+    int val = 0;
+    assert(cache.try_get(1, val) && val == 1);
+
+    cache.insert(5, 5);
+    assert(!cache.contains(2) && cache.contains(1) && cache.size() == 4);
+    assert(cache.try_get(3) != nullptr);
+    cache.insert(6, 6);
+    assert(!cache.contains(4) && cache.contains(3));
+    cache.insert_or_assign(1, 10);
+    cache.insert(7, 7);
+    assert(!cache.contains(5) && cache.try_get(1, val) && val == 10);
+    assert(cache.evictions() == 3);
+    printf("%s lru evict order ok\n", name);
+}
+
+static void test_capacity(int rounds)
+{
+    std::mt19937_64 rng(rounds);
+    cache_type cache(100, 5);
+    size_t inserted = 0;
+    for (int i = 0; i < rounds * 100; i++) {
+        const int key = (int)(rng() % 1000);
+        if (rng() % 2)
+            cache.try_get(key);
+        else
+            inserted += cache.insert(key, key).second;
+        assert(cache.size() <= cache.capacity());
+    }
+    assert(cache.size() == cache.capacity());
+    assert(cache.evictions() == inserted - cache.size());
+    printf("lru capacity ok\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 100;
+    test_empty<emhash7::HashMap<uint64_t, int>>("emhash7");
+    test_empty<emhash8::HashMap<uint64_t, int>>("emhash8");
+    test_uniform<emhash7::HashMap<uint64_t, int>>("emhash7", rounds);
+    test_uniform<emhash8::HashMap<uint64_t, int>>("emhash8", rounds);
+    test_fallback();
+    test_evict_order<cache_type>("clock");
+    test_evict_order<wrap_cache>("wrapped clock");
+    test_capacity(rounds);
+    return 0;
+}
@@ -0,0 +1,88 @@
+//emhash8 SegmentMap checked against std::unordered_map, small segments so that every insert path splits
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <random>
+#include <unordered_map>
+
+#include "../hash_segment8.hpp"
+#include "test_util.h"
+
+template<class Map, class Ref>
+static void check_segments(const Map& map, const Ref& ref)
+{
+    check_equal(map, ref);
+    for (const auto& kv : ref)
+        assert(map.at(kv.first) == kv.second);
+}
+
+//every key has the same hash, splitting can not separate them
+struct ConstHash
+{
+    size_t operator()(uint64_t) const { return 42; }
+};
+
+//only 4 distinct hashes, a split separates them at most twice
+struct FewHash
+{
+    size_t operator()(uint64_t key) const { return key % 4; }
+};
+
+template<class Hash>
+static void test_segment(const char* name, int rounds, size_t max_keys)
+{
+    std::mt19937_64 rng(rounds);
+    for (int r = 0; r < rounds; r++) {
+        emhash8::SegmentMap<uint64_t, int, Hash> map(1 + rng() % 64);
+        std::unordered_map<uint64_t, int> ref;
+        const uint64_t range = (rng() % 2) ? max_keys : ~0ull;
+        const size_t ops = 1 + rng() % max_keys;
+
+        for (size_t i = 0; i < ops; i++) {
+            const uint64_t key = rng() % range;
+            switch (rng() % 6) {
+            case 0: case 1:
+                assert(map.emplace(key, (int)i).second == ref.emplace(key, (int)i).second);
+                break;
+            case 2:
+                assert(map.try_emplace(key, (int)i).second == ref.try_emplace(key, (int)i).second);
+                break;
+            case 3:
+                map[key] = (int)i;
+                ref[key] = (int)i;
+                break;
+            case 4:
+                map.insert_or_assign(key, (int)i);
+                ref.insert_or_assign(key, (int)i);
+                break;
+            default:
+                assert(map.erase(key) == ref.erase(key));
+                break;
+            }
+        }
+        check_segments(map, ref);
+
+        //the directory stays near the segment count however the keys hash
+        assert(((size_t)1 << map.depth()) <= 128 * (ops / 8 + 1));
+    }
+    printf("%s ok\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 100;
+    test_segment<std::hash<uint64_t>>("std::hash", rounds, 20000);
+    test_segment<FewHash>("FewHash", rounds / 4 + 1, 3000);
+    test_segment<ConstHash>("ConstHash", rounds / 4 + 1, 1000);
+
+    //the case that doubled the directory up to depth 48
+    emhash8::SegmentMap<int, int, ConstHash> map(8);
+    for (int i = 0; i < 1000; i++)
+        map.emplace(i, i);
+    assert(map.size() == 1000 && map.depth() == 0 && map.segment_count() == 1);
+    printf("ConstHash depth ok\n");
+    return 0;
+}
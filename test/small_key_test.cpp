@@ -0,0 +1,102 @@
+//emhash::small_key around the inline/spill boundary N, checked against std::string
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <random>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../hash_small_key.hpp"
+#include "../hash_table8.hpp"
+
+//lengths 0 to 2N + 1, bytes from a small alphabet with zeros so that keys differ only in their tail
+static std::string make_str(std::mt19937_64& rng, size_t max_len)
+{
+    std::string str(rng() % (max_len + 1), '\0');
+    for (auto& c : str)
+        c = "ab\0"[rng() % 3];
+    return str;
+}
+
+template<size_t N>
+static void test_boundary()
+{
+    using Key = emhash::small_key<N>;
+    static_assert(Key::capacity == N, "capacity is N");
+
+    //N - 1, N and N + 1 bytes, and N bytes with a trailing zero against N - 1 bytes
+    for (size_t len : {N - 1, N, N + 1, 2 * N}) {
+        const std::string s(len, 'x');
+        Key key(s);
+        assert(key.size() == len && key.spilled() == (len > N) && key.view() == s);
+
+        std::string t = s;
+        t.back() = 'y';
+        assert(Key(t) != key && !(Key(t) == key));
+    }
+    const std::string zeros(N, '\0');
+    assert(Key(zeros) != Key(zeros.substr(0, N - 1)));
+    assert(Key(zeros) == Key(std::string_view(zeros.data(), N)));
+    assert(Key(std::string(N + 1, '\0')) != Key(zeros));
+    assert(Key() == Key("") && Key().empty());
+
+    std::mt19937_64 rng(N);
+    std::vector<std::string> strs;
+    for (int i = 0; i < 4000; i++)
+        strs.push_back(make_str(rng, 2 * N + 1));
+
+    for (size_t i = 0; i < strs.size(); i++) {
+        const auto& a = strs[i];
+        const auto& b = strs[rng() % strs.size()];
+        const Key ka(a), kb(b);
+
+        //equality, order and hash agree with std::string across the boundary
+        assert((ka == kb) == (a == b));
+        assert((ka < kb) == (a < b));
+        if (a == b)
+            assert(ka.hash() == kb.hash());
+
+        //copy and move between an inline and a spilled key
+        Key c(ka);
+        assert(c == ka && c.hash() == ka.hash());
+        c = kb;
+        assert(c == kb && c.view() == b);
+        Key d(std::move(c));
+        assert(d == kb && c.empty());
+        d = Key(a);
+        assert(d == ka && d.str() == a);
+        d.swap(c);
+        assert(c == ka && d.empty());
+    }
+
+    //as the key of a map, equal strings must land on one entry
+    emhash8::HashMap<Key, int> map;
+    std::unordered_map<std::string, int> ref;
+    for (size_t i = 0; i < strs.size(); i++) {
+        map[Key(strs[i])] += 1;
+        ref[strs[i]] += 1;
+    }
+    assert(map.size() == ref.size());
+    for (const auto& kv : ref) {
+        auto it = map.find(Key(kv.first));
+        assert(it != map.end() && it->second == kv.second);
+    }
+
+    std::unordered_set<uint64_t> hashes;
+    for (const auto& kv : ref)
+        hashes.insert(Key(kv.first).hash());
+    assert(hashes.size() == ref.size());
+    printf("small_key<%zu> ok\n", N);
+}
+
+int main()
+{
+    test_boundary<8>();
+    test_boundary<16>();
+    test_boundary<24>();
+    return 0;
+}
@@ -0,0 +1,119 @@
+//emhash8 StringMap checked against std::unordered_map, string_view lookups and arena compaction
+#undef NDEBUG
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <random>
+#include <unordered_map>
+
+#include "../hash_string8.hpp"
+#include "test_util.h"
+
+//every lookup goes through a view of a scratch buffer, never through the stored key
+template<class Map, class Ref>
+static void check_views(const Map& map, const Ref& ref)
+{
+    check_equal(map, ref);
+    std::string scratch;
+    for (const auto& kv : ref) {
+        scratch = kv.first;
+        const std::string_view view(scratch);
+        auto it = map.find(view);
+        assert(it != map.end() && it->first == view && it->second == kv.second);
+        assert(it->first.empty() || it->first.data() != scratch.data());
+        assert(map.contains(view) && map.count(view) == 1 && map.at(view) == kv.second);
+        const int* val = map.try_get(view);
+        assert(val && *val == kv.second);
+    }
+}
+
+template<class Map>
+static size_t live_bytes(const Map& map)
+{
+    size_t bytes = 0;
+    for (const auto& kv : map)
+        bytes += kv.first.size();
+    return bytes;
+}
+
+//keys of 0-64 bytes, some longer than MIN_BLOCK so that they get a block of their own
+static std::string make_key(std::mt19937_64& rng, uint64_t range)
+{
+    const auto k = rng() % range;
+    const size_t len = k % 97 == 0 ? 5000 + k % 3000 : k % 65;
+    std::string key(len, 'a' + k % 26);
+    const auto num = std::to_string(k);
+    key.replace(0, std::min(len, num.size()), num, 0, std::min(len, num.size()));
+    return key;
+}
+
+static void test_string_map(int rounds)
+{
+    std::mt19937_64 rng(rounds);
+    for (int r = 0; r < rounds; r++) {
+        emhash8::StringMap<int> map;
+        std::unordered_map<std::string, int> ref;
+        const uint64_t range = 16 + rng() % 4000;
+        const size_t ops = 1 + rng() % 8000;
+
+        for (size_t i = 0; i < ops; i++) {
+            auto key = make_key(rng, range);
+            switch (rng() % 6) {
+            case 0: case 1:
+                assert(map.emplace(key, (int)i).second == ref.emplace(key, (int)i).second);
+                break;
+            case 2:
+                map[key] = (int)i;
+                ref[key] = (int)i;
+                break;
+            case 3:
+                map.insert_or_assign(key, (int)i);
+                ref.insert_or_assign(key, (int)i);
+                break;
+            default:
+                assert(map.erase(key) == ref.erase(key));
+                break;
+            }
+            //the map keeps its own copy of the key
+            key.assign(key.size(), '#');
+        }
+        check_views(map, ref);
+        assert(map.arena_bytes() >= live_bytes(map) + map.dead_bytes());
+
+        //a copy holds only the live keys in one block
+        const auto copy = map;
+        check_views(copy, ref);
+        assert(copy.dead_bytes() == 0 && copy.arena_bytes() == live_bytes(copy));
+
+        //erase most keys, shrink_to_fit must drop their bytes and keep the others findable
+        for (auto it = ref.begin(); it != ref.end(); ) {
+            if (rng() % 4) {
+                assert(map.erase(it->first) == 1);
+                it = ref.erase(it);
+            } else
+                ++it;
+        }
+        check_views(map, ref);
+        map.shrink_to_fit();
+        assert(map.dead_bytes() == 0 && map.arena_bytes() == live_bytes(map));
+        check_views(map, ref);
+
+        //the compacted arena must take new keys
+        for (size_t i = 0; i < ops / 4; i++) {
+            const auto key = make_key(rng, range * 2);
+            assert(map.emplace(key, -(int)i).second == ref.emplace(key, -(int)i).second);
+        }
+        check_views(map, ref);
+    }
+    printf("StringMap ok\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 100;
+    test_string_map(rounds);
+    return 0;
+}
@@ -0,0 +1,26 @@
+//shared by the unit tests registered in test/CMakeLists.txt, include it after #undef NDEBUG
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+
+//map holds exactly the pairs of the reference std::unordered_map, through iteration and lookups.
+//The reference is searched with its own key type, so a map of string_view keys checks against
+//a reference of strings
+template<class Map, class Ref>
+static void check_equal(const Map& map, const Ref& ref)
+{
+    assert(map.size() == ref.size());
+    size_t n = 0;
+    for (const auto& kv : map) {
+        auto it = ref.find(typename Ref::key_type(kv.first));
+        assert(it != ref.end() && it->second == kv.second);
+        n++;
+    }
+    assert(n == ref.size());
+    for (const auto& kv : ref) {
+        auto it = map.find(kv.first);
+        assert(it != map.end() && (*it).first == kv.first && (*it).second == kv.second);
+        assert(map.contains(kv.first) && map.count(kv.first) == 1);
+    }
+}